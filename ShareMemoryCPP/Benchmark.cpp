@@ -0,0 +1,743 @@
+/**
+ * @file Benchmark.cpp
+ * @brief 共享内存吞吐量与延迟基准测试的实现文件
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#include "Benchmark.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+
+namespace SharedMemory {
+
+namespace {
+
+    const char* const kConsumerSwitch = "--bench-consumer";
+
+    // How long a case may stall before it is reported as failed
+    const uint64_t kStallTimeoutNs = 10ull * 1000 * 1000 * 1000;
+
+    uint64_t NowNs()
+    {
+        // steady_clock is QueryPerformanceCounter on Windows and CLOCK_MONOTONIC on Linux,
+        // both consistent across processes
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    const char* FrameTypeName(FrameType type)
+    {
+        switch (type) {
+            case FrameType::IMAGE: return "Image";
+            case FrameType::POINTCLOUD: return "PointCloud";
+            case FrameType::HEIGHTMAP: return "HeightMap";
+            case FrameType::BUNDLE: return "Bundle";
+            case FrameType::DELTA: return "Delta";
+            case FrameType::COMPRESSED: return "Compressed";
+            case FrameType::POINTFIELDS: return "PointFields";
+        }
+        return "Unknown";
+    }
+
+    const char* BufferModeName(BufferMode mode)
+    {
+        switch (mode) {
+            case BufferMode::SingleSlot: return "SingleSlot";
+            case BufferMode::Ring: return "Ring";
+            case BufferMode::Broadcast: return "Broadcast";
+            case BufferMode::TripleBuffer: return "TripleBuffer";
+            case BufferMode::Pool: return "Pool";
+        }
+        return "Unknown";
+    }
+
+    const char* SyncModeName(SyncMode mode)
+    {
+        return mode == SyncMode::LockFree ? "LockFree" : "Mutex";
+    }
+
+    const char* ChecksumModeName(ChecksumMode mode)
+    {
+        switch (mode) {
+            case ChecksumMode::None: return "None";
+            case ChecksumMode::Legacy: return "Legacy";
+            case ChecksumMode::Crc32c: return "Crc32c";
+            case ChecksumMode::XxHash32: return "XxHash32";
+        }
+        return "Unknown";
+    }
+
+    const char* CopyModeName(CopyMode mode)
+    {
+        switch (mode) {
+            case CopyMode::Auto: return "Auto";
+            case CopyMode::Standard: return "Standard";
+            case CopyMode::Streaming: return "Streaming";
+        }
+        return "Unknown";
+    }
+
+    std::string FormatSize(size_t bytes)
+    {
+        std::stringstream ss;
+        if (bytes >= 1024 * 1024 && bytes % (1024 * 1024) == 0) {
+            ss << bytes / (1024 * 1024) << "MB";
+        }
+        else if (bytes >= 1024 && bytes % 1024 == 0) {
+            ss << bytes / 1024 << "KB";
+        }
+        else {
+            ss << bytes << "B";
+        }
+        return ss.str();
+    }
+
+    /**
+     * @brief 按帧类型生成测试数据并填写对应的 DataInfo 维度
+     */
+    void FillPayload(std::vector<uint8_t>& payload, FrameType type, DataInfo& info)
+    {
+        info = {};
+        info.dataType = static_cast<uint32_t>(type);
+
+        switch (type) {
+            case FrameType::IMAGE: {
+                // Single row RGB image, random bytes so the checksum sees real data
+                info.channels = 3;
+                info.width = static_cast<uint32_t>(payload.size() / 3);
+                info.height = 1;
+                uint32_t seed = 12345;
+                for (size_t i = 0; i < payload.size(); ++i) {
+                    seed = seed * 1103515245 + 12345;
+                    payload[i] = static_cast<uint8_t>(seed >> 16);
+                }
+                break;
+            }
+            case FrameType::POINTCLOUD: {
+                size_t points = payload.size() / (sizeof(float) * 3);
+                info.width = static_cast<uint32_t>(points);
+                info.height = 3;
+                float* xyz = reinterpret_cast<float*>(payload.data());
+                for (size_t i = 0; i < points * 3; ++i) {
+                    xyz[i] = static_cast<float>(std::sin(i * 0.001)) * 10.0f;
+                }
+                break;
+            }
+            case FrameType::HEIGHTMAP: {
+                size_t values = payload.size() / sizeof(float);
+                uint32_t width = static_cast<uint32_t>(std::sqrt(static_cast<double>(values)));
+                if (width == 0) {
+                    width = 1;
+                }
+                info.width = width;
+                info.height = static_cast<uint32_t>(values / width);
+                info.xSpacing = 0.1f;
+                info.ySpacing = 0.1f;
+                float* heights = reinterpret_cast<float*>(payload.data());
+                for (size_t i = 0; i < values; ++i) {
+                    heights[i] = 5.0f * static_cast<float>(std::sin((i % width) * 0.05));
+                }
+                break;
+            }
+            case FrameType::BUNDLE:
+            case FrameType::DELTA:
+            case FrameType::COMPRESSED:
+            case FrameType::POINTFIELDS:
+                // Bundles, deltas, compressed and structured frames are built by the manager, not swept as a payload type
+                break;
+        }
+    }
+
+    double PercentileUs(const std::vector<uint64_t>& sorted, double percentile)
+    {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        size_t rank = static_cast<size_t>(std::ceil(percentile * sorted.size()));
+        size_t index = rank > 0 ? rank - 1 : 0;
+        return sorted[std::min(index, sorted.size() - 1)] / 1000.0;
+    }
+
+    /**
+     * @brief 根据接收时间戳和延迟样本填写结果统计
+     */
+    void Summarize(BenchmarkResult& result, std::vector<uint64_t>& latencies,
+                   uint64_t startNs, uint64_t lastReceiveNs)
+    {
+        result.framesReceived = static_cast<uint32_t>(latencies.size());
+        result.success = result.framesReceived == result.testCase.frames;
+        result.seconds = lastReceiveNs > startNs ? (lastReceiveNs - startNs) / 1e9 : 0.0;
+        if (result.seconds > 0.0) {
+            result.framesPerSecond = result.framesReceived / result.seconds;
+            result.gbPerSecond = static_cast<double>(result.framesReceived)
+                               * result.testCase.payloadSize / result.seconds / 1e9;
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+        result.p50Us = PercentileUs(latencies, 0.50);
+        result.p99Us = PercentileUs(latencies, 0.99);
+        result.p999Us = PercentileUs(latencies, 0.999);
+        result.maxUs = latencies.empty() ? 0.0 : latencies.back() / 1000.0;
+    }
+
+    /**
+     * @brief 消费者一侧的延迟采集，只在监听线程中写入
+     */
+    struct LatencyCollector {
+        std::vector<uint64_t> latencies;
+        std::vector<uint8_t> decoded;   ///< 压缩帧在这里解压，计入延迟
+        std::atomic<uint32_t> received;
+        std::atomic<uint64_t> lastReceiveNs;
+
+        explicit LatencyCollector(uint32_t frames)
+            : received(0)
+            , lastReceiveNs(0)
+        {
+            latencies.reserve(frames);
+        }
+
+        void OnFrame(const FrameView& view)
+        {
+            if (view.IsCompressed()) {
+                decoded.resize(view.RawSize());
+                view.Decompress(decoded.data(), decoded.size());
+            }
+            uint64_t now = NowNs();
+            latencies.push_back(now - view.Info().timestamp);
+            lastReceiveNs.store(now, std::memory_order_relaxed);
+            received.fetch_add(1, std::memory_order_release);
+        }
+
+        /**
+         * @brief 等待收齐 frames 帧，连续 kStallTimeoutNs 没有新帧时放弃
+         */
+        void WaitFor(uint32_t frames) const
+        {
+            uint32_t last = 0;
+            uint64_t lastProgressNs = NowNs();
+            while (true) {
+                uint32_t count = received.load(std::memory_order_acquire);
+                if (count >= frames) {
+                    return;
+                }
+                if (count != last) {
+                    last = count;
+                    lastProgressNs = NowNs();
+                }
+                else if (NowNs() - lastProgressNs > kStallTimeoutNs) {
+                    return;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    };
+
+    bool ParseChecksumMode(const std::string& value, ChecksumMode& mode)
+    {
+        if (value == "none") { mode = ChecksumMode::None; return true; }
+        if (value == "legacy") { mode = ChecksumMode::Legacy; return true; }
+        if (value == "crc32c") { mode = ChecksumMode::Crc32c; return true; }
+        if (value == "xxhash") { mode = ChecksumMode::XxHash32; return true; }
+        return false;
+    }
+
+    bool ParseCodec(const std::string& value, CompressionCodec& codec)
+    {
+        if (value == "none") { codec = CompressionCodec::None; return true; }
+        if (value == "lz4") { codec = CompressionCodec::Lz4; return true; }
+        if (value == "shuffle-lz4") { codec = CompressionCodec::ShuffleLz4; return true; }
+        return false;
+    }
+
+    bool ParseCopyMode(const std::string& value, CopyMode& mode)
+    {
+        if (value == "auto") { mode = CopyMode::Auto; return true; }
+        if (value == "standard") { mode = CopyMode::Standard; return true; }
+        if (value == "streaming") { mode = CopyMode::Streaming; return true; }
+        return false;
+    }
+
+} // namespace
+
+Benchmark::Benchmark(const BenchmarkOptions& options)
+    : m_options(options)
+{
+}
+
+bool Benchmark::ParseArguments(int argc, char* argv[], BenchmarkOptions& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--frames" && hasValue) {
+            options.framesPerCase = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--memory-size" && hasValue) {
+            options.memorySize = static_cast<size_t>(std::stoull(argv[++i]));
+        }
+        else if (arg == "--slots" && hasValue) {
+            options.slotCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--checksum" && hasValue) {
+            if (!ParseChecksumMode(argv[++i], options.checksumMode)) {
+                return false;
+            }
+        }
+        else if (arg == "--copy" && hasValue) {
+            if (!ParseCopyMode(argv[++i], options.copyMode)) {
+                return false;
+            }
+        }
+        else if (arg == "--copy-threads" && hasValue) {
+            options.copyThreads = static_cast<uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--codec" && hasValue) {
+            if (!ParseCodec(argv[++i], options.codec)) {
+                return false;
+            }
+        }
+        else if (arg == "--prefault") {
+            options.prefault = true;
+        }
+        else if (arg == "--lock-pages") {
+            options.lockPages = true;
+        }
+        else if (arg == "--numa-node" && hasValue) {
+            options.numaNode = static_cast<int32_t>(std::stol(argv[++i]));
+        }
+        else if (arg == "--csv" && hasValue) {
+            options.csvPath = argv[++i];
+        }
+        else if (arg == "--json" && hasValue) {
+            options.jsonPath = argv[++i];
+        }
+        else if (arg == "--in-process") {
+            options.inProcess = true;
+            options.crossProcess = false;
+        }
+        else if (arg == "--cross-process") {
+            options.inProcess = false;
+            options.crossProcess = true;
+        }
+        else {
+            return false;
+        }
+    }
+    return options.framesPerCase > 0 && options.memorySize >= 1024;
+}
+
+void Benchmark::PrintUsage()
+{
+    std::cout << "Usage: ShareMemoryCPP [--demo] [options]\n"
+              << "  --demo                 Run the original producer/consumer demo\n"
+              << "  --demo --trace FILE    Run the demo and write per-stage timings as a Chrome trace\n"
+              << "  --frames N             Maximum frames per case (default 1000)\n"
+              << "  --memory-size BYTES    Largest payload and slot capacity (default 10MB)\n"
+              << "  --slots N              Slot count for ring and pool modes (default 4)\n"
+              << "  --checksum MODE        none | legacy | crc32c | xxhash (default crc32c)\n"
+              << "  --copy MODE            auto | standard | streaming (default auto)\n"
+              << "  --copy-threads N       Threads per frame copy, needs --checksum none (default 1)\n"
+              << "  --codec CODEC          none | lz4 | shuffle-lz4 for point clouds and height maps (default none)\n"
+              << "  --prefault             Touch every page of the mapping at initialization\n"
+              << "  --lock-pages           Lock the mapping in physical memory\n"
+              << "  --numa-node N          Place the mapping on NUMA node N\n"
+              << "  --in-process           Only run in-process cases\n"
+              << "  --cross-process        Only run cross-process cases\n"
+              << "  --csv PATH             Write results as CSV\n"
+              << "  --json PATH            Write results as JSON\n";
+}
+
+std::vector<BenchmarkCase> Benchmark::BuildCases() const
+{
+    // 1 KB, 4 KB, 16 KB, ... up to the full slot capacity
+    std::vector<size_t> sizes;
+    for (size_t size = 1024; size < m_options.memorySize; size *= 4) {
+        sizes.push_back(size);
+    }
+    sizes.push_back(m_options.memorySize);
+
+    const FrameType frameTypes[] = { FrameType::IMAGE, FrameType::POINTCLOUD, FrameType::HEIGHTMAP };
+    const BufferMode bufferModes[] = { BufferMode::SingleSlot, BufferMode::Ring, BufferMode::Pool };
+    const SyncMode syncModes[] = { SyncMode::Mutex, SyncMode::LockFree };
+
+    std::vector<bool> transports;
+    if (m_options.inProcess) {
+        transports.push_back(false);
+    }
+    if (m_options.crossProcess) {
+        transports.push_back(true);
+    }
+
+    std::vector<BenchmarkCase> cases;
+    for (bool crossProcess : transports) {
+        for (BufferMode bufferMode : bufferModes) {
+            for (SyncMode syncMode : syncModes) {
+                for (FrameType frameType : frameTypes) {
+                    for (size_t size : sizes) {
+                        BenchmarkCase testCase;
+                        testCase.payloadSize = size;
+                        testCase.frameType = frameType;
+                        testCase.bufferMode = bufferMode;
+                        testCase.syncMode = syncMode;
+                        testCase.crossProcess = crossProcess;
+
+                        // Large frames send fewer of them so every case takes a similar time
+                        uint64_t frames = m_options.maxBytesPerCase / size;
+                        frames = std::max<uint64_t>(frames, 50);
+                        testCase.frames = static_cast<uint32_t>(std::min<uint64_t>(frames, m_options.framesPerCase));
+                        cases.push_back(testCase);
+                    }
+                }
+            }
+        }
+    }
+    return cases;
+}
+
+ShareMemoryConfig Benchmark::MakeConfig(const BenchmarkCase& testCase) const
+{
+    ShareMemoryConfig config;
+    config.bufferMode = testCase.bufferMode;
+    config.syncMode = testCase.syncMode;
+    config.slotCount = m_options.slotCount;
+    config.checksumMode = m_options.checksumMode;
+    config.copyMode = m_options.copyMode;
+    config.copyThreads = m_options.copyThreads;
+    config.codec = m_options.codec;
+    config.prefault = m_options.prefault;
+    config.lockPages = m_options.lockPages;
+    config.numaNode = m_options.numaNode;
+
+    // Keep logging out of the measurement
+    config.logFilePath = "";
+    config.logLevel = LogLevel::Warning;
+    return config;
+}
+
+int Benchmark::Run()
+{
+    std::vector<BenchmarkCase> cases = BuildCases();
+    std::cout << "Running " << cases.size() << " benchmark cases, checksum "
+              << ChecksumModeName(m_options.checksumMode) << ", copy " << CopyModeName(m_options.copyMode)
+              << ", codec " << CodecName(m_options.codec)
+              << " (" << CpuFeatures::Get().StreamingIsa() << ")" << std::endl;
+    std::cout << std::left
+              << std::setw(8) << "Process" << std::setw(12) << "Buffer" << std::setw(10) << "Sync"
+              << std::setw(12) << "Type" << std::setw(8) << "Size" << std::right
+              << std::setw(8) << "Frames" << std::setw(10) << "GB/s" << std::setw(12) << "Frames/s"
+              << std::setw(10) << "p50(us)" << std::setw(10) << "p99(us)" << std::setw(11) << "p99.9(us)"
+              << std::endl;
+
+    bool allPassed = true;
+    for (const BenchmarkCase& testCase : cases) {
+        BenchmarkResult result;
+        result.testCase = testCase;
+
+        bool ran = testCase.crossProcess ? RunCrossProcess(testCase, result)
+                                         : RunInProcess(testCase, result);
+        if (!ran || !result.success) {
+            allPassed = false;
+        }
+        PrintResult(result);
+        m_results.push_back(result);
+    }
+
+    if (!m_options.csvPath.empty() && !WriteCsv(m_options.csvPath)) {
+        std::cerr << "Failed to write " << m_options.csvPath << std::endl;
+        allPassed = false;
+    }
+    if (!m_options.jsonPath.empty() && !WriteJson(m_options.jsonPath)) {
+        std::cerr << "Failed to write " << m_options.jsonPath << std::endl;
+        allPassed = false;
+    }
+    return allPassed ? 0 : 1;
+}
+
+bool Benchmark::ProduceFrames(ShareMemoryManager& producer, const BenchmarkCase& testCase,
+                              BenchmarkResult& result, uint64_t& startNs)
+{
+    std::vector<uint8_t> payload(testCase.payloadSize);
+    DataInfo info;
+    FillPayload(payload, testCase.frameType, info);
+
+    startNs = NowNs();
+    for (uint32_t frame = 0; frame < testCase.frames; ++frame) {
+        uint64_t firstAttemptNs = NowNs();
+        while (true) {
+            // Latency is measured from the attempt that succeeds, not from the first try
+            info.timestamp = NowNs();
+            if (producer.WriteData(payload.data(), payload.size(), info)) {
+                break;
+            }
+            ++result.writeRetries;
+            if (info.timestamp - firstAttemptNs > kStallTimeoutNs) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+    }
+    return true;
+}
+
+bool Benchmark::RunInProcess(const BenchmarkCase& testCase, BenchmarkResult& result)
+{
+    ShareMemoryConfig config = MakeConfig(testCase);
+    std::string name = "ShareMemoryBench_" + std::to_string(CurrentProcessId());
+
+    bool produced = false;
+    {
+        ShareMemoryManager consumer(name, m_options.memorySize, config);
+        ShareMemoryManager producer(name, m_options.memorySize, config);
+        if (!consumer.Initialize() || !producer.Initialize()) {
+            std::cerr << "Failed to initialize shared memory" << std::endl;
+        }
+        else {
+            LatencyCollector collector(testCase.frames);
+            consumer.SetDataReceivedCallback([&collector](const FrameView& view) {
+                collector.OnFrame(view);
+            });
+            consumer.StartMonitoring();
+
+            uint64_t startNs = 0;
+            produced = ProduceFrames(producer, testCase, result, startNs);
+            if (produced) {
+                collector.WaitFor(testCase.frames);
+            }
+            consumer.StopMonitoring();
+
+            Summarize(result, collector.latencies, startNs, collector.lastReceiveNs.load());
+        }
+    }
+    // Every case reuses the same name, the next one must not attach to this layout
+    ShareMemoryManager::RemoveNamedObjects(name);
+    return produced;
+}
+
+bool Benchmark::RunCrossProcess(const BenchmarkCase& testCase, BenchmarkResult& result)
+{
+    ShareMemoryConfig config = MakeConfig(testCase);
+    std::string name = "ShareMemoryBench_" + std::to_string(CurrentProcessId()) + "_x";
+    std::string outputPath = name + "_latency.bin";
+
+    // The child signals this once its consumer is initialized and monitoring
+    NamedEvent readyEvent;
+    if (!readyEvent.Open(name + "_ready")) {
+        std::cerr << "Failed to create ready event" << std::endl;
+        return false;
+    }
+
+    std::vector<std::string> args = {
+        kConsumerSwitch,
+        name,
+        std::to_string(m_options.memorySize),
+        std::to_string(static_cast<uint32_t>(testCase.bufferMode)),
+        std::to_string(static_cast<uint32_t>(testCase.syncMode)),
+        std::to_string(m_options.slotCount),
+        std::to_string(testCase.frames),
+        outputPath
+    };
+    ChildProcess child;
+    if (!child.Start(args)) {
+        std::cerr << "Failed to start consumer process" << std::endl;
+        readyEvent.Close();
+        RemoveSharedObject(name + "_ready");
+        return false;
+    }
+
+    bool produced = false;
+    uint64_t startNs = 0;
+    if (readyEvent.Wait(10000)) {
+        ShareMemoryManager producer(name, m_options.memorySize, config);
+        if (producer.Initialize()) {
+            produced = ProduceFrames(producer, testCase, result, startNs);
+        }
+        // The producer stays mapped until the child has drained every frame
+        child.Wait(30000);
+    }
+    else {
+        std::cerr << "Consumer process did not become ready" << std::endl;
+    }
+
+    if (!child.Wait(0)) {
+        child.Terminate();
+    }
+    readyEvent.Close();
+    RemoveSharedObject(name + "_ready");
+    ShareMemoryManager::RemoveNamedObjects(name);
+
+    // File layout: frame count, last receive time, then one latency sample per frame
+    std::vector<uint64_t> latencies;
+    uint64_t lastReceiveNs = 0;
+    std::ifstream input(outputPath, std::ios::binary);
+    if (input) {
+        uint64_t count = 0;
+        input.read(reinterpret_cast<char*>(&count), sizeof(count));
+        input.read(reinterpret_cast<char*>(&lastReceiveNs), sizeof(lastReceiveNs));
+        latencies.resize(static_cast<size_t>(count));
+        if (count > 0) {
+            input.read(reinterpret_cast<char*>(latencies.data()), count * sizeof(uint64_t));
+        }
+        input.close();
+        std::remove(outputPath.c_str());
+    }
+
+    Summarize(result, latencies, startNs, lastReceiveNs);
+    return produced && child.ExitCode() == 0;
+}
+
+int Benchmark::RunConsumerProcess(int argc, char* argv[])
+{
+    // <exe> --bench-consumer name memorySize bufferMode syncMode slotCount frames outputPath
+    if (argc != 9 || std::string(argv[1]) != kConsumerSwitch) {
+        return 2;
+    }
+
+    std::string name = argv[2];
+    size_t memorySize = static_cast<size_t>(std::stoull(argv[3]));
+    uint32_t frames = static_cast<uint32_t>(std::stoul(argv[7]));
+
+    ShareMemoryConfig config;
+    config.bufferMode = static_cast<BufferMode>(std::stoul(argv[4]));
+    config.syncMode = static_cast<SyncMode>(std::stoul(argv[5]));
+    config.slotCount = static_cast<uint32_t>(std::stoul(argv[6]));
+    config.logFilePath = "";
+    config.logLevel = LogLevel::Warning;
+
+    ShareMemoryManager consumer(name, memorySize, config);
+    if (!consumer.Initialize()) {
+        return 1;
+    }
+
+    LatencyCollector collector(frames);
+    consumer.SetDataReceivedCallback([&collector](const FrameView& view) {
+        collector.OnFrame(view);
+    });
+    consumer.StartMonitoring();
+
+    NamedEvent readyEvent;
+    if (!readyEvent.Open(name + "_ready")) {
+        consumer.StopMonitoring();
+        return 1;
+    }
+    readyEvent.Signal();
+    readyEvent.Close();
+
+    collector.WaitFor(frames);
+    consumer.StopMonitoring();
+
+    std::ofstream output(argv[8], std::ios::binary | std::ios::trunc);
+    if (!output) {
+        return 1;
+    }
+    uint64_t count = collector.latencies.size();
+    uint64_t lastReceiveNs = collector.lastReceiveNs.load();
+    output.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    output.write(reinterpret_cast<const char*>(&lastReceiveNs), sizeof(lastReceiveNs));
+    if (count > 0) {
+        output.write(reinterpret_cast<const char*>(collector.latencies.data()), count * sizeof(uint64_t));
+    }
+    return output.good() ? 0 : 1;
+}
+
+void Benchmark::PrintResult(const BenchmarkResult& result) const
+{
+    const BenchmarkCase& testCase = result.testCase;
+    std::cout << std::left
+              << std::setw(8) << (testCase.crossProcess ? "cross" : "in")
+              << std::setw(12) << BufferModeName(testCase.bufferMode)
+              << std::setw(10) << SyncModeName(testCase.syncMode)
+              << std::setw(12) << FrameTypeName(testCase.frameType)
+              << std::setw(8) << FormatSize(testCase.payloadSize) << std::right
+              << std::setw(8) << result.framesReceived
+              << std::fixed << std::setprecision(3)
+              << std::setw(10) << result.gbPerSecond
+              << std::setprecision(0)
+              << std::setw(12) << result.framesPerSecond
+              << std::setprecision(1)
+              << std::setw(10) << result.p50Us
+              << std::setw(10) << result.p99Us
+              << std::setw(11) << result.p999Us
+              << (result.success ? "" : "  FAILED")
+              << std::defaultfloat << std::endl;
+}
+
+bool Benchmark::WriteCsv(const std::string& path) const
+{
+    std::ofstream csv(path, std::ios::trunc);
+    if (!csv) {
+        return false;
+    }
+
+    csv << "process,buffer_mode,sync_mode,checksum,frame_type,payload_bytes,frames_sent,frames_received,"
+           "write_retries,seconds,gb_per_s,frames_per_s,p50_us,p99_us,p999_us,max_us,success\n";
+    for (const BenchmarkResult& result : m_results) {
+        const BenchmarkCase& testCase = result.testCase;
+        csv << (testCase.crossProcess ? "cross" : "in") << ","
+            << BufferModeName(testCase.bufferMode) << ","
+            << SyncModeName(testCase.syncMode) << ","
+            << ChecksumModeName(m_options.checksumMode) << ","
+            << FrameTypeName(testCase.frameType) << ","
+            << testCase.payloadSize << ","
+            << testCase.frames << ","
+            << result.framesReceived << ","
+            << result.writeRetries << ","
+            << result.seconds << ","
+            << result.gbPerSecond << ","
+            << result.framesPerSecond << ","
+            << result.p50Us << ","
+            << result.p99Us << ","
+            << result.p999Us << ","
+            << result.maxUs << ","
+            << (result.success ? 1 : 0) << "\n";
+    }
+    return csv.good();
+}
+
+bool Benchmark::WriteJson(const std::string& path) const
+{
+    std::ofstream json(path, std::ios::trunc);
+    if (!json) {
+        return false;
+    }
+
+    json << "{\n  \"checksum\": \"" << ChecksumModeName(m_options.checksumMode) << "\",\n"
+         << "  \"memorySize\": " << m_options.memorySize << ",\n"
+         << "  \"slotCount\": " << m_options.slotCount << ",\n"
+         << "  \"results\": [\n";
+    for (size_t i = 0; i < m_results.size(); ++i) {
+        const BenchmarkResult& result = m_results[i];
+        const BenchmarkCase& testCase = result.testCase;
+        json << "    {\"process\": \"" << (testCase.crossProcess ? "cross" : "in") << "\""
+             << ", \"bufferMode\": \"" << BufferModeName(testCase.bufferMode) << "\""
+             << ", \"syncMode\": \"" << SyncModeName(testCase.syncMode) << "\""
+             << ", \"frameType\": \"" << FrameTypeName(testCase.frameType) << "\""
+             << ", \"payloadBytes\": " << testCase.payloadSize
+             << ", \"framesSent\": " << testCase.frames
+             << ", \"framesReceived\": " << result.framesReceived
+             << ", \"writeRetries\": " << result.writeRetries
+             << ", \"seconds\": " << result.seconds
+             << ", \"gbPerSecond\": " << result.gbPerSecond
+             << ", \"framesPerSecond\": " << result.framesPerSecond
+             << ", \"p50Us\": " << result.p50Us
+             << ", \"p99Us\": " << result.p99Us
+             << ", \"p999Us\": " << result.p999Us
+             << ", \"maxUs\": " << result.maxUs
+             << ", \"success\": " << (result.success ? "true" : "false")
+             << "}" << (i + 1 < m_results.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n}\n";
+    return json.good();
+}
+
+} // namespace SharedMemory
@@ -0,0 +1,116 @@
+/**
+ * @file Benchmark.h
+ * @brief 共享内存吞吐量与延迟基准测试
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "ShareMemoryManager.h"
+
+namespace SharedMemory {
+
+    /**
+     * @brief 单个基准测试用例
+     */
+    struct BenchmarkCase {
+        size_t payloadSize = 0;                          ///< 每帧数据大小（字节）
+        FrameType frameType = FrameType::IMAGE;          ///< 帧数据类型
+        BufferMode bufferMode = BufferMode::SingleSlot;  ///< 缓冲区布局模式
+        SyncMode syncMode = SyncMode::Mutex;             ///< 读写同步方式
+        bool crossProcess = false;                       ///< 消费者是否运行在子进程中
+        uint32_t frames = 0;                             ///< 发送的帧数
+    };
+
+    /**
+     * @brief 基准测试结果，延迟为生产者写入 DataInfo::timestamp 到消费者回调之间的时间
+     */
+    struct BenchmarkResult {
+        BenchmarkCase testCase;
+        bool success = false;
+        uint32_t framesReceived = 0;   ///< 消费者实际收到的帧数
+        uint64_t writeRetries = 0;     ///< 因帧槽被占用而重试写入的次数
+        double seconds = 0.0;          ///< 第一帧写入到最后一帧被接收的时间
+        double gbPerSecond = 0.0;
+        double framesPerSecond = 0.0;
+        double p50Us = 0.0;
+        double p99Us = 0.0;
+        double p999Us = 0.0;
+        double maxUs = 0.0;
+    };
+
+    /**
+     * @brief 基准测试参数，由命令行解析得到
+     */
+    struct BenchmarkOptions {
+        size_t memorySize = 1024 * 1024 * 10;            ///< 单帧最大容量，也是扫描的最大数据大小
+        uint32_t framesPerCase = 1000;                   ///< 每个用例最多发送的帧数
+        uint64_t maxBytesPerCase = 2ull << 30;           ///< 每个用例最多传输的字节数，大帧时减少帧数
+        uint32_t slotCount = 4;                          ///< Ring模式的帧槽数量
+        ChecksumMode checksumMode = ChecksumMode::Crc32c;
+        CopyMode copyMode = CopyMode::Auto;
+        uint32_t copyThreads = 1;                        ///< 拷贝一帧最多使用的线程数
+        CompressionCodec codec = CompressionCodec::None; ///< 点云和高度图帧的压缩算法
+        bool prefault = false;                           ///< 初始化时预取映射的所有页
+        bool lockPages = false;                          ///< 把映射锁定在物理内存中
+        int32_t numaNode = -1;                           ///< 映射所在的NUMA节点，-1由系统决定
+        bool inProcess = true;                           ///< 运行进程内用例
+        bool crossProcess = true;                        ///< 运行跨进程用例
+        std::string csvPath;                             ///< CSV结果文件，为空时不输出
+        std::string jsonPath;                            ///< JSON结果文件，为空时不输出
+    };
+
+    /**
+     * @brief 基准测试入口：按参数扫描所有用例并输出结果
+     */
+    class Benchmark {
+    public:
+        explicit Benchmark(const BenchmarkOptions& options);
+
+        /**
+         * @brief 解析命令行参数
+         * @return 参数无效时返回 false
+         */
+        static bool ParseArguments(int argc, char* argv[], BenchmarkOptions& options);
+
+        static void PrintUsage();
+
+        /**
+         * @brief 运行全部用例，结果输出到控制台以及CSV/JSON文件
+         * @return 进程退出码
+         */
+        int Run();
+
+        /**
+         * @brief 跨进程用例中子进程的入口，参数由 Run 生成
+         * @return 进程退出码
+         */
+        static int RunConsumerProcess(int argc, char* argv[]);
+
+    private:
+        BenchmarkOptions m_options;
+        std::vector<BenchmarkResult> m_results;
+
+        std::vector<BenchmarkCase> BuildCases() const;
+        ShareMemoryConfig MakeConfig(const BenchmarkCase& testCase) const;
+        bool RunInProcess(const BenchmarkCase& testCase, BenchmarkResult& result);
+        bool RunCrossProcess(const BenchmarkCase& testCase, BenchmarkResult& result);
+
+        /**
+         * @brief 以最快速度写入所有帧，帧槽被占用时重试
+         * @param startNs 输出第一帧的写入时间
+         */
+        bool ProduceFrames(ShareMemoryManager& producer, const BenchmarkCase& testCase,
+                           BenchmarkResult& result, uint64_t& startNs);
+
+        void PrintResult(const BenchmarkResult& result) const;
+        bool WriteCsv(const std::string& path) const;
+        bool WriteJson(const std::string& path) const;
+    };
+
+} // namespace SharedMemory
@@ -0,0 +1,372 @@
+/**
+ * @file ChannelSegment.cpp
+ * @brief 多通道共享内存段的实现文件
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#include "ChannelSegment.h"
+#include "FrameTrace.h"
+#include <sstream>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+
+namespace SharedMemory {
+
+namespace {
+
+    size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+} // namespace
+
+ChannelSegment::ChannelSegment(const std::string& name, const std::vector<ChannelConfig>& channels,
+                               const ShareMemoryConfig& config)
+    : m_name(name)
+    , m_config(config)
+    , m_specs(channels)
+    , m_logger(AsyncLogger::Get(config.logFilePath, config.logToConsole))
+    , m_size(0)
+    , m_pBuffer(nullptr)
+    , m_pDirectory(nullptr)
+    , m_isMonitoring(false)
+{
+    // Layout: directory | channel 0 region | channel 1 region | ..., every region page aligned
+    size_t offset = AlignUp(sizeof(SegmentDirectory), kPayloadAlignment);
+    for (ChannelConfig& spec : m_specs) {
+        spec.config.role = config.role;
+        spec.config.logFilePath = config.logFilePath;
+        spec.config.logToConsole = config.logToConsole;
+        spec.config.logLevel = config.logLevel;
+        spec.config.largePages = false;
+
+        std::unique_ptr<ShareMemoryManager> channel(
+            new ShareMemoryManager(m_name + "." + spec.name, spec.size, spec.config));
+        m_offsets.push_back(offset);
+        offset += AlignUp(channel->m_size, kPayloadAlignment);
+        m_channels.push_back(std::move(channel));
+    }
+    m_size = offset;
+    m_callbacks.resize(m_channels.size());
+}
+
+ChannelSegment::~ChannelSegment()
+{
+    StopMonitoring();
+
+    // Channels live inside our view, they must go before it is unmapped
+    m_channels.clear();
+    m_mapping.Close();
+}
+
+bool ChannelSegment::Initialize()
+{
+    Log("Initializing channel segment " + m_name);
+
+    if (m_specs.empty() || m_specs.size() > kMaxChannels) {
+        SetError("A channel segment holds 1 to " + std::to_string(kMaxChannels) + " channels");
+        return false;
+    }
+    for (size_t i = 0; i < m_specs.size(); ++i) {
+        const std::string& channelName = m_specs[i].name;
+        if (channelName.empty() || channelName.size() >= kChannelNameLength) {
+            SetError("Invalid channel name: " + channelName);
+            return false;
+        }
+        for (size_t j = 0; j < i; ++j) {
+            if (m_specs[j].name == channelName) {
+                SetError("Duplicate channel name: " + channelName);
+                return false;
+            }
+        }
+    }
+
+    // One mutex and one new-frame event serve every channel in the segment
+    m_mutex = std::make_shared<NamedMutex>();
+    if (!m_mutex->Open(m_name + "_mutex")) {
+        SetError("Failed to create mutex");
+        return false;
+    }
+    m_event = std::make_shared<NamedEvent>();
+    if (!m_event->Open(m_name + "_event")) {
+        SetError("Failed to create event");
+        return false;
+    }
+
+    bool alreadyExists = true;
+    if (!MapSegment(alreadyExists)) {
+        return false;
+    }
+
+    if (m_mutex->Lock(m_config.lockTimeoutMs) == LockResult::Timeout) {
+        SetError("Timed out waiting for the segment mutex");
+        return false;
+    }
+
+    bool success = true;
+    bool initialized = alreadyExists && m_pDirectory->Magic != 0;
+    if (alreadyExists && !initialized && m_config.role == Role::Consumer) {
+        SetError("Channel segment has not been initialized by a producer");
+        success = false;
+    }
+    else if (initialized) {
+        success = CheckDirectory();
+    }
+
+    bool attach = initialized && m_config.role != Role::Producer;
+    if (success && !attach) {
+        WriteDirectory();
+    }
+    for (size_t i = 0; success && i < m_channels.size(); ++i) {
+        success = m_channels[i]->InitializeChannel(m_pBuffer + m_offsets[i], m_mutex, m_event, initialized);
+        if (!success) {
+            SetError("Failed to initialize channel " + m_specs[i].name + ": " + m_channels[i]->GetLastError());
+        }
+    }
+    if (success && !attach) {
+        // Magic last: a directory with a valid magic always describes initialized channels
+        std::atomic_thread_fence(std::memory_order_release);
+        m_pDirectory->Magic = kSegmentMagic;
+    }
+    m_mutex->Unlock();
+    if (!success) {
+        return false;
+    }
+
+    std::stringstream ss;
+    ss << (attach ? "Attached to channel segment " : "Channel segment initialized ") << m_name
+       << " - Channels: " << m_channels.size() << ", Mapping size: " << m_size << " bytes";
+    Log(ss.str());
+    return true;
+}
+
+bool ChannelSegment::MapSegment(bool& alreadyExists)
+{
+    // Channels carve the mapping at cache line granularity, large pages are not used here
+    MappingOptions options;
+    options.prefault = m_config.prefault;
+    options.lockPages = m_config.lockPages;
+    options.numaNode = m_config.numaNode;
+    bool mapped = m_config.role == Role::Consumer ? m_mapping.Open(m_name, options)
+                                                  : m_mapping.Create(m_name, m_size, options);
+    if (!mapped) {
+        SetError(m_config.role == Role::Consumer ? "Channel segment does not exist, start the producer first"
+                                                 : m_mapping.GetLastError());
+        return false;
+    }
+    alreadyExists = m_mapping.AlreadyExisted();
+    m_pBuffer = m_mapping.Data();
+    m_pDirectory = reinterpret_cast<SegmentDirectory*>(m_pBuffer);
+    return true;
+}
+
+bool ChannelSegment::CheckDirectory()
+{
+    const SegmentDirectory& directory = *m_pDirectory;
+    std::stringstream ss;
+    if (directory.Magic != kSegmentMagic) {
+        ss << "Shared memory " << m_name << " is not a channel segment";
+    }
+    else if (directory.Version != kSegmentVersion) {
+        ss << "Channel segment version " << directory.Version
+           << " does not match ours (" << kSegmentVersion << ")";
+    }
+    else if (directory.ChannelCount != m_channels.size() || directory.MappingSize < m_size) {
+        ss << "Channel segment was created with " << directory.ChannelCount
+           << " channels and " << directory.MappingSize << " bytes";
+    }
+    else {
+        for (size_t i = 0; i < m_channels.size(); ++i) {
+            const ChannelEntry& entry = directory.Channels[i];
+            const ShareMemoryManager& channel = *m_channels[i];
+            std::string entryName(entry.Name, strnlen(entry.Name, kChannelNameLength));
+            uint32_t slotCount = channel.m_config.bufferMode == BufferMode::SingleSlot ? 1 : channel.m_config.slotCount;
+            if (entryName != m_specs[i].name || entry.Offset != m_offsets[i] ||
+                entry.Size != channel.m_size ||
+                entry.SlotCapacity != channel.m_capacity ||
+                entry.BufferMode != static_cast<uint32_t>(channel.m_config.bufferMode) ||
+                entry.SlotCount != slotCount) {
+                ss << "Channel " << i << " was created as " << entryName
+                   << " - Mode: " << entry.BufferMode << ", Slots: " << entry.SlotCount
+                   << ", Slot size: " << entry.SlotCapacity << " bytes";
+                break;
+            }
+        }
+    }
+
+    if (ss.tellp() > 0) {
+        SetError(ss.str());
+        return false;
+    }
+    return true;
+}
+
+void ChannelSegment::WriteDirectory()
+{
+    // Magic stays 0 until every channel is initialized
+    memset(m_pDirectory, 0, sizeof(SegmentDirectory));
+    m_pDirectory->Version = kSegmentVersion;
+    m_pDirectory->ChannelCount = static_cast<uint32_t>(m_channels.size());
+    m_pDirectory->MappingSize = m_size;
+
+    for (size_t i = 0; i < m_channels.size(); ++i) {
+        ChannelEntry& entry = m_pDirectory->Channels[i];
+        const ShareMemoryManager& channel = *m_channels[i];
+        size_t length = m_specs[i].name.copy(entry.Name, kChannelNameLength - 1);
+        entry.Name[length] = '\0';
+        entry.Offset = m_offsets[i];
+        entry.Size = channel.m_size;
+        entry.SlotCapacity = channel.m_capacity;
+        entry.BufferMode = static_cast<uint32_t>(channel.m_config.bufferMode);
+        entry.SlotCount = channel.m_config.bufferMode == BufferMode::SingleSlot ? 1 : channel.m_config.slotCount;
+    }
+}
+
+ShareMemoryManager* ChannelSegment::GetChannel(const std::string& name)
+{
+    for (size_t i = 0; i < m_specs.size(); ++i) {
+        if (m_specs[i].name == name) {
+            return m_channels[i].get();
+        }
+    }
+    return nullptr;
+}
+
+ShareMemoryManager* ChannelSegment::GetChannel(size_t index)
+{
+    return index < m_channels.size() ? m_channels[index].get() : nullptr;
+}
+
+bool ChannelSegment::SetChannelCallback(const std::string& name, FrameReceivedCallback callback)
+{
+    for (size_t i = 0; i < m_specs.size(); ++i) {
+        if (m_specs[i].name == name) {
+            std::lock_guard<std::mutex> lock(m_callbackMutex);
+            m_callbacks[i] = callback;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ChannelSegment::StartMonitoring()
+{
+    if (!m_isMonitoring && m_pBuffer) {
+        m_isMonitoring = true;
+        m_monitorThread = std::thread(&ChannelSegment::MonitorThreadProc, this);
+    }
+}
+
+void ChannelSegment::StopMonitoring()
+{
+    if (m_isMonitoring) {
+        m_isMonitoring = false;
+        // Wake the monitor thread wherever it is blocked
+        if (m_event) {
+            m_event->Signal();
+        }
+        for (const std::unique_ptr<ShareMemoryManager>& channel : m_channels) {
+            if (channel->m_readerEvent.IsOpen()) {
+                channel->m_readerEvent.Signal();
+            }
+        }
+        if (m_monitorThread.joinable()) {
+            m_monitorThread.join();
+        }
+    }
+}
+
+void ChannelSegment::MonitorThreadProc()
+{
+    std::vector<size_t> active;
+    FrameView view;
+    FrameTrace::SetThreadName("ShareMemory segment monitor " + m_name);
+
+    while (m_isMonitoring) {
+        active.clear();
+        {
+            std::lock_guard<std::mutex> lock(m_callbackMutex);
+            for (size_t i = 0; i < m_callbacks.size(); ++i) {
+                if (m_callbacks[i]) {
+                    active.push_back(i);
+                }
+            }
+        }
+
+        // Take at most one ring's worth per channel per pass so a busy stream cannot starve the others
+        bool received = false;
+        for (size_t index : active) {
+            ShareMemoryManager& channel = *m_channels[index];
+            uint32_t budget = std::max<uint32_t>(channel.m_config.slotCount, 1);
+            for (uint32_t n = 0; n < budget && m_isMonitoring && channel.AcquireFrame(view); ++n) {
+                {
+                    std::lock_guard<std::mutex> lock(m_callbackMutex);
+                    TraceScope trace(TraceStage::Callback, channel.m_traceChannel);
+                    trace.SetFrame(view.FrameId());
+                    if (m_callbacks[index]) {
+                        m_callbacks[index](view);
+                    }
+                }
+                view.Release();
+                received = true;
+            }
+        }
+
+        if (!received) {
+            WaitForChannels(active);
+        }
+    }
+}
+
+void ChannelSegment::WaitForChannels(const std::vector<size_t>& channels)
+{
+    if (channels.empty()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(m_config.waitTimeoutMs));
+        return;
+    }
+
+    // Non-broadcast channels share the segment event, broadcast readers have their own
+    static_assert(kMaxChannels + 1 <= kMaxWaitAnyEvents, "every channel event must fit in one WaitAny");
+    NamedEvent* events[kMaxChannels + 1];
+    size_t eventCount = 0;
+    for (size_t index : channels) {
+        NamedEvent* frameEvent = m_channels[index]->BeginWait();
+        if (frameEvent && std::find(events, events + eventCount, frameEvent) == events + eventCount) {
+            events[eventCount++] = frameEvent;
+        }
+    }
+
+    // Recheck after registering as a waiter, see ShareMemoryManager::NotifyConsumer
+    bool pending = false;
+    for (size_t index : channels) {
+        pending = pending || m_channels[index]->HasPendingFrame();
+    }
+    if (!pending && m_isMonitoring && eventCount > 0) {
+        // One wait covers every channel, it is recorded under the first one
+        TraceScope trace(TraceStage::FrameWait, m_channels[channels.front()]->m_traceChannel);
+        NamedEvent::WaitAny(events, eventCount, m_config.waitTimeoutMs);
+    }
+
+    for (size_t index : channels) {
+        m_channels[index]->EndWait();
+    }
+}
+
+void ChannelSegment::Log(const std::string& message, LogLevel level)
+{
+    if (level < m_config.logLevel || !m_logger) {
+        return;
+    }
+    m_logger->Write(level, message);
+}
+
+void ChannelSegment::SetError(const std::string& message)
+{
+    m_lastError = message;
+    Log("ERROR: " + message, LogLevel::Error);
+}
+
+} // namespace SharedMemory
@@ -0,0 +1,156 @@
+/**
+ * @file ChannelSegment.h
+ * @brief 在一个共享内存映射中承载多个命名通道，共享映射、互斥锁、新帧事件和监听线程
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+
+#include "ShareMemoryManager.h"
+
+namespace SharedMemory {
+
+    const uint32_t kSegmentMagic = 0x4E484353;     ///< 'SCHN'
+    const uint32_t kSegmentVersion = 1;
+    const uint32_t kMaxChannels = 16;              ///< 单个段内的最大通道数
+    const size_t kChannelNameLength = 32;          ///< 通道名称缓冲区长度（含结尾的0）
+
+    /**
+     * @brief 段目录中的一项，描述一个通道在映射中的位置，恰好占一个缓存行
+     */
+    #pragma pack(push, 1)
+    struct ChannelEntry {
+        char Name[kChannelNameLength];  ///< 通道名称
+        uint64_t Offset;                ///< 通道区域相对映射起始处的偏移（页对齐）
+        uint64_t Size;                  ///< 通道区域大小
+        uint64_t SlotCapacity;          ///< 通道的单帧最大容量
+        uint32_t BufferMode;            ///< 通道的缓冲区模式（BufferMode）
+        uint32_t SlotCount;             ///< 通道的帧槽数量
+    };
+
+    /**
+     * @brief 段目录，位于映射起始处；每个通道区域内是一份完整的单通道布局
+     *        （SharedMemoryHeader、统计区、控制块、帧槽），由对应的 ShareMemoryManager 管理
+     */
+    struct SegmentDirectory {
+        uint32_t Magic;                 ///< kSegmentMagic，目录写完后最后写入
+        uint32_t Version;               ///< kSegmentVersion
+        uint32_t ChannelCount;          ///< 有效的通道数
+        uint32_t Reserved0;
+        uint64_t MappingSize;           ///< 映射总大小
+        uint8_t Reserved1[kCacheLineSize - 24];
+        ChannelEntry Channels[kMaxChannels];
+    };
+    #pragma pack(pop)
+
+    static_assert(sizeof(ChannelEntry) == kCacheLineSize, "each channel entry must own one cache line");
+    static_assert(sizeof(SegmentDirectory) % kCacheLineSize == 0, "the directory must end on a cache line");
+
+    /**
+     * @brief 段内一个通道的配置，生产者和消费者必须使用相同的通道列表
+     */
+    struct ChannelConfig {
+        std::string name;               ///< 通道名称，段内唯一，最长 kChannelNameLength - 1 个字符
+        size_t size = 0;                ///< 单帧最大容量（字节）
+        ShareMemoryConfig config;       ///< 通道的缓冲区配置，role 和日志设置沿用段的配置，largePages 无效
+    };
+
+    /**
+     * @brief 多通道共享内存段
+     *
+     * 所有通道共用一个文件映射、一个命名互斥锁 <name>_mutex 和一个新帧事件 <name>_event，
+     * 一个监听线程等待所有通道并按通道分发回调。每个通道通过 GetChannel 得到的
+     * ShareMemoryManager 读写，支持所有缓冲区模式以及零拷贝和类型化接口。
+     *
+     * @note 新帧事件为自动重置事件，每次只唤醒一个线程。同一个段的非广播通道应由
+     *       一个消费者线程读取；多个消费者进程请使用广播通道或各自独立的段。
+     */
+    class ChannelSegment {
+    public:
+        /**
+         * @param name 段名称，也是映射和同步对象的名称前缀
+         * @param channels 通道列表，最多 kMaxChannels 个
+         * @param config 段的配置，使用其中的 role、日志设置和 waitTimeoutMs
+         */
+        ChannelSegment(const std::string& name, const std::vector<ChannelConfig>& channels,
+                       const ShareMemoryConfig& config = ShareMemoryConfig());
+        ~ChannelSegment();
+
+        ChannelSegment(const ChannelSegment&) = delete;
+        ChannelSegment& operator=(const ChannelSegment&) = delete;
+
+        /**
+         * @brief 创建或打开段映射，初始化或校验目录，再初始化每个通道
+         */
+        bool Initialize();
+
+        size_t GetChannelCount() const { return m_channels.size(); }
+
+        /**
+         * @brief 按名称获取通道，不存在时返回 nullptr
+         */
+        ShareMemoryManager* GetChannel(const std::string& name);
+        ShareMemoryManager* GetChannel(size_t index);
+
+        /**
+         * @brief 设置通道的零拷贝接收回调，回调在段的监听线程上执行，视图在回调返回后释放
+         * @return 通道不存在时返回 false
+         */
+        bool SetChannelCallback(const std::string& name, FrameReceivedCallback callback);
+
+        /**
+         * @brief 启动一个监听线程，等待所有设置了回调的通道
+         */
+        void StartMonitoring();
+        void StopMonitoring();
+
+        std::string GetLastError() const { return m_lastError; }
+
+    private:
+        std::string m_name;
+        ShareMemoryConfig m_config;
+        std::vector<ChannelConfig> m_specs;
+        std::shared_ptr<AsyncLogger> m_logger;
+        std::vector<std::unique_ptr<ShareMemoryManager>> m_channels;
+        std::vector<size_t> m_offsets;          ///< 各通道区域的偏移
+        size_t m_size;                          ///< 映射总大小
+        SharedMapping m_mapping;
+        std::shared_ptr<NamedMutex> m_mutex;   ///< 所有通道共享的互斥锁
+        std::shared_ptr<NamedEvent> m_event;   ///< 所有非广播通道共享的新帧事件
+        uint8_t* m_pBuffer;
+        SegmentDirectory* m_pDirectory;
+        std::string m_lastError;
+
+        std::atomic<bool> m_isMonitoring;
+        std::thread m_monitorThread;
+        std::vector<FrameReceivedCallback> m_callbacks;
+        std::mutex m_callbackMutex;
+
+        bool MapSegment(bool& alreadyExists);
+
+        /**
+         * @brief 校验已存在的目录与本实例的通道列表一致
+         */
+        bool CheckDirectory();
+        void WriteDirectory();
+
+        void MonitorThreadProc();
+
+        /**
+         * @brief 在所有通道上登记为等待者并阻塞，直到任一通道有新帧或超时
+         */
+        void WaitForChannels(const std::vector<size_t>& channels);
+
+        void Log(const std::string& message, LogLevel level = LogLevel::Info);
+        void SetError(const std::string& message);
+    };
+
+} // namespace SharedMemory
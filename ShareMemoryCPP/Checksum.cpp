@@ -0,0 +1,305 @@
+/**
+ * @file Checksum.cpp
+ * @brief 帧数据完整性校验算法的实现
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#include "Checksum.h"
+#include <cstring>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SHM_X86 1
+#include <nmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SHM_TARGET_SSE42
+#else
+#include <cpuid.h>
+#define SHM_TARGET_SSE42 __attribute__((target("sse4.2")))
+#endif
+#endif
+
+namespace SharedMemory {
+
+namespace {
+
+    // Chunk size for CopyWithChecksum, small enough to stay in L2 between copy and hash
+    const size_t kCopyChunkSize = 64 * 1024;
+
+    // NTA prefetched source lines only live in L1, hash them before they are evicted
+    const size_t kStreamingChunkSize = 16 * 1024;
+
+    // CRC32C (Castagnoli), reflected polynomial
+    const uint32_t kCrc32cPoly = 0x82F63B78u;
+
+    // xxHash32 primes
+    const uint32_t kPrime1 = 2654435761u;
+    const uint32_t kPrime2 = 2246822519u;
+    const uint32_t kPrime3 = 3266489917u;
+    const uint32_t kPrime4 = 668265263u;
+    const uint32_t kPrime5 = 374761393u;
+
+    inline uint32_t RotateLeft(uint32_t value, int bits)
+    {
+        return (value << bits) | (value >> (32 - bits));
+    }
+
+    inline uint32_t Read32(const uint8_t* p)
+    {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline uint32_t XxRound(uint32_t acc, uint32_t input)
+    {
+        acc += input * kPrime2;
+        acc = RotateLeft(acc, 13);
+        return acc * kPrime1;
+    }
+
+    struct Crc32cTable {
+        uint32_t entries[256];
+
+        Crc32cTable()
+        {
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t crc = i;
+                for (int bit = 0; bit < 8; ++bit) {
+                    crc = (crc & 1) ? (crc >> 1) ^ kCrc32cPoly : crc >> 1;
+                }
+                entries[i] = crc;
+            }
+        }
+    };
+
+    uint32_t Crc32cSoftware(uint32_t crc, const uint8_t* data, size_t size)
+    {
+        static const Crc32cTable table;
+        for (size_t i = 0; i < size; ++i) {
+            crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc;
+    }
+
+#ifdef SHM_X86
+    bool DetectSse42()
+    {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 20)) != 0;
+#else
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            return false;
+        }
+        return (ecx & bit_SSE4_2) != 0;
+#endif
+    }
+
+    SHM_TARGET_SSE42 uint32_t Crc32cHardware(uint32_t crc, const uint8_t* data, size_t size)
+    {
+#if defined(_M_X64) || defined(__x86_64__)
+        uint64_t crc64 = crc;
+        while (size >= 8) {
+            uint64_t value;
+            memcpy(&value, data, sizeof(value));
+            crc64 = _mm_crc32_u64(crc64, value);
+            data += 8;
+            size -= 8;
+        }
+        crc = static_cast<uint32_t>(crc64);
+#endif
+        while (size >= 4) {
+            crc = _mm_crc32_u32(crc, Read32(data));
+            data += 4;
+            size -= 4;
+        }
+        while (size > 0) {
+            crc = _mm_crc32_u8(crc, *data);
+            ++data;
+            --size;
+        }
+        return crc;
+    }
+#endif
+
+    uint32_t Crc32cUpdate(uint32_t crc, const uint8_t* data, size_t size)
+    {
+#ifdef SHM_X86
+        static const bool hasSse42 = DetectSse42();
+        if (hasSse42) {
+            return Crc32cHardware(crc, data, size);
+        }
+#endif
+        return Crc32cSoftware(crc, data, size);
+    }
+
+} // namespace
+
+Checksum::Checksum(ChecksumMode mode)
+    : m_mode(mode)
+    , m_state(0)
+    , m_lanes{ kPrime1 + kPrime2, kPrime2, 0, 0u - kPrime1 }
+    , m_tail()
+    , m_tailSize(0)
+    , m_totalSize(0)
+{
+    if (m_mode == ChecksumMode::Crc32c) {
+        m_state = 0xFFFFFFFFu;
+    }
+}
+
+void Checksum::Update(const uint8_t* data, size_t size)
+{
+    switch (m_mode) {
+        case ChecksumMode::None:
+            break;
+
+        case ChecksumMode::Legacy: {
+            uint32_t checksum = m_state;
+            for (size_t i = 0; i < size; i++) {
+                checksum = ((checksum << 5) + checksum) + data[i];
+            }
+            m_state = checksum;
+            break;
+        }
+
+        case ChecksumMode::Crc32c:
+            m_state = Crc32cUpdate(m_state, data, size);
+            break;
+
+        case ChecksumMode::XxHash32: {
+            m_totalSize += size;
+
+            // Complete a partially filled stripe first
+            if (m_tailSize > 0) {
+                size_t fill = std::min(size, sizeof(m_tail) - m_tailSize);
+                memcpy(m_tail + m_tailSize, data, fill);
+                m_tailSize += fill;
+                data += fill;
+                size -= fill;
+                if (m_tailSize < sizeof(m_tail)) {
+                    break;
+                }
+                for (int lane = 0; lane < 4; ++lane) {
+                    m_lanes[lane] = XxRound(m_lanes[lane], Read32(m_tail + lane * 4));
+                }
+                m_tailSize = 0;
+            }
+
+            // Four independent lanes keep the multipliers busy in parallel
+            uint32_t v1 = m_lanes[0], v2 = m_lanes[1], v3 = m_lanes[2], v4 = m_lanes[3];
+            while (size >= 16) {
+                v1 = XxRound(v1, Read32(data));
+                v2 = XxRound(v2, Read32(data + 4));
+                v3 = XxRound(v3, Read32(data + 8));
+                v4 = XxRound(v4, Read32(data + 12));
+                data += 16;
+                size -= 16;
+            }
+            m_lanes[0] = v1; m_lanes[1] = v2; m_lanes[2] = v3; m_lanes[3] = v4;
+
+            if (size > 0) {
+                memcpy(m_tail, data, size);
+                m_tailSize = size;
+            }
+            break;
+        }
+    }
+}
+
+uint32_t Checksum::Finalize() const
+{
+    switch (m_mode) {
+        case ChecksumMode::None:
+            return 0;
+
+        case ChecksumMode::Legacy:
+            return m_state;
+
+        case ChecksumMode::Crc32c:
+            return m_state ^ 0xFFFFFFFFu;
+
+        case ChecksumMode::XxHash32: {
+            uint32_t hash;
+            if (m_totalSize >= 16) {
+                hash = RotateLeft(m_lanes[0], 1) + RotateLeft(m_lanes[1], 7)
+                     + RotateLeft(m_lanes[2], 12) + RotateLeft(m_lanes[3], 18);
+            }
+            else {
+                hash = kPrime5;
+            }
+            hash += static_cast<uint32_t>(m_totalSize);
+
+            const uint8_t* p = m_tail;
+            const uint8_t* end = m_tail + m_tailSize;
+            while (p + 4 <= end) {
+                hash += Read32(p) * kPrime3;
+                hash = RotateLeft(hash, 17) * kPrime4;
+                p += 4;
+            }
+            while (p < end) {
+                hash += (*p) * kPrime5;
+                hash = RotateLeft(hash, 11) * kPrime1;
+                ++p;
+            }
+
+            hash ^= hash >> 15;
+            hash *= kPrime2;
+            hash ^= hash >> 13;
+            hash *= kPrime3;
+            hash ^= hash >> 16;
+            return hash;
+        }
+    }
+    return 0;
+}
+
+uint32_t Checksum::Compute(ChecksumMode mode, const uint8_t* data, size_t size)
+{
+    if (mode == ChecksumMode::None) {
+        return 0;
+    }
+    Checksum checksum(mode);
+    checksum.Update(data, size);
+    return checksum.Finalize();
+}
+
+uint32_t CopyWithChecksum(uint8_t* dst, const uint8_t* src, size_t size, ChecksumMode mode,
+                          const CopyOptions& options)
+{
+    if (mode == ChecksumMode::None) {
+        CopyFrame(dst, src, size, options);
+        return 0;
+    }
+
+    Checksum checksum(mode);
+    CopyWithChecksum(dst, src, size, checksum, options);
+    return checksum.Finalize();
+}
+
+void CopyWithChecksum(uint8_t* dst, const uint8_t* src, size_t size, Checksum& checksum,
+                      const CopyOptions& options)
+{
+    bool streaming = UseStreamingCopy(size, options);
+    size_t chunkSize = streaming ? kStreamingChunkSize : kCopyChunkSize;
+    for (size_t offset = 0; offset < size; offset += chunkSize) {
+        size_t chunk = std::min(chunkSize, size - offset);
+        if (streaming) {
+            StreamingCopy(dst + offset, src + offset, chunk);
+        }
+        else {
+            memcpy(dst + offset, src + offset, chunk);
+        }
+        checksum.Update(src + offset, chunk);
+    }
+    if (streaming) {
+        StreamingFence();
+    }
+}
+
+} // namespace SharedMemory
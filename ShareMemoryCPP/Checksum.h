@@ -0,0 +1,67 @@
+/**
+ * @file Checksum.h
+ * @brief 帧数据完整性校验算法
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include "FrameCopy.h"
+
+namespace SharedMemory {
+
+    /**
+     * @brief 校验算法，记录在 SharedMemoryHeader::ChecksumType 中
+     */
+    enum class ChecksumMode : uint32_t {
+        None = 0,        ///< 不计算校验和
+        Legacy = 1,      ///< 旧版逐字节 hash * 33 + c 算法，兼容旧的消费者
+        Crc32c = 2,      ///< CRC32C，支持SSE4.2时使用硬件指令
+        XxHash32 = 3     ///< xxHash32，四路并行，适合没有硬件CRC的平台
+    };
+
+    /**
+     * @brief 增量校验和计算器，可以对数据分块调用 Update
+     */
+    class Checksum {
+    public:
+        explicit Checksum(ChecksumMode mode);
+
+        void Update(const uint8_t* data, size_t size);
+        uint32_t Finalize() const;
+
+        /**
+         * @brief 一次性计算整块数据的校验和
+         */
+        static uint32_t Compute(ChecksumMode mode, const uint8_t* data, size_t size);
+
+    private:
+        ChecksumMode m_mode;
+        uint32_t m_state;        ///< Legacy/Crc32c 的累加值
+        uint32_t m_lanes[4];     ///< xxHash32 的四路累加器
+        uint8_t m_tail[16];      ///< xxHash32 未凑满16字节的剩余数据
+        size_t m_tailSize;
+        uint64_t m_totalSize;
+    };
+
+    /**
+     * @brief 分块拷贝数据并在同一遍中计算校验和
+     *
+     * 每块拷贝后立即对仍在缓存中的源数据计算校验和，避免第二遍扫描整帧。
+     * 按 options 对大帧使用非临时存储；校验和必须按顺序计算，因此只有 mode 为 None 时才会多线程拷贝。
+     * @return 源数据的校验和
+     */
+    uint32_t CopyWithChecksum(uint8_t* dst, const uint8_t* src, size_t size, ChecksumMode mode,
+                              const CopyOptions& options = CopyOptions());
+
+    /**
+     * @brief 分块拷贝数据并累加到已有的校验和计算器，用于由多段数据拼接的帧
+     */
+    void CopyWithChecksum(uint8_t* dst, const uint8_t* src, size_t size, Checksum& checksum,
+                          const CopyOptions& options = CopyOptions());
+
+} // namespace SharedMemory
@@ -0,0 +1,419 @@
+/**
+ * @file FrameCodec.cpp
+ * @brief 帧数据压缩的实现
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#include "FrameCodec.h"
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace SharedMemory {
+
+namespace {
+
+    // Limits of the LZ4 block format
+    const size_t kMinMatch = 4;
+    const size_t kLastLiterals = 5;      // A block always ends with at least 5 literals
+    const size_t kMatchFindLimit = 12;   // No match starts within the last 12 bytes
+    const size_t kMaxOffset = 65535;
+    const size_t kMaxInputSize = 0x7E000000;
+
+    // Room the decoder needs past a copy to move whole 16 byte chunks
+    const size_t kWildCopySlack = 32;
+
+    const uint32_t kHashLog = 12;       // 16KB table, as the reference LZ4 fast mode: stays in L1
+    const uint32_t kSkipTrigger = 6;     // Probe further apart the longer nothing matches
+
+    uint32_t Read32(const uint8_t* p)
+    {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint64_t Read64(const uint8_t* p)
+    {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    uint32_t Hash(uint32_t sequence)
+    {
+        return (sequence * 2654435761u) >> (32 - kHashLog);
+    }
+
+    uint32_t CountTrailingZeros(uint64_t value)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return static_cast<uint32_t>(index);
+#else
+        return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+    }
+
+    // Little endian: the first differing byte is the lowest set byte of the xor
+    size_t MatchLength(const uint8_t* ip, const uint8_t* match, const uint8_t* limit)
+    {
+        const uint8_t* start = ip;
+        while (ip + sizeof(uint64_t) <= limit) {
+            uint64_t diff = Read64(ip) ^ Read64(match);
+            if (diff != 0) {
+                return static_cast<size_t>(ip - start) + CountTrailingZeros(diff) / 8;
+            }
+            ip += sizeof(uint64_t);
+            match += sizeof(uint64_t);
+        }
+        while (ip < limit && *ip == *match) {
+            ++ip;
+            ++match;
+        }
+        return static_cast<size_t>(ip - start);
+    }
+
+    uint8_t* WriteLength(uint8_t* op, size_t length)
+    {
+        while (length >= 255) {
+            *op++ = 255;
+            length -= 255;
+        }
+        *op++ = static_cast<uint8_t>(length);
+        return op;
+    }
+
+    bool ReadLength(const uint8_t*& ip, const uint8_t* end, size_t& length)
+    {
+        uint8_t byte;
+        do {
+            if (ip >= end || length > kMaxInputSize) {
+                return false;
+            }
+            byte = *ip++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    // Bytes a sequence with these lengths needs at most
+    size_t SequenceBound(size_t literals, size_t matchLength)
+    {
+        return 1 + literals / 255 + 1 + literals + 2 + matchLength / 255 + 1;
+    }
+
+    // Copies at least size bytes in 16 byte chunks, may write up to 15 bytes past dst + size
+    void WildCopy(uint8_t* dst, const uint8_t* src, size_t size)
+    {
+        uint8_t* const end = dst + size;
+        do {
+            memcpy(dst, src, 16);
+            dst += 16;
+            src += 16;
+        } while (dst < end);
+    }
+
+    std::vector<uint8_t>& Scratch()
+    {
+        thread_local std::vector<uint8_t> scratch;
+        return scratch;
+    }
+
+} // namespace
+
+const char* CodecName(CompressionCodec codec)
+{
+    switch (codec) {
+        case CompressionCodec::None: return "None";
+        case CompressionCodec::Lz4: return "LZ4";
+        case CompressionCodec::ShuffleLz4: return "Shuffle+LZ4";
+    }
+    return "Unknown";
+}
+
+size_t Lz4CompressBound(size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+size_t Lz4Compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity)
+{
+    if (size > kMaxInputSize) {
+        return 0;
+    }
+
+    thread_local std::vector<uint32_t> table;
+    table.assign(static_cast<size_t>(1) << kHashLog, 0);
+
+    const uint8_t* ip = src;
+    const uint8_t* anchor = src;
+    const uint8_t* const end = src + size;
+    uint8_t* op = dst;
+    uint8_t* const outEnd = dst + capacity;
+
+    if (size > kMatchFindLimit) {
+        const uint8_t* const matchLimit = end - kLastLiterals;
+        uint32_t searches = 1u << kSkipTrigger;
+        ++ip;
+
+        while (ip + kMatchFindLimit <= end) {
+            uint32_t sequence = Read32(ip);
+            uint32_t hash = Hash(sequence);
+            size_t position = static_cast<size_t>(ip - src);
+            size_t candidate = table[hash];
+            table[hash] = static_cast<uint32_t>(position);
+            if (candidate >= position || position - candidate > kMaxOffset || Read32(src + candidate) != sequence) {
+                ip += searches++ >> kSkipTrigger;
+                continue;
+            }
+
+            const uint8_t* match = src + candidate;
+            while (ip > anchor && match > src && ip[-1] == match[-1]) {
+                --ip;
+                --match;
+            }
+
+            size_t literals = static_cast<size_t>(ip - anchor);
+            size_t matchLength = kMinMatch + MatchLength(ip + kMinMatch, match + kMinMatch, matchLimit);
+            if (SequenceBound(literals, matchLength - kMinMatch) > static_cast<size_t>(outEnd - op)) {
+                return 0;
+            }
+
+            uint8_t* token = op++;
+            if (literals >= 15) {
+                *token = 15 << 4;
+                op = WriteLength(op, literals - 15);
+            }
+            else {
+                *token = static_cast<uint8_t>(literals << 4);
+            }
+            memcpy(op, anchor, literals);
+            op += literals;
+
+            size_t offset = static_cast<size_t>(ip - match);
+            *op++ = static_cast<uint8_t>(offset & 0xFF);
+            *op++ = static_cast<uint8_t>(offset >> 8);
+
+            size_t extra = matchLength - kMinMatch;
+            if (extra >= 15) {
+                *token |= 15;
+                op = WriteLength(op, extra - 15);
+            }
+            else {
+                *token |= static_cast<uint8_t>(extra);
+            }
+
+            ip += matchLength;
+            anchor = ip;
+            searches = 1u << kSkipTrigger;
+
+            // Remember a position inside the match, runs of the same value then chain cheaply
+            if (ip + kMatchFindLimit <= end) {
+                table[Hash(Read32(ip - 2))] = static_cast<uint32_t>(ip - 2 - src);
+            }
+        }
+    }
+
+    size_t literals = static_cast<size_t>(end - anchor);
+    if (SequenceBound(literals, 0) > static_cast<size_t>(outEnd - op)) {
+        return 0;
+    }
+    uint8_t* token = op++;
+    if (literals >= 15) {
+        *token = 15 << 4;
+        op = WriteLength(op, literals - 15);
+    }
+    else {
+        *token = static_cast<uint8_t>(literals << 4);
+    }
+    memcpy(op, anchor, literals);
+    op += literals;
+    return static_cast<size_t>(op - dst);
+}
+
+bool Lz4Decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t rawSize)
+{
+    const uint8_t* ip = src;
+    const uint8_t* const end = src + size;
+    uint8_t* op = dst;
+    uint8_t* const outEnd = dst + rawSize;
+
+    for (;;) {
+        if (ip >= end) {
+            return false;
+        }
+        uint8_t token = *ip++;
+
+        size_t literals = token >> 4;
+        if (literals == 15 && !ReadLength(ip, end, literals)) {
+            return false;
+        }
+        if (literals > static_cast<size_t>(end - ip) || literals > static_cast<size_t>(outEnd - op)) {
+            return false;
+        }
+        if (static_cast<size_t>(end - ip) >= literals + kWildCopySlack &&
+            static_cast<size_t>(outEnd - op) >= literals + kWildCopySlack) {
+            WildCopy(op, ip, literals);
+        }
+        else {
+            memcpy(op, ip, literals);
+        }
+        ip += literals;
+        op += literals;
+
+        // Only the last sequence has no match
+        if (ip == end) {
+            return op == outEnd;
+        }
+
+        if (end - ip < 2) {
+            return false;
+        }
+        size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst)) {
+            return false;
+        }
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !ReadLength(ip, end, matchLength)) {
+            return false;
+        }
+        matchLength += kMinMatch;
+        if (matchLength > static_cast<size_t>(outEnd - op)) {
+            return false;
+        }
+
+        const uint8_t* match = op - offset;
+        if (offset >= 16 && static_cast<size_t>(outEnd - op) >= matchLength + kWildCopySlack) {
+            WildCopy(op, match, matchLength);
+            op += matchLength;
+            continue;
+        }
+
+        // An overlapping match repeats the last offset bytes; copy the pattern in doubling chunks
+        size_t copied = 0;
+        while (copied < matchLength) {
+            size_t chunk = std::min(offset + copied, matchLength - copied);
+            memcpy(op + copied, match, chunk);
+            copied += chunk;
+        }
+        op += matchLength;
+    }
+}
+
+void ShuffleBytes(const uint8_t* src, size_t size, size_t elementSize, uint8_t* dst)
+{
+    size_t count = elementSize > 0 ? size / elementSize : 0;
+    if (count == 0) {
+        memcpy(dst, src, size);
+        return;
+    }
+
+    if (elementSize == sizeof(float)) {
+        uint8_t* planes[4] = { dst, dst + count, dst + 2 * count, dst + 3 * count };
+        for (size_t i = 0; i < count; ++i) {
+            const uint8_t* element = src + i * 4;
+            planes[0][i] = element[0];
+            planes[1][i] = element[1];
+            planes[2][i] = element[2];
+            planes[3][i] = element[3];
+        }
+    }
+    else {
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t b = 0; b < elementSize; ++b) {
+                dst[b * count + i] = src[i * elementSize + b];
+            }
+        }
+    }
+
+    size_t body = count * elementSize;
+    memcpy(dst + body, src + body, size - body);
+}
+
+void UnshuffleBytes(const uint8_t* src, size_t size, size_t elementSize, uint8_t* dst)
+{
+    size_t count = elementSize > 0 ? size / elementSize : 0;
+    if (count == 0) {
+        memcpy(dst, src, size);
+        return;
+    }
+
+    if (elementSize == sizeof(float)) {
+        const uint8_t* planes[4] = { src, src + count, src + 2 * count, src + 3 * count };
+        for (size_t i = 0; i < count; ++i) {
+            uint8_t* element = dst + i * 4;
+            element[0] = planes[0][i];
+            element[1] = planes[1][i];
+            element[2] = planes[2][i];
+            element[3] = planes[3][i];
+        }
+    }
+    else {
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t b = 0; b < elementSize; ++b) {
+                dst[i * elementSize + b] = src[b * count + i];
+            }
+        }
+    }
+
+    size_t body = count * elementSize;
+    memcpy(dst + body, src + body, size - body);
+}
+
+size_t CodecCompress(CompressionCodec codec, const uint8_t* src, size_t size, size_t elementSize,
+                     uint8_t* dst, size_t capacity)
+{
+    switch (codec) {
+        case CompressionCodec::None:
+            if (size > capacity) {
+                return 0;
+            }
+            memcpy(dst, src, size);
+            return size;
+        case CompressionCodec::Lz4:
+            return Lz4Compress(src, size, dst, capacity);
+        case CompressionCodec::ShuffleLz4: {
+            std::vector<uint8_t>& scratch = Scratch();
+            scratch.resize(size);
+            ShuffleBytes(src, size, elementSize, scratch.data());
+            return Lz4Compress(scratch.data(), size, dst, capacity);
+        }
+    }
+    return 0;
+}
+
+bool CodecDecompress(CompressionCodec codec, const uint8_t* src, size_t size, size_t elementSize,
+                     uint8_t* dst, size_t rawSize)
+{
+    switch (codec) {
+        case CompressionCodec::None:
+            if (size != rawSize) {
+                return false;
+            }
+            memcpy(dst, src, size);
+            return true;
+        case CompressionCodec::Lz4:
+            return Lz4Decompress(src, size, dst, rawSize);
+        case CompressionCodec::ShuffleLz4: {
+            std::vector<uint8_t>& scratch = Scratch();
+            scratch.resize(rawSize);
+            if (!Lz4Decompress(src, size, scratch.data(), rawSize)) {
+                return false;
+            }
+            UnshuffleBytes(scratch.data(), rawSize, elementSize, dst);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace SharedMemory
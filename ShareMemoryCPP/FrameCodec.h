@@ -0,0 +1,72 @@
+/**
+ * @file FrameCodec.h
+ * @brief 帧数据压缩：LZ4块格式，以及按字节平面重排后再压缩的浮点数据编码
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace SharedMemory {
+
+    /**
+     * @brief 压缩算法，记录在 SharedMemoryHeader::Codec 和每个压缩帧的 CompressedHeader 中
+     */
+    enum class CompressionCodec : uint32_t {
+        None = 0,        ///< 不压缩
+        Lz4 = 1,         ///< LZ4块格式，与标准 LZ4_decompress_safe 兼容
+        ShuffleLz4 = 2   ///< 先把每个元素的第k个字节排在一起（字节平面重排），再用LZ4压缩，适合浮点网格和点云
+    };
+
+    /**
+     * @brief 压缩算法的名称，用于日志
+     */
+    const char* CodecName(CompressionCodec codec);
+
+    /**
+     * @brief size 字节的数据经LZ4压缩后的最大长度
+     */
+    size_t Lz4CompressBound(size_t size);
+
+    /**
+     * @brief LZ4块压缩
+     * @return 压缩后的长度，超出 capacity 时返回0
+     * @note 单块输入不能超过 0x7E000000 字节
+     */
+    size_t Lz4Compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity);
+
+    /**
+     * @brief LZ4块解压，检查所有长度和偏移，不会越过 src 和 dst 的边界
+     * @return 数据合法且恰好解压出 rawSize 字节时返回 true
+     */
+    bool Lz4Decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t rawSize);
+
+    /**
+     * @brief 字节平面重排：dst 依次存放所有元素的第0个字节、第1个字节……，不足一个元素的尾部原样追加
+     */
+    void ShuffleBytes(const uint8_t* src, size_t size, size_t elementSize, uint8_t* dst);
+
+    /**
+     * @brief ShuffleBytes 的逆操作
+     */
+    void UnshuffleBytes(const uint8_t* src, size_t size, size_t elementSize, uint8_t* dst);
+
+    /**
+     * @brief 按 codec 压缩一帧数据，重排使用的临时缓冲区为每个线程各一份
+     * @param elementSize ShuffleLz4 的元素大小（字节），其他算法忽略
+     * @return 压缩后的长度，超出 capacity 时返回0
+     */
+    size_t CodecCompress(CompressionCodec codec, const uint8_t* src, size_t size, size_t elementSize,
+                         uint8_t* dst, size_t capacity);
+
+    /**
+     * @brief 按 codec 解压一帧数据到 dst（恰好 rawSize 字节）
+     * @return 数据合法时返回 true
+     */
+    bool CodecDecompress(CompressionCodec codec, const uint8_t* src, size_t size, size_t elementSize,
+                         uint8_t* dst, size_t rawSize);
+
+} // namespace SharedMemory
@@ -0,0 +1,331 @@
+/**
+ * @file FrameCopy.cpp
+ * @brief 帧数据拷贝引擎的实现
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#include "FrameCopy.h"
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SHM_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define SHM_TARGET_AVX2
+#define SHM_TARGET_AVX512
+#else
+#include <cpuid.h>
+#define SHM_TARGET_AVX2 __attribute__((target("avx2")))
+#define SHM_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+#endif
+
+namespace SharedMemory {
+
+namespace {
+
+    // Non-temporal stores work on whole cache lines
+    const size_t kLineSize = 64;
+
+    // How far ahead of the copy the source is prefetched
+    const size_t kPrefetchDistance = 16 * kLineSize;
+
+    // Below this a part is not worth handing to another thread
+    const size_t kMinPartSize = 1024 * 1024;
+
+    const uint32_t kMaxCopyThreads = 16;
+
+#ifdef SHM_X86
+    void CpuId(uint32_t leaf, uint32_t subleaf, uint32_t regs[4])
+    {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+        for (int i = 0; i < 4; ++i) {
+            regs[i] = static_cast<uint32_t>(info[i]);
+        }
+#else
+        if (!__get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2], &regs[3])) {
+            regs[0] = regs[1] = regs[2] = regs[3] = 0;
+        }
+#endif
+    }
+
+    uint64_t ReadXcr0()
+    {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        uint32_t eax, edx;
+        __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+    }
+
+    CpuFeatures DetectCpuFeatures()
+    {
+        CpuFeatures features = {};
+        uint32_t regs[4];
+        CpuId(0, 0, regs);
+        uint32_t maxLeaf = regs[0];
+
+        CpuId(1, 0, regs);
+        features.sse2 = (regs[3] & (1u << 26)) != 0;
+        bool osxsave = (regs[2] & (1u << 27)) != 0;
+        bool avx = (regs[2] & (1u << 28)) != 0;
+        if (!osxsave || !avx || maxLeaf < 7) {
+            return features;
+        }
+
+        // The OS must save the YMM (and for AVX-512 the opmask and ZMM) state on context switches
+        uint64_t xcr0 = ReadXcr0();
+        CpuId(7, 0, regs);
+        features.avx2 = (xcr0 & 0x06) == 0x06 && (regs[1] & (1u << 5)) != 0;
+        features.avx512 = (xcr0 & 0xE6) == 0xE6 && (regs[1] & (1u << 16)) != 0;
+        return features;
+    }
+
+    // Each routine copies whole lines to a line aligned destination
+
+    void StreamLinesSse2(uint8_t* dst, const uint8_t* src, size_t size)
+    {
+        for (size_t offset = 0; offset < size; offset += kLineSize) {
+            _mm_prefetch(reinterpret_cast<const char*>(src + offset + kPrefetchDistance), _MM_HINT_NTA);
+            const __m128i* in = reinterpret_cast<const __m128i*>(src + offset);
+            __m128i* out = reinterpret_cast<__m128i*>(dst + offset);
+            __m128i a = _mm_loadu_si128(in);
+            __m128i b = _mm_loadu_si128(in + 1);
+            __m128i c = _mm_loadu_si128(in + 2);
+            __m128i d = _mm_loadu_si128(in + 3);
+            _mm_stream_si128(out, a);
+            _mm_stream_si128(out + 1, b);
+            _mm_stream_si128(out + 2, c);
+            _mm_stream_si128(out + 3, d);
+        }
+    }
+
+    SHM_TARGET_AVX2 void StreamLinesAvx2(uint8_t* dst, const uint8_t* src, size_t size)
+    {
+        for (size_t offset = 0; offset < size; offset += kLineSize) {
+            _mm_prefetch(reinterpret_cast<const char*>(src + offset + kPrefetchDistance), _MM_HINT_NTA);
+            const __m256i* in = reinterpret_cast<const __m256i*>(src + offset);
+            __m256i* out = reinterpret_cast<__m256i*>(dst + offset);
+            __m256i a = _mm256_loadu_si256(in);
+            __m256i b = _mm256_loadu_si256(in + 1);
+            _mm256_stream_si256(out, a);
+            _mm256_stream_si256(out + 1, b);
+        }
+    }
+
+    SHM_TARGET_AVX512 void StreamLinesAvx512(uint8_t* dst, const uint8_t* src, size_t size)
+    {
+        for (size_t offset = 0; offset < size; offset += kLineSize) {
+            _mm_prefetch(reinterpret_cast<const char*>(src + offset + kPrefetchDistance), _MM_HINT_NTA);
+            __m512i line = _mm512_loadu_si512(src + offset);
+            _mm512_stream_si512(reinterpret_cast<__m512i*>(dst + offset), line);
+        }
+    }
+#endif
+
+    /**
+     * @brief 拷贝线程池，所有管理器共享，首次需要时启动
+     */
+    class CopyWorkers {
+    public:
+        static CopyWorkers& Get()
+        {
+            static CopyWorkers workers;
+            return workers;
+        }
+
+        ~CopyWorkers()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_jobReady.notify_all();
+            for (std::thread& worker : m_workers) {
+                worker.join();
+            }
+        }
+
+        /**
+         * @brief 在调用线程上执行 task(0)，其余 task(1..parts-1) 交给工作线程，全部完成后返回
+         */
+        void Run(uint32_t parts, const std::function<void(uint32_t)>& task)
+        {
+            Batch batch = { &task, parts - 1 };
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                while (m_workers.size() < parts - 1) {
+                    m_workers.emplace_back(&CopyWorkers::WorkerProc, this);
+                }
+                for (uint32_t i = 1; i < parts; ++i) {
+                    m_jobs.push_back(Job{ &batch, i });
+                }
+            }
+            m_jobReady.notify_all();
+
+            task(0);
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobDone.wait(lock, [&batch] { return batch.remaining == 0; });
+        }
+
+    private:
+        struct Batch {
+            const std::function<void(uint32_t)>* task;
+            uint32_t remaining;
+        };
+
+        struct Job {
+            Batch* batch;
+            uint32_t part;
+        };
+
+        std::vector<std::thread> m_workers;
+        std::deque<Job> m_jobs;
+        std::mutex m_mutex;
+        std::condition_variable m_jobReady;
+        std::condition_variable m_jobDone;
+        bool m_stopping = false;
+
+        CopyWorkers() = default;
+
+        void WorkerProc()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (;;) {
+                m_jobReady.wait(lock, [this] { return !m_jobs.empty() || m_stopping; });
+                if (m_jobs.empty()) {
+                    return;
+                }
+                Job job = m_jobs.front();
+                m_jobs.pop_front();
+
+                lock.unlock();
+                (*job.batch->task)(job.part);
+                lock.lock();
+
+                if (--job.batch->remaining == 0) {
+                    m_jobDone.notify_all();
+                }
+            }
+        }
+    };
+
+    void CopyRange(uint8_t* dst, const uint8_t* src, size_t size, bool streaming)
+    {
+        if (streaming) {
+            StreamingCopy(dst, src, size);
+            StreamingFence();
+        }
+        else {
+            memcpy(dst, src, size);
+        }
+    }
+
+} // namespace
+
+const CpuFeatures& CpuFeatures::Get()
+{
+#ifdef SHM_X86
+    static const CpuFeatures features = DetectCpuFeatures();
+#else
+    static const CpuFeatures features = {};
+#endif
+    return features;
+}
+
+const char* CpuFeatures::StreamingIsa() const
+{
+    if (avx512) {
+        return "AVX-512";
+    }
+    if (avx2) {
+        return "AVX2";
+    }
+    return sse2 ? "SSE2" : "memcpy";
+}
+
+bool UseStreamingCopy(size_t size, const CopyOptions& options)
+{
+    switch (options.mode) {
+        case CopyMode::Standard:
+            return false;
+        case CopyMode::Streaming:
+            return true;
+        default:
+            return size >= options.streamingThreshold;
+    }
+}
+
+void StreamingCopy(uint8_t* dst, const uint8_t* src, size_t size)
+{
+#ifdef SHM_X86
+    const CpuFeatures& features = CpuFeatures::Get();
+    if (!features.sse2) {
+        memcpy(dst, src, size);
+        return;
+    }
+
+    // Bring the destination to a line boundary, stream the whole lines, copy the rest normally
+    size_t head = std::min(size, (kLineSize - reinterpret_cast<uintptr_t>(dst) % kLineSize) % kLineSize);
+    memcpy(dst, src, head);
+    dst += head;
+    src += head;
+    size -= head;
+
+    size_t body = size & ~(kLineSize - 1);
+    if (features.avx512) {
+        StreamLinesAvx512(dst, src, body);
+    }
+    else if (features.avx2) {
+        StreamLinesAvx2(dst, src, body);
+    }
+    else {
+        StreamLinesSse2(dst, src, body);
+    }
+    memcpy(dst + body, src + body, size - body);
+#else
+    memcpy(dst, src, size);
+#endif
+}
+
+void StreamingFence()
+{
+#ifdef SHM_X86
+    _mm_sfence();
+#endif
+}
+
+void CopyFrame(uint8_t* dst, const uint8_t* src, size_t size, const CopyOptions& options)
+{
+    bool streaming = UseStreamingCopy(size, options);
+    uint32_t parts = static_cast<uint32_t>(std::min<size_t>(
+        std::min(options.threads, kMaxCopyThreads), size / kMinPartSize));
+    if (parts <= 1) {
+        CopyRange(dst, src, size, streaming);
+        return;
+    }
+
+    // Line sized parts: with a line aligned slot no two threads write the same cache line
+    size_t partSize = (size / parts + kLineSize - 1) & ~(kLineSize - 1);
+    CopyWorkers::Get().Run(parts, [=](uint32_t part) {
+        size_t offset = std::min(size, part * partSize);
+        size_t length = std::min(partSize, size - offset);
+        CopyRange(dst + offset, src + offset, length, streaming);
+    });
+}
+
+} // namespace SharedMemory
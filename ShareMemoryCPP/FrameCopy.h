@@ -0,0 +1,74 @@
+/**
+ * @file FrameCopy.h
+ * @brief 帧数据拷贝引擎：大帧使用非临时存储（绕过缓存）的SIMD拷贝，可拆分到多个线程
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace SharedMemory {
+
+    /**
+     * @brief 帧数据的拷贝方式
+     */
+    enum class CopyMode : uint32_t {
+        Auto = 0,        ///< 不小于 streamingThreshold 的帧使用非临时存储，其余使用 memcpy（默认）
+        Standard = 1,    ///< 始终使用 memcpy
+        Streaming = 2    ///< 始终使用非临时存储
+    };
+
+    /**
+     * @brief 拷贝参数，由 ShareMemoryConfig 的对应字段构造
+     */
+    struct CopyOptions {
+        CopyMode mode = CopyMode::Auto;
+        size_t streamingThreshold = 4 * 1024 * 1024;  ///< Auto模式下使用非临时存储的最小帧大小（字节）
+        uint32_t threads = 1;                         ///< 拷贝一帧最多使用的线程数，包括调用线程
+    };
+
+    /**
+     * @brief 启动时检测一次的CPU指令集支持，同时检查操作系统是否保存了对应的寄存器状态
+     */
+    struct CpuFeatures {
+        bool sse2;
+        bool avx2;
+        bool avx512;
+
+        static const CpuFeatures& Get();
+
+        /**
+         * @brief 非临时拷贝实际使用的指令集名称："AVX-512"、"AVX2"、"SSE2"，不支持时为 "memcpy"
+         */
+        const char* StreamingIsa() const;
+    };
+
+    /**
+     * @brief 按 options 决定 size 字节的帧是否使用非临时存储
+     */
+    bool UseStreamingCopy(size_t size, const CopyOptions& options);
+
+    /**
+     * @brief 非临时存储拷贝：目标写入绕过缓存，源数据提前以 NTA 预取，不污染调用线程的缓存
+     * @note 不包含存储屏障，最后一块拷贝完成后、发布帧之前必须调用 StreamingFence
+     */
+    void StreamingCopy(uint8_t* dst, const uint8_t* src, size_t size);
+
+    /**
+     * @brief 等待之前的非临时存储对其他处理器可见（x86 为 sfence）
+     *
+     * 非临时存储不遵守普通存储的顺序，release 语义的 Ready 状态本身不能保证帧数据先于它可见。
+     */
+    void StreamingFence();
+
+    /**
+     * @brief 拷贝一帧数据，按 options 选择 memcpy 或非临时存储，超大帧拆分到拷贝线程上并行执行
+     *
+     * 每个线程至少分到 1MB；返回时所有数据已经可见。
+     */
+    void CopyFrame(uint8_t* dst, const uint8_t* src, size_t size, const CopyOptions& options);
+
+} // namespace SharedMemory
@@ -0,0 +1,424 @@
+/**
+ * @file FrameRecording.cpp
+ * @brief 帧流录制和回放的实现
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#include "FrameRecording.h"
+#include "FrameCopy.h"
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace SharedMemory {
+
+namespace {
+
+    size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    uint64_t NowNs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /**
+     * @brief 等到 target，长于2毫秒的部分睡眠，最后一段自旋，避免系统定时器精度带来的毫秒级误差
+     */
+    void WaitUntil(std::chrono::steady_clock::time_point target)
+    {
+        const auto sleepThreshold = std::chrono::milliseconds(2);
+        for (;;) {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= target) {
+                return;
+            }
+            if (target - now > sleepThreshold) {
+                std::this_thread::sleep_for(target - now - std::chrono::milliseconds(1));
+            }
+            else {
+                CpuRelax();
+            }
+        }
+    }
+
+    // How often a replay retries a write the producer rejected
+    const auto kRetryInterval = std::chrono::microseconds(100);
+
+} // namespace
+
+FrameRecorder::FrameRecorder()
+    : m_open(false)
+    , m_chunkSize(0)
+    , m_window(nullptr)
+    , m_windowOffset(0)
+    , m_windowSize(0)
+    , m_end(0)
+{
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    Close();
+}
+
+bool FrameRecorder::Open(const std::string& path, size_t chunkSize)
+{
+    Close();
+    m_lastError.clear();
+    m_index.clear();
+
+    size_t granularity = MapGranularity();
+    m_chunkSize = AlignUp(std::max(chunkSize, granularity), granularity);
+    if (!m_file.Create(path)) {
+        m_lastError = m_file.GetLastError();
+        return false;
+    }
+
+    m_windowOffset = 0;
+    m_windowSize = m_chunkSize;
+    m_window = m_file.MapWindow(0, m_windowSize);
+    if (!m_window) {
+        m_lastError = m_file.GetLastError();
+        m_file.Close();
+        return false;
+    }
+
+    // No index yet: a recording cut short is recovered by scanning the records
+    RecordingHeader* header = reinterpret_cast<RecordingHeader*>(m_window);
+    memset(header, 0, sizeof(RecordingHeader));
+    header->Magic = kRecordingMagic;
+    header->Version = kRecordingVersion;
+    header->DataOffset = sizeof(RecordingHeader);
+    header->ChunkSize = m_chunkSize;
+    m_end = sizeof(RecordingHeader);
+    m_open = true;
+    return true;
+}
+
+size_t FrameRecorder::MapGranularity()
+{
+    // Chunks stay cache line multiples, so padding records always fit
+    return AlignUp(MappedFile::MapGranularity(), kCacheLineSize);
+}
+
+bool FrameRecorder::Reserve(size_t bytes)
+{
+    uint64_t windowEnd = m_windowOffset + m_windowSize;
+    if (m_end + bytes <= windowEnd) {
+        return true;
+    }
+
+    // Close the chunk with a padding record so a scan can step over the unused tail
+    size_t remaining = static_cast<size_t>(windowEnd - m_end);
+    if (remaining >= sizeof(RecordHeader)) {
+        RecordHeader* padding = reinterpret_cast<RecordHeader*>(m_window + (m_end - m_windowOffset));
+        memset(padding, 0, sizeof(RecordHeader));
+        padding->DataSize = remaining - sizeof(RecordHeader);
+        padding->Magic = kRecordPaddingMagic;
+    }
+
+    // A frame larger than a chunk gets a window of its own
+    m_windowOffset = windowEnd;
+    m_windowSize = std::max(m_chunkSize, AlignUp(bytes, MapGranularity()));
+    m_end = windowEnd;
+    m_window = m_file.MapWindow(m_windowOffset, m_windowSize);
+    if (!m_window) {
+        m_lastError = m_file.GetLastError();
+        return false;
+    }
+    return true;
+}
+
+bool FrameRecorder::Append(const FrameView& view)
+{
+    return view.IsValid() && Append(view.Data(), view.Size(), view.Info(), view.FrameId());
+}
+
+bool FrameRecorder::Append(const uint8_t* data, size_t size, const DataInfo& info, uint64_t frameId,
+                           uint64_t recordTimeNs)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_open || !m_window) {
+        m_lastError = "Recording is not open";
+        return false;
+    }
+    if (!data && size > 0) {
+        m_lastError = "Frame data is null";
+        return false;
+    }
+
+    size_t recordSize = AlignUp(sizeof(RecordHeader) + size, kCacheLineSize);
+    if (!Reserve(recordSize)) {
+        return false;
+    }
+
+    // Payload first, the magic last: a scan never sees a record whose data was not written
+    uint8_t* record = m_window + (m_end - m_windowOffset);
+    RecordHeader* header = reinterpret_cast<RecordHeader*>(record);
+    CopyFrame(record + sizeof(RecordHeader), data, size, CopyOptions());
+    memset(record + sizeof(RecordHeader) + size, 0, recordSize - sizeof(RecordHeader) - size);
+    header->Reserved0 = 0;
+    header->DataSize = size;
+    header->FrameId = frameId;
+    header->RecordTimeNs = recordTimeNs != 0 ? recordTimeNs : NowNs();
+    header->info = info;
+    header->Magic = kRecordFrameMagic;
+
+    RecordingIndexEntry entry;
+    entry.Offset = m_end;
+    entry.RecordTimeNs = header->RecordTimeNs;
+    m_index.push_back(entry);
+    m_end += recordSize;
+    return true;
+}
+
+bool FrameRecorder::Close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_open) {
+        return true;
+    }
+    m_open = false;
+
+    // Index after the last record, then the header, then drop the unused rest of the last chunk
+    uint64_t dataEnd = m_end;
+    size_t indexSize = sizeof(RecordingIndexEntry) * m_index.size();
+    bool success = m_window != nullptr && Reserve(AlignUp(indexSize, kCacheLineSize));
+    uint64_t indexOffset = m_end;
+    if (success && indexSize > 0) {
+        memcpy(m_window + (m_end - m_windowOffset), m_index.data(), indexSize);
+    }
+    m_file.UnmapWindow();
+    m_window = nullptr;
+
+    uint8_t* first = success ? m_file.MapWindow(0, MapGranularity()) : nullptr;
+    if (first) {
+        RecordingHeader* header = reinterpret_cast<RecordingHeader*>(first);
+        header->FrameCount = m_index.size();
+        header->DataEnd = dataEnd;
+        header->IndexOffset = indexOffset;
+        m_file.UnmapWindow();
+        success = m_file.Truncate(indexOffset + indexSize);
+    }
+    else {
+        success = false;
+    }
+    if (!success && m_lastError.empty()) {
+        m_lastError = m_file.GetLastError();
+    }
+
+    m_file.Close();
+    return success;
+}
+
+uint64_t FrameRecorder::FrameCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_index.size();
+}
+
+uint64_t FrameRecorder::BytesWritten() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_end;
+}
+
+FrameReplayer::FrameReplayer()
+    : m_framesFailed(0)
+    , m_lastRecordedId(0)
+    , m_lastReplayedId(0)
+{
+}
+
+bool FrameReplayer::Open(const std::string& path)
+{
+    Close();
+    if (!m_file.OpenReadOnly(path)) {
+        m_lastError = m_file.GetLastError();
+        return false;
+    }
+
+    const RecordingHeader* header = reinterpret_cast<const RecordingHeader*>(m_file.Data());
+    if (m_file.Size() < sizeof(RecordingHeader) || header->Magic != kRecordingMagic ||
+        header->Version != kRecordingVersion || header->DataOffset < sizeof(RecordingHeader) ||
+        header->DataOffset > m_file.Size()) {
+        m_lastError = path + " is not a frame recording";
+        Close();
+        return false;
+    }
+
+    if (!LoadIndex() && !ScanRecords()) {
+        m_lastError = path + " has no readable frames";
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void FrameReplayer::Close()
+{
+    m_file.Close();
+    m_index.clear();
+    m_framesFailed = 0;
+    m_lastRecordedId = 0;
+    m_lastReplayedId = 0;
+}
+
+bool FrameReplayer::LoadIndex()
+{
+    const RecordingHeader* header = reinterpret_cast<const RecordingHeader*>(m_file.Data());
+    uint64_t fileSize = m_file.Size();
+    if (header->IndexOffset == 0 || header->IndexOffset > fileSize ||
+        header->FrameCount > (fileSize - header->IndexOffset) / sizeof(RecordingIndexEntry)) {
+        return false;
+    }
+
+    std::vector<RecordingIndexEntry> index(static_cast<size_t>(header->FrameCount));
+    if (!index.empty()) {
+        memcpy(index.data(), m_file.Data() + header->IndexOffset, sizeof(RecordingIndexEntry) * index.size());
+    }
+    for (const RecordingIndexEntry& entry : index) {
+        const RecordHeader* record = reinterpret_cast<const RecordHeader*>(m_file.Data() + entry.Offset);
+        if (entry.Offset % kCacheLineSize != 0 || entry.Offset > fileSize - sizeof(RecordHeader) ||
+            record->Magic != kRecordFrameMagic ||
+            record->DataSize > fileSize - entry.Offset - sizeof(RecordHeader)) {
+            return false;
+        }
+    }
+    m_index.swap(index);
+    return true;
+}
+
+bool FrameReplayer::ScanRecords()
+{
+    const RecordingHeader* header = reinterpret_cast<const RecordingHeader*>(m_file.Data());
+    uint64_t fileSize = m_file.Size();
+    uint64_t offset = header->DataOffset;
+
+    // The unwritten rest of the last chunk reads as zeros and ends the scan
+    m_index.clear();
+    while (offset % kCacheLineSize == 0 && offset <= fileSize && fileSize - offset >= sizeof(RecordHeader)) {
+        const RecordHeader* record = reinterpret_cast<const RecordHeader*>(m_file.Data() + offset);
+        if ((record->Magic != kRecordFrameMagic && record->Magic != kRecordPaddingMagic) ||
+            record->DataSize > fileSize - offset - sizeof(RecordHeader)) {
+            break;
+        }
+        if (record->Magic == kRecordFrameMagic) {
+            RecordingIndexEntry entry;
+            entry.Offset = offset;
+            entry.RecordTimeNs = record->RecordTimeNs;
+            m_index.push_back(entry);
+        }
+        offset += AlignUp(sizeof(RecordHeader) + static_cast<size_t>(record->DataSize), kCacheLineSize);
+    }
+    return !m_index.empty();
+}
+
+uint64_t FrameReplayer::DurationNs() const
+{
+    if (m_index.size() < 2) {
+        return 0;
+    }
+    return m_index.back().RecordTimeNs - m_index.front().RecordTimeNs;
+}
+
+bool FrameReplayer::GetFrame(uint64_t index, RecordedFrame& frame) const
+{
+    if (index >= m_index.size()) {
+        return false;
+    }
+    const uint8_t* record = m_file.Data() + m_index[static_cast<size_t>(index)].Offset;
+    const RecordHeader* header = reinterpret_cast<const RecordHeader*>(record);
+    frame.data = record + sizeof(RecordHeader);
+    frame.size = static_cast<size_t>(header->DataSize);
+    frame.info = header->info;
+    frame.frameId = header->FrameId;
+    frame.recordTimeNs = header->RecordTimeNs;
+    return true;
+}
+
+bool FrameReplayer::ReplayFrame(ShareMemoryManager& producer, uint64_t index)
+{
+    RecordedFrame frame;
+    if (!GetFrame(index, frame)) {
+        return false;
+    }
+
+    bool success = false;
+    const DeltaHeader* delta = reinterpret_cast<const DeltaHeader*>(frame.data);
+    if (frame.info.dataType == static_cast<uint32_t>(FrameType::DELTA) && frame.size >= sizeof(DeltaHeader) &&
+        delta->Magic == kDeltaMagic) {
+        // The recorded base ID means nothing to this producer: point it at the frame replayed for it, if any
+        uint8_t* buffer = producer.BeginWrite(frame.size);
+        if (!buffer) {
+            return false;
+        }
+        CopyFrame(buffer, frame.data, frame.size, CopyOptions());
+        DeltaHeader* header = reinterpret_cast<DeltaHeader*>(buffer);
+        header->BaseFrameId = (m_lastRecordedId != 0 && delta->BaseFrameId == m_lastRecordedId) ? m_lastReplayedId : 0;
+        success = producer.CommitWrite(frame.info);
+        if (!success) {
+            producer.AbortWrite();
+        }
+    }
+    else {
+        // Straight from the mapped file into the slot
+        success = producer.WriteData(frame.data, frame.size, frame.info);
+    }
+
+    if (success) {
+        m_lastRecordedId = frame.frameId;
+        m_lastReplayedId = producer.GetLastFrameId();
+    }
+    return success;
+}
+
+uint64_t FrameReplayer::Replay(ShareMemoryManager& producer, const ReplayOptions& options,
+                               const std::atomic<bool>* running)
+{
+    uint64_t first = std::min<uint64_t>(options.firstFrame, m_index.size());
+    uint64_t last = options.frameCount == 0 ? m_index.size()
+                                            : std::min<uint64_t>(first + options.frameCount, m_index.size());
+    uint64_t written = 0;
+    m_framesFailed = 0;
+    if (first >= last) {
+        return 0;
+    }
+
+    // Recorded gaps are scaled from the first replayed frame
+    auto start = std::chrono::steady_clock::now();
+    uint64_t baseNs = m_index[static_cast<size_t>(first)].RecordTimeNs;
+    for (uint64_t i = first; i < last; ++i) {
+        if (running && !*running) {
+            break;
+        }
+        if (options.speed > 0.0) {
+            double offsetNs = static_cast<double>(m_index[static_cast<size_t>(i)].RecordTimeNs - baseNs) / options.speed;
+            WaitUntil(start + std::chrono::nanoseconds(static_cast<int64_t>(offsetNs)));
+        }
+
+        bool success = ReplayFrame(producer, i);
+        if (!success && options.retryTimeoutMs > 0) {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(options.retryTimeoutMs);
+            while (!success && std::chrono::steady_clock::now() < deadline && (!running || *running)) {
+                std::this_thread::sleep_for(kRetryInterval);
+                success = ReplayFrame(producer, i);
+            }
+        }
+        if (success) {
+            ++written;
+        }
+        else {
+            ++m_framesFailed;
+        }
+    }
+    return written;
+}
+
+} // namespace SharedMemory
@@ -0,0 +1,209 @@
+/**
+ * @file FrameRecording.h
+ * @brief 帧流的录制和回放：帧按原样追加到内存映射的分块文件，回放时直接从映射的文件写入共享内存
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+
+#include "ShareMemoryManager.h"
+
+namespace SharedMemory {
+
+    const uint32_t kRecordingMagic = 0x43455246;       ///< 'FREC'
+    const uint32_t kRecordingVersion = 1;
+    const uint32_t kRecordFrameMagic = 0x4D415246;     ///< 'FRAM'
+    const uint32_t kRecordPaddingMagic = 0x44415046;   ///< 'FPAD'，块末尾放不下下一帧的剩余空间
+    const size_t kDefaultRecordingChunkSize = 64 * 1024 * 1024;
+
+    /**
+     * @brief 录制文件格式：RecordingHeader | 帧记录 ... | RecordingIndexEntry x FrameCount
+     *
+     * 每条帧记录为 RecordHeader 加帧槽中存储的原始字节（压缩帧、捆绑帧和增量帧不做解析），按缓存行对齐。
+     * 文件按块扩大和映射，一条记录不会跨越块边界。录制正常结束时写入帧索引；
+     * 进程中途退出时 IndexOffset 为0，回放时按顺序扫描记录重建索引。
+     */
+    #pragma pack(push, 1)
+    struct RecordingHeader {
+        uint32_t Magic;                 ///< kRecordingMagic
+        uint32_t Version;               ///< kRecordingVersion
+        uint64_t FrameCount;            ///< 帧数，录制结束时写入
+        uint64_t DataOffset;            ///< 第一条记录的偏移
+        uint64_t DataEnd;               ///< 最后一条记录的结束位置，录制结束时写入
+        uint64_t IndexOffset;           ///< 帧索引的偏移，0表示没有索引
+        uint64_t ChunkSize;             ///< 录制时的块大小
+        uint8_t Reserved[kCacheLineSize - 48];
+    };
+
+    struct RecordHeader {
+        uint32_t Magic;                 ///< kRecordFrameMagic 或 kRecordPaddingMagic，最后写入
+        uint32_t Reserved0;
+        uint64_t DataSize;              ///< 紧跟在记录头之后的数据大小（字节）
+        uint64_t FrameId;               ///< 录制时的帧ID
+        uint64_t RecordTimeNs;          ///< 录制时刻（steady_clock纳秒），回放按它的间隔定时
+        DataInfo info;                  ///< 帧槽描述符中的数据信息
+    };
+
+    struct RecordingIndexEntry {
+        uint64_t Offset;                ///< 记录头相对文件起始处的偏移
+        uint64_t RecordTimeNs;          ///< 同 RecordHeader::RecordTimeNs，定时不需要访问记录本身
+    };
+    #pragma pack(pop)
+
+    static_assert(sizeof(RecordingHeader) == kCacheLineSize, "records must start on a cache line");
+    static_assert(sizeof(RecordHeader) == kCacheLineSize, "recorded payloads must start on a cache line");
+
+    /**
+     * @brief 录制消费者：把收到的帧追加到录制文件
+     *
+     * 帧数据从零拷贝视图直接拷贝到映射的文件块中，大帧使用非临时存储；
+     * 每写满一块就解除映射并发起写回，磁盘上看到的是按块大小的大块顺序写入。
+     * Append 可以在多个回调工作线程上同时调用，记录按获得内部锁的顺序排列。
+     */
+    class FrameRecorder {
+    public:
+        FrameRecorder();
+        ~FrameRecorder();
+
+        FrameRecorder(const FrameRecorder&) = delete;
+        FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+        /**
+         * @brief 创建录制文件，已存在的文件被覆盖
+         * @param chunkSize 每次扩大和映射文件的块大小，向上取整到映射粒度；大于块大小的帧单独占一块
+         */
+        bool Open(const std::string& path, size_t chunkSize = kDefaultRecordingChunkSize);
+
+        /**
+         * @brief 追加视图指向的一帧，可以直接在零拷贝回调中调用
+         */
+        bool Append(const FrameView& view);
+
+        /**
+         * @brief 追加一帧
+         * @param recordTimeNs 录制时刻，0表示使用当前的 steady_clock 时间
+         */
+        bool Append(const uint8_t* data, size_t size, const DataInfo& info, uint64_t frameId,
+                    uint64_t recordTimeNs = 0);
+
+        /**
+         * @brief 写入帧索引和文件头，截去最后一块未使用的部分
+         */
+        bool Close();
+
+        bool IsOpen() const { return m_open; }
+        uint64_t FrameCount() const;
+        uint64_t BytesWritten() const;
+        const std::string& GetLastError() const { return m_lastError; }
+
+    private:
+        MappedFile m_file;
+        mutable std::mutex m_mutex;  ///< 保护索引和写入位置，录制线程追加时其他线程也可以查询
+        bool m_open;
+        size_t m_chunkSize;
+        uint8_t* m_window;          ///< 当前映射的块
+        uint64_t m_windowOffset;    ///< 当前块相对文件起始处的偏移
+        size_t m_windowSize;
+        uint64_t m_end;             ///< 下一条记录的偏移
+        std::vector<RecordingIndexEntry> m_index;
+        std::string m_lastError;
+
+        /**
+         * @brief 保证当前块还能放下 bytes 字节，放不下时用填充记录结束当前块并映射下一块
+         */
+        bool Reserve(size_t bytes);
+
+        /**
+         * @brief 块大小和块偏移的对齐粒度：映射粒度向上取整到缓存行
+         */
+        static size_t MapGranularity();
+    };
+
+    /**
+     * @brief 录制文件中一帧的只读视图，直接指向映射的文件
+     */
+    struct RecordedFrame {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        DataInfo info = {};
+        uint64_t frameId = 0;
+        uint64_t recordTimeNs = 0;
+    };
+
+    /**
+     * @brief 回放参数
+     */
+    struct ReplayOptions {
+        double speed = 1.0;             ///< 回放速度倍率，1为录制时的间隔，2为两倍速，0表示不等待、尽快写入
+        uint32_t retryTimeoutMs = 0;    ///< 帧槽已满导致写入失败时重试的最长时间（毫秒），0表示不重试、计为失败
+        uint64_t firstFrame = 0;        ///< 从第几帧开始回放
+        uint64_t frameCount = 0;        ///< 回放的帧数，0表示到文件末尾
+    };
+
+    /**
+     * @brief 回放生产者：只读映射录制文件，按录制时的时间间隔把帧写入共享内存
+     *
+     * 帧数据从映射的文件直接拷贝到帧槽，不经过中间缓冲区。压缩帧、捆绑帧和结构化点云按存储的字节原样发布；
+     * 增量帧的基准帧ID被改写为回放时的帧ID，使用 PersistentFrame 的读者可以照常应用。
+     */
+    class FrameReplayer {
+    public:
+        FrameReplayer();
+
+        FrameReplayer(const FrameReplayer&) = delete;
+        FrameReplayer& operator=(const FrameReplayer&) = delete;
+
+        /**
+         * @brief 打开录制文件并读取帧索引，没有索引（录制进程中途退出）时扫描记录重建
+         */
+        bool Open(const std::string& path);
+        void Close();
+
+        uint64_t FrameCount() const { return m_index.size(); }
+
+        /**
+         * @brief 录制的总时长（纳秒），第一帧到最后一帧
+         */
+        uint64_t DurationNs() const;
+
+        /**
+         * @brief 第 index 帧的只读视图，有效期到 Close 为止
+         */
+        bool GetFrame(uint64_t index, RecordedFrame& frame) const;
+
+        /**
+         * @brief 把第 index 帧写入 producer，不等待
+         */
+        bool ReplayFrame(ShareMemoryManager& producer, uint64_t index);
+
+        /**
+         * @brief 按录制时的时间间隔回放
+         * @param running 不为空时，变为 false 后停止
+         * @return 成功写入的帧数，失败的帧数见 FramesFailed()
+         */
+        uint64_t Replay(ShareMemoryManager& producer, const ReplayOptions& options = ReplayOptions(),
+                        const std::atomic<bool>* running = nullptr);
+
+        uint64_t FramesFailed() const { return m_framesFailed; }
+        const std::string& GetLastError() const { return m_lastError; }
+
+    private:
+        MappedFile m_file;
+        std::vector<RecordingIndexEntry> m_index;
+        uint64_t m_framesFailed;
+        uint64_t m_lastRecordedId;  ///< 最近回放的帧的录制ID，增量帧据此判断基准帧是否被回放
+        uint64_t m_lastReplayedId;  ///< 该帧回放时得到的帧ID
+        std::string m_lastError;
+
+        bool LoadIndex();
+        bool ScanRecords();
+    };
+
+} // namespace SharedMemory
@@ -0,0 +1,353 @@
+/**
+ * @file FrameTrace.cpp
+ * @brief 延迟追踪的线程缓冲区、Chrome trace 导出和 ETW 提供者
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#ifdef _WIN32
+#define NOMINMAX  // 防止Windows.h定义min和max宏
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <TraceLoggingProvider.h>  // ETW，随 Windows 10 SDK 提供，只需 advapi32
+#endif
+
+#include "FrameTrace.h"
+#include "Platform.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+#ifdef _WIN32
+// {58AD8A57-CF27-4D30-83D8-D2EC2392C0F6}
+TRACELOGGING_DEFINE_PROVIDER(g_traceProvider, "ShareMemory",
+    (0x58ad8a57, 0xcf27, 0x4d30, 0x83, 0xd8, 0xd2, 0xec, 0x23, 0x92, 0xc0, 0xf6));
+#endif
+
+namespace SharedMemory {
+
+namespace {
+
+    const char* const kStageNames[] = {
+        "Write", "Read", "Acquire", "Lock", "SlotWait", "Copy", "Checksum", "Notify", "FrameWait", "Callback"
+    };
+    static_assert(sizeof(kStageNames) / sizeof(kStageNames[0]) == static_cast<size_t>(TraceStage::Count),
+                  "every stage needs a name");
+
+    struct TraceEvent {
+        uint64_t startNs;
+        uint64_t durationNs;
+        uint64_t frameId;
+        uint32_t stage;
+        uint32_t channel;
+    };
+
+    /**
+     * Single writer ring: only the owning thread stores events, the exporter copies
+     * them and drops whatever the writer may have overwritten in the meantime.
+     */
+    struct TraceBuffer {
+        std::unique_ptr<TraceEvent[]> events;
+        size_t mask;
+        std::atomic<uint64_t> head;
+        uint32_t threadId;
+        std::string threadName;
+
+        TraceBuffer(size_t capacity, uint32_t thread, const std::string& name)
+            : events(new TraceEvent[capacity]), mask(capacity - 1), head(0), threadId(thread), threadName(name)
+        {
+        }
+
+        void Push(const TraceEvent& event)
+        {
+            uint64_t position = head.load(std::memory_order_relaxed);
+            events[position & mask] = event;
+            head.store(position + 1, std::memory_order_release);
+        }
+
+        void Snapshot(std::vector<TraceEvent>& out) const
+        {
+            uint64_t capacity = mask + 1;
+            uint64_t end = head.load(std::memory_order_acquire);
+            uint64_t begin = end > capacity ? end - capacity : 0;
+            size_t first = out.size();
+            for (uint64_t i = begin; i < end; ++i) {
+                out.push_back(events[i & mask]);
+            }
+            // The writer may have been storing event 'now' into the slot of 'now - capacity'
+            uint64_t now = head.load(std::memory_order_acquire);
+            uint64_t valid = now >= capacity ? now - capacity + 1 : 0;
+            if (valid > begin) {
+                size_t skip = static_cast<size_t>(std::min(valid - begin, end - begin));
+                out.erase(out.begin() + first, out.begin() + first + skip);
+            }
+        }
+    };
+
+    struct TraceRegistry {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<TraceBuffer>> buffers;
+        std::map<uint32_t, std::string> channels;
+        size_t capacity = kDefaultTraceEventsPerThread;
+        std::atomic<uint32_t> generation{1};
+        uint32_t nextThreadId = 1;
+    };
+
+    TraceRegistry& Registry()
+    {
+        static TraceRegistry registry;
+        return registry;
+    }
+
+    thread_local std::shared_ptr<TraceBuffer> t_buffer;
+    thread_local uint32_t t_generation = 0;
+    thread_local uint32_t t_threadId = 0;
+    thread_local std::string t_threadName;
+
+    TraceBuffer* CurrentBuffer()
+    {
+        TraceRegistry& registry = Registry();
+        uint32_t generation = registry.generation.load(std::memory_order_acquire);
+        if (t_buffer && t_generation == generation) {
+            return t_buffer.get();
+        }
+
+        // First event of this thread since Start, the only time the registry lock is taken
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if (t_threadId == 0) {
+            t_threadId = registry.nextThreadId++;
+        }
+        t_buffer = std::make_shared<TraceBuffer>(registry.capacity, t_threadId, t_threadName);
+        t_generation = registry.generation.load(std::memory_order_relaxed);
+        registry.buffers.push_back(t_buffer);
+        return t_buffer.get();
+    }
+
+    uint32_t HashName(const std::string& name)
+    {
+        // FNV-1a, stable across processes so merged traces agree on channel IDs
+        uint32_t hash = 2166136261u;
+        for (char c : name) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    std::string JsonEscape(const std::string& text)
+    {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+                escaped += c;
+            }
+            else if (static_cast<uint8_t>(c) < 0x20) {
+                escaped += ' ';
+            }
+            else {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    // Chrome trace timestamps are microseconds, keep the nanoseconds as three decimals
+    void WriteMicros(std::ostream& out, uint64_t ns)
+    {
+        out << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000 << std::setfill(' ');
+    }
+
+    bool StartsFlow(TraceStage stage) { return stage == TraceStage::Write; }
+
+    bool StepsFlow(TraceStage stage) { return stage == TraceStage::Read || stage == TraceStage::Acquire; }
+
+} // namespace
+
+std::atomic<uint32_t> FrameTrace::s_sinks(0);
+
+#ifdef _WIN32
+// Registered at startup, an ETW session enabling or disabling the provider toggles kEtwSink
+struct TraceEtwProvider {
+    TraceEtwProvider() { TraceLoggingRegisterEx(g_traceProvider, &TraceEtwProvider::OnEnable, nullptr); }
+    ~TraceEtwProvider() { TraceLoggingUnregister(g_traceProvider); }
+
+    static void NTAPI OnEnable(LPCGUID, ULONG isEnabled, UCHAR, ULONGLONG, ULONGLONG,
+                               PEVENT_FILTER_DESCRIPTOR, PVOID)
+    {
+        if (isEnabled == EVENT_CONTROL_CODE_ENABLE_PROVIDER) {
+            FrameTrace::s_sinks.fetch_or(FrameTrace::kEtwSink, std::memory_order_relaxed);
+        }
+        else if (isEnabled == EVENT_CONTROL_CODE_DISABLE_PROVIDER) {
+            FrameTrace::s_sinks.fetch_and(~FrameTrace::kEtwSink, std::memory_order_relaxed);
+        }
+    }
+};
+
+static TraceEtwProvider g_traceEtwProvider;
+#endif
+
+void FrameTrace::Start(size_t eventsPerThread)
+{
+    size_t capacity = 1;
+    while (capacity < eventsPerThread) {
+        capacity <<= 1;
+    }
+
+    TraceRegistry& registry = Registry();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.buffers.clear();
+        registry.capacity = capacity;
+        // Every thread notices the new generation on its next event and allocates a fresh buffer
+        registry.generation.fetch_add(1, std::memory_order_release);
+    }
+    s_sinks.fetch_or(kBufferSink, std::memory_order_release);
+}
+
+void FrameTrace::Stop()
+{
+    s_sinks.fetch_and(~kBufferSink, std::memory_order_release);
+}
+
+void FrameTrace::Record(TraceStage stage, uint32_t channel, uint64_t frameId, uint64_t startNs, uint64_t durationNs)
+{
+    uint32_t sinks = s_sinks.load(std::memory_order_relaxed);
+    if (sinks & kBufferSink) {
+        TraceEvent event;
+        event.startNs = startNs;
+        event.durationNs = durationNs;
+        event.frameId = frameId;
+        event.stage = static_cast<uint32_t>(stage);
+        event.channel = channel;
+        CurrentBuffer()->Push(event);
+    }
+#ifdef _WIN32
+    if (sinks & kEtwSink) {
+        TraceLoggingWrite(g_traceProvider, "Stage",
+                          TraceLoggingString(StageName(stage), "Stage"),
+                          TraceLoggingUInt32(channel, "Channel"),
+                          TraceLoggingUInt64(frameId, "FrameId"),
+                          TraceLoggingUInt64(startNs, "StartNs"),
+                          TraceLoggingUInt64(durationNs, "DurationNs"));
+    }
+#endif
+}
+
+void FrameTrace::SetThreadName(const std::string& name)
+{
+    t_threadName = name;
+    if (t_buffer) {
+        std::lock_guard<std::mutex> lock(Registry().mutex);
+        t_buffer->threadName = name;
+    }
+}
+
+uint32_t FrameTrace::RegisterChannel(const std::string& name)
+{
+    uint32_t channel = HashName(name);
+    TraceRegistry& registry = Registry();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.channels[channel] = name;
+    }
+#ifdef _WIN32
+    // ETW consumers see only the ID on every event, name it once
+    if (s_sinks.load(std::memory_order_relaxed) & kEtwSink) {
+        TraceLoggingWrite(g_traceProvider, "Channel",
+                          TraceLoggingUInt32(channel, "Channel"),
+                          TraceLoggingString(name.c_str(), "Name"));
+    }
+#endif
+    return channel;
+}
+
+const char* FrameTrace::StageName(TraceStage stage)
+{
+    size_t index = static_cast<size_t>(stage);
+    return index < static_cast<size_t>(TraceStage::Count) ? kStageNames[index] : "Unknown";
+}
+
+bool FrameTrace::WriteChromeTrace(const std::string& path)
+{
+    struct ThreadEvents {
+        uint32_t threadId;
+        std::string threadName;
+        std::vector<TraceEvent> events;
+    };
+
+    std::vector<ThreadEvents> threads;
+    std::map<uint32_t, std::string> channels;
+    {
+        TraceRegistry& registry = Registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        channels = registry.channels;
+        for (const std::shared_ptr<TraceBuffer>& buffer : registry.buffers) {
+            ThreadEvents thread;
+            thread.threadId = buffer->threadId;
+            thread.threadName = buffer->threadName;
+            buffer->Snapshot(thread.events);
+            threads.push_back(std::move(thread));
+        }
+    }
+
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+
+    uint32_t processId = CurrentProcessId();
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << processId
+        << ",\"tid\":0,\"args\":{\"name\":\"ShareMemory " << processId << "\"}}";
+
+    for (const ThreadEvents& thread : threads) {
+        if (!thread.threadName.empty()) {
+            out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << processId << ",\"tid\":" << thread.threadId
+                << ",\"args\":{\"name\":\"" << JsonEscape(thread.threadName) << "\"}}";
+        }
+
+        for (const TraceEvent& event : thread.events) {
+            TraceStage stage = static_cast<TraceStage>(event.stage);
+            std::map<uint32_t, std::string>::const_iterator channel = channels.find(event.channel);
+            std::string category = channel != channels.end() ? JsonEscape(channel->second) : "shm";
+
+            out << ",\n{\"name\":\"" << StageName(stage) << "\",\"cat\":\"" << category
+                << "\",\"ph\":\"X\",\"ts\":";
+            WriteMicros(out, event.startNs);
+            out << ",\"dur\":";
+            WriteMicros(out, event.durationNs);
+            out << ",\"pid\":" << processId << ",\"tid\":" << thread.threadId;
+            if (event.frameId != 0) {
+                out << ",\"args\":{\"frame\":" << event.frameId << "}";
+            }
+            out << "}";
+
+            // Write -> Read/Acquire -> Callback of the same frame, also across merged process traces
+            bool flow = event.frameId != 0 &&
+                        (StartsFlow(stage) || StepsFlow(stage) || stage == TraceStage::Callback);
+            if (flow) {
+                const char* phase = StartsFlow(stage) ? "s" : (StepsFlow(stage) ? "t" : "f");
+                out << ",\n{\"name\":\"frame\",\"cat\":\"" << category << "\",\"ph\":\"" << phase
+                    << "\",\"id\":\"" << std::hex << event.channel << ':' << std::dec << event.frameId
+                    << "\",\"ts\":";
+                WriteMicros(out, event.startNs);
+                out << ",\"pid\":" << processId << ",\"tid\":" << thread.threadId;
+                if (!StartsFlow(stage)) {
+                    out << ",\"bp\":\"e\"";
+                }
+                out << "}";
+            }
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+} // namespace SharedMemory
@@ -0,0 +1,158 @@
+/**
+ * @file FrameTrace.h
+ * @brief 按阶段的延迟追踪：各线程把读写路径上每个阶段的起止时刻写入自己的无锁环形缓冲区，导出为 Chrome trace 或 ETW 事件
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#pragma once
+
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief 编译期开关，定义为 0 时 TraceScope 为空实现，读写路径上没有任何追踪代码
+ *
+ * 默认编译进来；运行时未启用时每个阶段只多一次原子读。
+ */
+#ifndef SHM_TRACE
+#define SHM_TRACE 1
+#endif
+
+namespace SharedMemory {
+
+    const size_t kDefaultTraceEventsPerThread = 64 * 1024;
+
+    /**
+     * @brief 被追踪的阶段
+     */
+    enum class TraceStage : uint32_t {
+        Write = 0,      ///< 一次写入调用（WriteData、WriteBundle、WriteDelta、WritePointCloud、CommitWrite）
+        Read = 1,       ///< 一次成功的 ReadData
+        Acquire = 2,    ///< 一次成功的 AcquireFrame
+        Lock = 3,       ///< 等待命名互斥锁
+        SlotWait = 4,   ///< 生产者等待帧槽释放（写入流控）
+        Copy = 5,       ///< 拷贝帧数据并计算校验和
+        Checksum = 6,   ///< 只计算校验和（零拷贝写入和读取）
+        Notify = 7,     ///< 触发新帧事件
+        FrameWait = 8,  ///< 监听线程自旋和阻塞等待新帧，结束时刻即被唤醒的时刻
+        Callback = 9,   ///< 执行用户回调
+        Count
+    };
+
+    /**
+     * @brief 追踪的全局开关、线程缓冲区和导出
+     *
+     * 时间戳取自 steady_clock（Windows 上为 QPC，Linux 上为 CLOCK_MONOTONIC），
+     * 与帧槽中的 PublishTimeNs 是同一个时钟，多个进程分别导出的文件可以直接合并查看。
+     * 每个线程第一次记录时分配自己的环形缓冲区，写入只有一次普通存储和一次 release 存储；
+     * 缓冲区写满后覆盖最早的事件。Windows 上 ETW 会话启用 ShareMemory 提供者时，
+     * 每个阶段同时写一条 ETW 事件，与环形缓冲区是否启用无关。
+     */
+    class FrameTrace {
+    public:
+        /**
+         * @brief 开始记录到线程缓冲区，之前记录的事件被丢弃
+         * @param eventsPerThread 每个线程保留的最近事件数，向上取整到2的幂
+         */
+        static void Start(size_t eventsPerThread = kDefaultTraceEventsPerThread);
+
+        /**
+         * @brief 停止记录到线程缓冲区，已记录的事件保留到下一次 Start，可以随后导出
+         */
+        static void Stop();
+
+        /**
+         * @brief 是否有任何追踪输出（线程缓冲区或 ETW 会话）在接收事件
+         */
+        static bool IsEnabled() { return s_sinks.load(std::memory_order_relaxed) != 0; }
+
+        /**
+         * @brief 把所有线程缓冲区中的事件写成 Chrome trace JSON，可在 chrome://tracing 或 Perfetto 中打开
+         *
+         * 每个阶段是一个完整事件，同一帧的写入、读取和回调之间用 flow 箭头连接。
+         * 记录期间也可以调用，正被覆盖的事件会被跳过。
+         */
+        static bool WriteChromeTrace(const std::string& path);
+
+        /**
+         * @brief 设置调用线程在导出文件中显示的名称
+         */
+        static void SetThreadName(const std::string& name);
+
+        /**
+         * @brief 登记共享内存名称，返回事件中使用的通道ID（名称的哈希）
+         */
+        static uint32_t RegisterChannel(const std::string& name);
+
+        static const char* StageName(TraceStage stage);
+
+        static uint64_t NowNs()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        /**
+         * @brief 记录一个已经结束的阶段，通常通过 TraceScope 调用
+         */
+        static void Record(TraceStage stage, uint32_t channel, uint64_t frameId, uint64_t startNs,
+                           uint64_t durationNs);
+
+    private:
+        friend struct TraceEtwProvider;
+
+        static const uint32_t kBufferSink = 0x1;
+        static const uint32_t kEtwSink = 0x2;
+
+        static std::atomic<uint32_t> s_sinks;
+    };
+
+#if SHM_TRACE
+    /**
+     * @brief 在作用域结束时记录一个阶段，追踪未启用时不读时钟
+     */
+    class TraceScope {
+    public:
+        /**
+         * @param frameOnly 为 true 时只有调用过 SetFrame 才记录，用于跳过没有取到帧的轮询
+         */
+        TraceScope(TraceStage stage, uint32_t channel, bool frameOnly = false)
+            : m_stage(stage)
+            , m_channel(channel)
+            , m_frameOnly(frameOnly)
+            , m_frameId(0)
+            , m_startNs(FrameTrace::IsEnabled() ? FrameTrace::NowNs() : 0)
+        {
+        }
+
+        ~TraceScope()
+        {
+            if (m_startNs != 0 && (m_frameId != 0 || !m_frameOnly)) {
+                FrameTrace::Record(m_stage, m_channel, m_frameId, m_startNs, FrameTrace::NowNs() - m_startNs);
+            }
+        }
+
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+
+        void SetFrame(uint64_t frameId) { m_frameId = frameId; }
+
+    private:
+        TraceStage m_stage;
+        uint32_t m_channel;
+        bool m_frameOnly;
+        uint64_t m_frameId;
+        uint64_t m_startNs;
+    };
+#else
+    class TraceScope {
+    public:
+        TraceScope(TraceStage, uint32_t, bool = false) {}
+        void SetFrame(uint64_t) {}
+    };
+#endif
+
+} // namespace SharedMemory
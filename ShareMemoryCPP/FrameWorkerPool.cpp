@@ -0,0 +1,134 @@
+/**
+ * @file FrameWorkerPool.cpp
+ * @brief 消费者回调工作线程池的实现文件
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#include "FrameWorkerPool.h"
+#include "FrameTrace.h"
+#include <chrono>
+
+namespace SharedMemory {
+
+FrameWorkerPool::FrameWorkerPool()
+    : m_inFlight(0)
+    , m_queueDepth(1)
+    , m_policy(OverflowPolicy::Block)
+    , m_stopping(false)
+{
+}
+
+FrameWorkerPool::~FrameWorkerPool()
+{
+    Stop();
+}
+
+void FrameWorkerPool::Start(uint32_t threadCount, uint32_t queueDepth, OverflowPolicy policy,
+                            const std::vector<uint32_t>& cpus, Handler handler)
+{
+    Stop();
+
+    m_queueDepth = queueDepth > 0 ? queueDepth : 1;
+    m_policy = policy;
+    m_handler = handler;
+    m_stopping = false;
+
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        int32_t cpu = cpus.empty() ? -1 : static_cast<int32_t>(cpus[i % cpus.size()]);
+        m_workers.emplace_back(&FrameWorkerPool::WorkerProc, this, cpu);
+    }
+}
+
+void FrameWorkerPool::Stop()
+{
+    if (m_workers.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_notEmpty.notify_all();
+    m_notFull.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    m_workers.clear();
+}
+
+uint32_t FrameWorkerPool::Submit(FrameView&& view)
+{
+    uint32_t dropped = 0;
+    FrameView evicted;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_queue.size() >= m_queueDepth) {
+            switch (m_policy) {
+                case OverflowPolicy::Block:
+                    m_notFull.wait(lock, [this] { return m_queue.size() < m_queueDepth || m_stopping; });
+                    break;
+                case OverflowPolicy::DropNewest:
+                    // The new view is released when it goes out of scope below
+                    evicted = std::move(view);
+                    return 1;
+                case OverflowPolicy::DropOldest:
+                    evicted = std::move(m_queue.front());
+                    m_queue.pop_front();
+                    m_inFlight.fetch_sub(1, std::memory_order_release);
+                    dropped = 1;
+                    break;
+            }
+        }
+        m_queue.push_back(std::move(view));
+        m_inFlight.fetch_add(1, std::memory_order_release);
+    }
+    m_notEmpty.notify_one();
+    return dropped;
+}
+
+void FrameWorkerPool::WaitIdle(uint32_t timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                    [this] { return m_inFlight.load(std::memory_order_acquire) == 0; });
+}
+
+void FrameWorkerPool::WorkerProc(int32_t cpu)
+{
+    if (cpu >= 0) {
+        PinCurrentThread(static_cast<uint32_t>(cpu));
+    }
+    FrameTrace::SetThreadName("ShareMemory callback worker");
+
+    for (;;) {
+        FrameView view;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notEmpty.wait(lock, [this] { return !m_queue.empty() || m_stopping; });
+            if (m_queue.empty()) {
+                return;  // Stopping and fully drained
+            }
+            view = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        m_notFull.notify_one();
+
+        m_handler(view);
+        view.Release();
+
+        if (m_inFlight.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_idle.notify_all();
+        }
+    }
+}
+
+} // namespace SharedMemory
@@ -0,0 +1,89 @@
+/**
+ * @file FrameWorkerPool.h
+ * @brief 消费者回调工作线程池，监听线程取得的帧视图经有界队列交给工作线程处理
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+
+#include "ShareMemoryManager.h"
+
+namespace SharedMemory {
+
+    /**
+     * @brief 帧视图工作线程池
+     *
+     * 队列中的视图仍然持有帧槽，被丢弃或处理完成后才归还给生产者，
+     * 因此队列容量加线程数应小于 Ring 模式的帧槽数，否则生产者会被阻塞。
+     */
+    class FrameWorkerPool {
+    public:
+        using Handler = std::function<void(const FrameView&)>;
+
+        FrameWorkerPool();
+        ~FrameWorkerPool();
+
+        FrameWorkerPool(const FrameWorkerPool&) = delete;
+        FrameWorkerPool& operator=(const FrameWorkerPool&) = delete;
+
+        /**
+         * @brief 启动工作线程
+         * @param threadCount 线程数，至少为1
+         * @param queueDepth 等待处理的最大视图数，至少为1
+         * @param policy 队列满时的处理策略
+         * @param cpus 线程i绑定到 cpus[i % cpus.size()] 号CPU，为空时不绑定
+         * @param handler 在工作线程上处理一个视图，返回后视图被释放
+         */
+        void Start(uint32_t threadCount, uint32_t queueDepth, OverflowPolicy policy,
+                   const std::vector<uint32_t>& cpus, Handler handler);
+
+        /**
+         * @brief 处理完队列中剩余的视图后停止所有工作线程
+         */
+        void Stop();
+
+        /**
+         * @brief 提交一个视图，按溢出策略处理队列已满的情况
+         * @return 被丢弃的视图数（DropNewest丢弃本视图，DropOldest丢弃队首视图）
+         */
+        uint32_t Submit(FrameView&& view);
+
+        /**
+         * @brief 排队中和处理中的视图数
+         */
+        uint32_t InFlight() const { return m_inFlight.load(std::memory_order_acquire); }
+
+        /**
+         * @brief 等待所有视图处理完成或超时
+         */
+        void WaitIdle(uint32_t timeoutMs);
+
+        bool IsRunning() const { return !m_workers.empty(); }
+
+    private:
+        std::vector<std::thread> m_workers;
+        std::deque<FrameView> m_queue;
+        std::mutex m_mutex;
+        std::condition_variable m_notEmpty;
+        std::condition_variable m_notFull;
+        std::condition_variable m_idle;
+        std::atomic<uint32_t> m_inFlight;
+        uint32_t m_queueDepth;
+        OverflowPolicy m_policy;
+        bool m_stopping;
+        Handler m_handler;
+
+        void WorkerProc(int32_t cpu);
+    };
+
+} // namespace SharedMemory
@@ -0,0 +1,205 @@
+/**
+ * @file Logger.cpp
+ * @brief 异步日志的实现
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#include "Logger.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <map>
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+
+namespace SharedMemory {
+
+namespace {
+
+    // How long the flush thread sleeps when nobody wakes it
+    const auto kFlushInterval = std::chrono::milliseconds(10);
+
+    std::string FormatTime(std::chrono::system_clock::time_point time)
+    {
+        auto time_c = std::chrono::system_clock::to_time_t(time);
+
+        // Use the thread safe variants instead of localtime
+        struct tm timeinfo;
+#ifdef _WIN32
+        localtime_s(&timeinfo, &time_c);
+#else
+        localtime_r(&time_c, &timeinfo);
+#endif
+
+        std::stringstream ss;
+        ss << std::put_time(&timeinfo, "%Y-%m-%d %H:%M:%S");
+        return ss.str();
+    }
+
+} // namespace
+
+std::shared_ptr<AsyncLogger> AsyncLogger::Get(const std::string& filePath, bool logToConsole)
+{
+    static std::mutex registryMutex;
+    static std::map<std::string, std::weak_ptr<AsyncLogger>> registry;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::shared_ptr<AsyncLogger> logger = registry[filePath].lock();
+    if (!logger) {
+        logger = std::make_shared<AsyncLogger>(filePath, logToConsole);
+        registry[filePath] = logger;
+    }
+    return logger;
+}
+
+AsyncLogger::AsyncLogger(const std::string& filePath, bool logToConsole)
+    : m_filePath(filePath)
+    , m_logToConsole(logToConsole)
+    , m_entries(new Entry[kQueueCapacity])
+    , m_enqueuePos(0)
+    , m_dequeuePos(0)
+    , m_lastSecond(0)
+    , m_dropped(0)
+    , m_running(true)
+{
+    static_assert((kQueueCapacity & (kQueueCapacity - 1)) == 0, "queue capacity must be a power of two");
+    for (size_t i = 0; i < kQueueCapacity; ++i) {
+        m_entries[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_flushThread = std::thread(&AsyncLogger::FlushThreadProc, this);
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    m_running = false;
+    m_wakeCondition.notify_one();
+    if (m_flushThread.joinable()) {
+        m_flushThread.join();
+    }
+}
+
+bool AsyncLogger::Write(LogLevel level, const std::string& message)
+{
+    // Bounded MPMC queue (Vyukov): claim a cell by advancing the enqueue position
+    Entry* entry = nullptr;
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        entry = &m_entries[pos & (kQueueCapacity - 1)];
+        size_t sequence = entry->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // Queue full: never block the caller
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    entry->time = std::chrono::system_clock::now();
+    entry->length = static_cast<uint32_t>(std::min(message.size(), kMaxMessageLength));
+    memcpy(entry->text, message.data(), entry->length);
+    entry->sequence.store(pos + 1, std::memory_order_release);
+
+    // Errors should reach the file promptly, and bursts should not wait for the timer
+    if (level >= LogLevel::Error || (pos & (kQueueCapacity / 2 - 1)) == 0) {
+        m_wakeCondition.notify_one();
+    }
+    return true;
+}
+
+void AsyncLogger::Flush()
+{
+    m_wakeCondition.notify_one();
+}
+
+bool AsyncLogger::TryPop(std::string& line)
+{
+    Entry& entry = m_entries[m_dequeuePos & (kQueueCapacity - 1)];
+    size_t sequence = entry.sequence.load(std::memory_order_acquire);
+    if (sequence != m_dequeuePos + 1) {
+        return false;
+    }
+
+    // Timestamps have one second resolution, so only reformat when the second changes
+    std::time_t second = std::chrono::system_clock::to_time_t(entry.time);
+    if (second != m_lastSecond) {
+        m_lastSecond = second;
+        m_lastTimeText = FormatTime(entry.time);
+    }
+
+    // Format log message
+    line = m_lastTimeText + " [Producer] ";
+    line.append(entry.text, entry.length);
+
+    entry.sequence.store(m_dequeuePos + kQueueCapacity, std::memory_order_release);
+    ++m_dequeuePos;
+    return true;
+}
+
+void AsyncLogger::FlushThreadProc()
+{
+    std::ofstream logFile;
+    if (!m_filePath.empty()) {
+        logFile.open(m_filePath, std::ios::app);
+    }
+
+    std::string line;
+    uint64_t reportedDrops = 0;
+    bool running = true;
+
+    while (running) {
+        {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wakeCondition.wait_for(lock, kFlushInterval);
+        }
+        // Drain once more after a stop request so nothing queued is lost
+        running = m_running;
+
+        bool wrote = false;
+        while (TryPop(line)) {
+            if (m_logToConsole) {
+                std::cout << line << '\n';
+            }
+            if (logFile.is_open()) {
+                logFile << line << '\n';
+            }
+            wrote = true;
+        }
+
+        uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+        if (dropped != reportedDrops) {
+            std::stringstream ss;
+            ss << FormatTime(std::chrono::system_clock::now()) << " [Producer] WARNING: "
+               << (dropped - reportedDrops) << " log messages dropped, queue full";
+            if (m_logToConsole) {
+                std::cout << ss.str() << '\n';
+            }
+            if (logFile.is_open()) {
+                logFile << ss.str() << '\n';
+            }
+            reportedDrops = dropped;
+            wrote = true;
+        }
+
+        if (wrote) {
+            if (m_logToConsole) {
+                std::cout.flush();
+            }
+            if (logFile.is_open()) {
+                logFile.flush();
+            }
+        }
+    }
+}
+
+} // namespace SharedMemory
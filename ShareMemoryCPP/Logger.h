@@ -0,0 +1,112 @@
+/**
+ * @file Logger.h
+ * @brief 异步日志：无锁内存队列 + 后台刷新线程，文件I/O不再占用数据路径
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#pragma once
+
+#include <string>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+
+/**
+ * @brief 编译期最低日志级别（LogLevel 的数值），低于该级别的每帧日志在编译时被移除
+ *
+ * 默认保留 Debug 级别；发布构建可定义为 2（Info）彻底去掉每帧日志的开销。
+ */
+#ifndef SHM_LOG_MIN_LEVEL
+#define SHM_LOG_MIN_LEVEL 1
+#endif
+
+namespace SharedMemory {
+
+    /**
+     * @brief 日志级别
+     */
+    enum class LogLevel : uint32_t {
+        Trace = 0,
+        Debug = 1,       ///< 每帧读写成功等高频消息
+        Info = 2,
+        Warning = 3,
+        Error = 4,
+        Off = 5
+    };
+
+    /**
+     * @brief 异步日志器
+     *
+     * 调用线程只把消息写入有界无锁队列（多生产者单消费者），格式化时间戳、
+     * 写控制台和写文件都在后台线程完成。队列满时丢弃消息并计数，不会阻塞调用者。
+     * 同一文件路径在进程内共享一个日志器实例。
+     */
+    class AsyncLogger {
+    public:
+        /**
+         * @brief 获取写入指定文件的日志器，路径为空时只输出到控制台
+         */
+        static std::shared_ptr<AsyncLogger> Get(const std::string& filePath, bool logToConsole = true);
+
+        explicit AsyncLogger(const std::string& filePath, bool logToConsole = true);
+        ~AsyncLogger();
+
+        AsyncLogger(const AsyncLogger&) = delete;
+        AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+        /**
+         * @brief 提交一条日志，过长的消息会被截断
+         * @return 队列已满导致消息被丢弃时返回 false
+         */
+        bool Write(LogLevel level, const std::string& message);
+
+        /**
+         * @brief 唤醒后台线程立即写出队列中的消息
+         */
+        void Flush();
+
+        uint64_t GetDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    private:
+        static const size_t kQueueCapacity = 4096;     ///< 必须是2的幂
+        static const size_t kMaxMessageLength = 320;
+
+        struct Entry {
+            std::atomic<size_t> sequence;
+            std::chrono::system_clock::time_point time;
+            uint32_t length;
+            char text[kMaxMessageLength];
+        };
+
+        bool TryPop(std::string& line);
+        void FlushThreadProc();
+
+        std::string m_filePath;
+        bool m_logToConsole;
+        std::unique_ptr<Entry[]> m_entries;
+
+        // Producer and consumer positions live on separate cache lines
+        char m_pad0[64];
+        std::atomic<size_t> m_enqueuePos;
+        char m_pad1[64];
+        size_t m_dequeuePos;
+        char m_pad2[64];
+
+        // Flush thread only
+        std::time_t m_lastSecond;
+        std::string m_lastTimeText;
+
+        std::atomic<uint64_t> m_dropped;
+        std::atomic<bool> m_running;
+        std::mutex m_wakeMutex;
+        std::condition_variable m_wakeCondition;
+        std::thread m_flushThread;
+    };
+
+} // namespace SharedMemory
@@ -0,0 +1,335 @@
+/**
+ * @file Platform.h
+ * @brief 操作系统相关的共享内存映射、命名同步对象和进程/线程工具
+ * @author gyg
+ * @date 2026-10-14
+ *
+ * Windows 实现位于 PlatformWin32.cpp，Linux 实现位于 PlatformPosix.cpp，两者的共享内存布局完全相同。
+ * 公共头文件不包含 <windows.h>，句柄以不透明指针或文件描述符保存。
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace SharedMemory {
+
+    /**
+     * @brief 等待命名互斥锁的结果
+     */
+    enum class LockResult {
+        Acquired = 0,    ///< 正常获得
+        Abandoned = 1,   ///< 上一个持有者异常退出，锁已归调用方所有，共享状态可能不一致
+        Timeout = 2      ///< 超时或出错，未获得
+    };
+
+    const int32_t kNumaCurrentNode = -2;   ///< 使用调用线程当前所在的NUMA节点
+    const size_t kMaxWaitAnyEvents = 64;   ///< NamedEvent::WaitAny 一次最多等待的事件数，与 Windows 的 MAXIMUM_WAIT_OBJECTS 相同
+
+    /**
+     * @brief 映射物理页的方式
+     */
+    struct MappingOptions {
+        bool largePages = false;   ///< 尝试使用大页，只对创建有效
+        bool prefault = false;     ///< 映射后立即提交并访问每一页，初始化时承担所有缺页，之后的帧不再缺页
+        bool lockPages = false;    ///< 把映射锁定在物理内存中（VirtualLock / mlock），不会被换出
+        int32_t numaNode = -1;     ///< 物理页所在的NUMA节点，-1表示由系统决定，kNumaCurrentNode表示调用线程所在的节点
+    };
+
+    /**
+     * @brief 命名共享内存映射
+     *
+     * Windows 使用页面文件支持的文件映射对象，所有句柄关闭后自动释放；
+     * POSIX 使用 shm_open 创建的对象（/dev/shm/<name>），大页映射位于 hugetlbfs（/dev/hugepages/<name>），
+     * 进程退出后对象仍然存在，直到调用 RemoveSharedObject 删除。
+     *
+     * NUMA节点在 Windows 上通过 CreateFileMappingNuma/MapViewOfFileExNuma 指定，
+     * 在 Linux 上通过 mbind(MPOL_PREFERRED) 指定，两者都只影响此后才分配的物理页。
+     */
+    class SharedMapping {
+    public:
+        SharedMapping();
+        ~SharedMapping();
+
+        SharedMapping(const SharedMapping&) = delete;
+        SharedMapping& operator=(const SharedMapping&) = delete;
+
+        /**
+         * @brief 创建命名共享内存并映射 size 字节，同名对象已存在时打开它
+         *
+         * 使用大页时大小会向上取整到大页大小，不可用时退回普通页，原因见 GetLastError()；
+         * 预取、锁定和NUMA节点失败时不影响映射本身，结果见 Prefaulted()/Locked()/NumaNode()。
+         */
+        bool Create(const std::string& name, size_t size, const MappingOptions& options);
+
+        /**
+         * @brief 打开已存在的命名共享内存并映射整个对象，不存在时失败，忽略 options.largePages
+         */
+        bool Open(const std::string& name, const MappingOptions& options);
+
+        void Close();
+
+        uint8_t* Data() const { return m_data; }
+        size_t Size() const { return m_size; }
+        bool AlreadyExisted() const { return m_alreadyExisted; }
+        bool LargePages() const { return m_largePages; }
+        bool Prefaulted() const { return m_prefaulted; }
+        bool Locked() const { return m_locked; }
+
+        /**
+         * @brief 实际指定的NUMA节点，未指定或指定失败时为 -1
+         */
+        int32_t NumaNode() const { return m_numaNode; }
+
+        /**
+         * @brief 失败的原因，或请求了大页但未能使用的原因
+         */
+        const std::string& GetLastError() const { return m_lastError; }
+
+    private:
+        uint8_t* m_data;
+        size_t m_size;
+        bool m_alreadyExisted;
+        bool m_largePages;
+        bool m_prefaulted;
+        bool m_locked;
+        int32_t m_numaNode;
+        std::string m_lastError;
+
+        /**
+         * @brief 按 options 预取和锁定已映射的视图
+         */
+        void CommitPages(const MappingOptions& options);
+#ifdef _WIN32
+        void* m_handle;
+#else
+        int m_fd;
+#endif
+    };
+
+    /**
+     * @brief 磁盘文件的内存映射，用于帧的录制和回放
+     *
+     * 写入时文件按窗口逐段扩大，同一时刻只映射正在写入的一段，解除映射时发起异步写回，
+     * 数据以窗口大小为单位顺序落盘；读取时只读映射整个文件。
+     */
+    class MappedFile {
+    public:
+        MappedFile();
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /**
+         * @brief 创建文件用于写入，已存在的文件被截断为空
+         */
+        bool Create(const std::string& path);
+
+        /**
+         * @brief 以只读方式打开已存在的文件并映射全部内容
+         */
+        bool OpenReadOnly(const std::string& path);
+
+        void Close();
+
+        /**
+         * @brief 解除当前窗口，把文件扩大到至少 offset + size 字节，并以读写方式映射这一段
+         * @param offset 必须是 MapGranularity() 的整数倍
+         * @return 窗口起始地址，失败时返回 nullptr
+         */
+        uint8_t* MapWindow(uint64_t offset, size_t size);
+
+        /**
+         * @brief 发起当前窗口的异步写回并解除映射
+         */
+        void UnmapWindow();
+
+        /**
+         * @brief 把文件截断到 size 字节，调用前必须解除窗口
+         */
+        bool Truncate(uint64_t size);
+
+        /**
+         * @brief 只读映射的数据和文件大小
+         */
+        const uint8_t* Data() const { return m_data; }
+        uint64_t Size() const { return m_size; }
+
+        /**
+         * @brief 窗口偏移的对齐粒度（Windows 为64KB，POSIX 为页大小）
+         */
+        static size_t MapGranularity();
+
+        const std::string& GetLastError() const { return m_lastError; }
+
+    private:
+        uint8_t* m_data;      ///< 只读映射，或当前写入窗口
+        size_t m_mappedSize;  ///< m_data 映射的字节数
+        uint64_t m_size;      ///< 只读映射的文件大小
+        std::string m_lastError;
+#ifdef _WIN32
+        void* m_file;
+        void* m_section;
+        bool m_writable;      ///< m_data 是 MapWindow 映射的可写窗口，解除前需要写回
+#else
+        int m_fd;
+#endif
+    };
+
+    /**
+     * @brief 跨进程的命名互斥锁
+     *
+     * Windows 使用命名 Mutex；POSIX 使用位于独立共享内存对象中的健壮进程间互斥锁
+     * （PTHREAD_PROCESS_SHARED + PTHREAD_MUTEX_ROBUST），持有者崩溃时下一个等待者得到 Abandoned。
+     */
+    class NamedMutex {
+    public:
+        NamedMutex();
+        ~NamedMutex();
+
+        NamedMutex(const NamedMutex&) = delete;
+        NamedMutex& operator=(const NamedMutex&) = delete;
+
+        /**
+         * @brief 创建或打开命名互斥锁
+         */
+        bool Open(const std::string& name);
+        void Close();
+
+        LockResult Lock(uint32_t timeoutMs);
+        void Unlock();
+
+    private:
+#ifdef _WIN32
+        void* m_handle;
+#else
+        struct SharedBlock;
+        SharedBlock* m_block;
+#endif
+    };
+
+    /**
+     * @brief 跨进程的命名自动重置事件，每次 Signal 最多唤醒一个等待者
+     *
+     * Windows 使用命名 Event；POSIX 使用独立共享内存对象中的一个32位字和 futex。
+     */
+    class NamedEvent {
+    public:
+        NamedEvent();
+        ~NamedEvent();
+
+        NamedEvent(const NamedEvent&) = delete;
+        NamedEvent& operator=(const NamedEvent&) = delete;
+
+        /**
+         * @brief 创建或打开命名事件，已打开的事件先被关闭
+         */
+        bool Open(const std::string& name);
+        void Close();
+        bool IsOpen() const;
+
+        void Signal();
+
+        /**
+         * @brief 等待事件被触发并将其复位
+         * @return 超时返回 false
+         */
+        bool Wait(uint32_t timeoutMs);
+
+        /**
+         * @brief 等待任意一个事件被触发，只复位返回的那一个
+         * @param count 事件数，超过 kMaxWaitAnyEvents 时不等待直接返回 -1
+         * @return 被触发的事件下标，超时或出错返回 -1
+         * @note POSIX 下依赖 futex_waitv（Linux 5.16+），旧内核退回为按1毫秒轮询
+         */
+        static int WaitAny(NamedEvent* const* events, size_t count, uint32_t timeoutMs);
+
+    private:
+#ifdef _WIN32
+        void* m_handle;
+#else
+        std::atomic<uint32_t>* m_word;
+#endif
+    };
+
+    /**
+     * @brief 以给定参数启动当前可执行文件的子进程
+     */
+    class ChildProcess {
+    public:
+        ChildProcess();
+        ~ChildProcess();
+
+        ChildProcess(const ChildProcess&) = delete;
+        ChildProcess& operator=(const ChildProcess&) = delete;
+
+        bool Start(const std::vector<std::string>& args);
+
+        /**
+         * @brief 等待子进程退出
+         * @return 子进程是否已经退出
+         */
+        bool Wait(uint32_t timeoutMs);
+
+        /**
+         * @brief 子进程的退出码，尚未退出或未启动时返回 -1
+         */
+        int ExitCode() const { return m_exitCode; }
+
+        void Terminate();
+
+    private:
+        int m_exitCode;
+#ifdef _WIN32
+        void* m_process;
+#else
+        int m_pid;
+#endif
+    };
+
+    /**
+     * @brief 删除命名共享内存对象，POSIX 下用于清理进程退出后残留的对象，Windows 下不做任何事
+     */
+    void RemoveSharedObject(const std::string& name);
+
+    uint32_t CurrentProcessId();
+
+    /**
+     * @brief 调用线程当前所在的NUMA节点，无法获取时返回 0
+     */
+    int32_t CurrentNumaNode();
+
+    /**
+     * @brief 进程是否已经退出，进程不存在时也返回 true
+     */
+    bool ProcessExited(uint32_t processId);
+
+    /**
+     * @brief 把当前线程绑定到指定CPU，Windows 下只支持第一个处理器组（前64个CPU）
+     */
+    bool PinCurrentThread(uint32_t cpu);
+
+    /**
+     * @brief 自旋等待时的CPU提示（x86 为 pause）
+     */
+    inline void CpuRelax()
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+} // namespace SharedMemory
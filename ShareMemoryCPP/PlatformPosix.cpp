@@ -0,0 +1,773 @@
+/**
+ * @file PlatformPosix.cpp
+ * @brief 平台层的 Linux 实现：shm_open/mmap 映射、健壮进程间互斥锁、futex 事件和进程工具
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#include "Platform.h"
+
+#ifndef _WIN32
+
+#include <chrono>
+#include <thread>
+#include <cerrno>
+#include <climits>
+#include <ctime>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+#ifndef SYS_futex_waitv
+#define SYS_futex_waitv 449
+#endif
+
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
+extern char** environ;
+
+namespace SharedMemory {
+
+namespace {
+
+    const char* const kHugePageDirectory = "/dev/hugepages/";
+    const long kHugetlbfsMagic = 0x958458f6;
+
+    // How often an opener polls while another process is still initializing a mutex block
+    const auto kInitPollInterval = std::chrono::milliseconds(1);
+    const int kInitPollCount = 1000;
+
+    // Fallback slice for WaitAny on kernels without futex_waitv
+    const uint32_t kWaitAnySliceMs = 1;
+
+    size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    /**
+     * @brief Windows 对象名可以包含 '\' 和 '/'，POSIX 共享内存名只能在开头有一个 '/'
+     */
+    std::string ObjectName(const std::string& name)
+    {
+        std::string result = name;
+        for (char& c : result) {
+            if (c == '/' || c == '\\') {
+                c = '_';
+            }
+        }
+        return result;
+    }
+
+    std::string ShmPath(const std::string& name)
+    {
+        return "/" + ObjectName(name);
+    }
+
+    std::string HugePagePath(const std::string& name)
+    {
+        return kHugePageDirectory + ObjectName(name);
+    }
+
+    /**
+     * @brief 以独占方式创建，已存在时打开
+     * @param created 输出是否由本次调用创建
+     */
+    int CreateOrOpen(const std::string& path, bool hugetlbfs, bool& created)
+    {
+        int flags = O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC;
+        int fd = hugetlbfs ? open(path.c_str(), flags, 0666) : shm_open(path.c_str(), flags, 0666);
+        created = fd >= 0;
+        if (fd < 0 && errno == EEXIST) {
+            flags = O_RDWR | O_CLOEXEC;
+            fd = hugetlbfs ? open(path.c_str(), flags) : shm_open(path.c_str(), flags, 0);
+        }
+        return fd;
+    }
+
+    /**
+     * @brief 对象小于 size 时把它扩大，已有内容保持不变
+     */
+    bool EnsureSize(int fd, size_t size)
+    {
+        struct stat st = {};
+        if (fstat(fd, &st) != 0) {
+            return false;
+        }
+        return static_cast<size_t>(st.st_size) >= size || ftruncate(fd, static_cast<off_t>(size)) == 0;
+    }
+
+    void* MapShared(int fd, size_t size)
+    {
+        // Pages are faulted in lazily unless CommitPages prefaults them
+        void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        return data == MAP_FAILED ? nullptr : data;
+    }
+
+    // Values from <numaif.h>, called directly so libnuma is not needed
+    const int kMpolPreferred = 1;
+    const int kMaxNumaNodes = 1024;
+
+    bool BindToNode(void* data, size_t size, int32_t numaNode)
+    {
+        unsigned long mask[kMaxNumaNodes / (8 * sizeof(unsigned long))] = {};
+        if (numaNode < 0 || numaNode >= kMaxNumaNodes) {
+            return false;
+        }
+        mask[numaNode / (8 * sizeof(unsigned long))] |= 1ul << (numaNode % (8 * sizeof(unsigned long)));
+        return syscall(SYS_mbind, data, size, kMpolPreferred, mask, kMaxNumaNodes, 0) == 0;
+    }
+
+    /**
+     * @brief 映射一个只包含同步字段的小对象，首次创建时内容全为0
+     */
+    void* MapSmallObject(const std::string& name, size_t size)
+    {
+        bool created = false;
+        int fd = CreateOrOpen(ShmPath(name), false, created);
+        if (fd < 0) {
+            return nullptr;
+        }
+        void* data = EnsureSize(fd, size) ? MapShared(fd, size) : nullptr;
+        close(fd);
+        return data;
+    }
+
+    long Futex(std::atomic<uint32_t>* word, int op, uint32_t value, const timespec* timeout)
+    {
+        // Not FUTEX_PRIVATE_FLAG: the word is shared between processes
+        return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, value, timeout, nullptr, 0);
+    }
+
+    timespec ToTimespec(std::chrono::nanoseconds duration)
+    {
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(duration.count() / 1000000000);
+        ts.tv_nsec = static_cast<long>(duration.count() % 1000000000);
+        return ts;
+    }
+
+    /**
+     * @brief futex_waitv 的等待项，对应内核的 struct futex_waitv
+     */
+    struct FutexWaitv {
+        uint64_t val;
+        uint64_t uaddr;
+        uint32_t flags;
+        uint32_t reserved;
+    };
+
+    const uint32_t kFutex2Size32 = 0x02;
+
+    bool TryConsume(std::atomic<uint32_t>* word)
+    {
+        return word->load(std::memory_order_relaxed) != 0 &&
+               word->exchange(0, std::memory_order_acquire) != 0;
+    }
+
+} // namespace
+
+SharedMapping::SharedMapping()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_alreadyExisted(false)
+    , m_largePages(false)
+    , m_prefaulted(false)
+    , m_locked(false)
+    , m_numaNode(-1)
+    , m_fd(-1)
+{
+}
+
+SharedMapping::~SharedMapping()
+{
+    Close();
+}
+
+bool SharedMapping::Create(const std::string& name, size_t size, const MappingOptions& options)
+{
+    Close();
+    m_lastError.clear();
+    m_largePages = false;
+    m_size = size;
+
+    bool created = false;
+    if (options.largePages) {
+        // Explicit huge pages need a hugetlbfs mount, the object size must be a multiple of the page size
+        struct statfs fs = {};
+        if (statfs(kHugePageDirectory, &fs) != 0 || static_cast<long>(fs.f_type) != kHugetlbfsMagic) {
+            m_lastError = "No hugetlbfs mounted at /dev/hugepages";
+        }
+        else {
+            size_t hugeSize = AlignUp(size, static_cast<size_t>(fs.f_bsize));
+            m_fd = CreateOrOpen(HugePagePath(name), true, created);
+            if (m_fd >= 0 && EnsureSize(m_fd, hugeSize)) {
+                m_data = static_cast<uint8_t*>(MapShared(m_fd, hugeSize));
+            }
+            if (m_data) {
+                m_size = hugeSize;
+                m_largePages = true;
+            }
+            else {
+                m_lastError = "Not enough huge pages reserved (vm.nr_hugepages)";
+                if (m_fd >= 0) {
+                    close(m_fd);
+                    m_fd = -1;
+                }
+                if (created) {
+                    unlink(HugePagePath(name).c_str());
+                }
+            }
+        }
+    }
+
+    if (!m_data) {
+        m_fd = CreateOrOpen(ShmPath(name), false, created);
+        if (m_fd < 0) {
+            m_lastError = "Failed to create shared memory object";
+            return false;
+        }
+        // A peer that created the object may not have sized it yet
+        if (!EnsureSize(m_fd, m_size)) {
+            m_lastError = "Failed to size shared memory object";
+            Close();
+            return false;
+        }
+        m_data = static_cast<uint8_t*>(MapShared(m_fd, m_size));
+        if (!m_data) {
+            m_lastError = "Failed to map shared memory";
+            Close();
+            return false;
+        }
+        if (options.largePages) {
+            // Still ask for transparent huge pages, honoured when shmem_enabled allows it
+            madvise(m_data, m_size, MADV_HUGEPAGE);
+        }
+    }
+    m_alreadyExisted = !created;
+    CommitPages(options);
+    return true;
+}
+
+bool SharedMapping::Open(const std::string& name, const MappingOptions& options)
+{
+    Close();
+    m_lastError.clear();
+    m_largePages = false;
+
+    m_fd = shm_open(ShmPath(name).c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (m_fd < 0) {
+        m_fd = open(HugePagePath(name).c_str(), O_RDWR | O_CLOEXEC);
+        m_largePages = m_fd >= 0;
+    }
+    if (m_fd < 0) {
+        m_lastError = "Shared memory does not exist, start the producer first";
+        return false;
+    }
+    m_alreadyExisted = true;
+
+    struct stat st = {};
+    if (fstat(m_fd, &st) != 0 || st.st_size == 0) {
+        m_lastError = "Shared memory has not been sized by its creator yet";
+        Close();
+        return false;
+    }
+    m_size = static_cast<size_t>(st.st_size);
+    m_data = static_cast<uint8_t*>(MapShared(m_fd, m_size));
+    if (!m_data) {
+        m_lastError = "Failed to map shared memory";
+        Close();
+        return false;
+    }
+    CommitPages(options);
+    return true;
+}
+
+void SharedMapping::CommitPages(const MappingOptions& options)
+{
+    // The policy only applies to pages allocated afterwards, so bind before touching anything
+    int32_t numaNode = options.numaNode == kNumaCurrentNode ? CurrentNumaNode() : options.numaNode;
+    m_numaNode = numaNode >= 0 && BindToNode(m_data, m_size, numaNode) ? numaNode : -1;
+
+    m_prefaulted = false;
+    if (options.prefault || options.lockPages) {
+        // MADV_POPULATE_WRITE (Linux 5.14+) faults everything in writable, without touching the data
+        m_prefaulted = madvise(m_data, m_size, MADV_POPULATE_WRITE) == 0;
+        if (!m_prefaulted) {
+            // A read fault allocates the page of a shm object as well
+            size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            volatile const uint8_t* pages = m_data;
+            for (size_t offset = 0; offset < m_size; offset += pageSize) {
+                (void)pages[offset];
+            }
+            m_prefaulted = true;
+        }
+    }
+
+    // Fails beyond RLIMIT_MEMLOCK unless the process has CAP_IPC_LOCK
+    m_locked = options.lockPages && mlock(m_data, m_size) == 0;
+}
+
+void SharedMapping::Close()
+{
+    if (m_data) {
+        if (m_locked) {
+            munlock(m_data, m_size);
+            m_locked = false;
+        }
+        munmap(m_data, m_size);
+        m_data = nullptr;
+    }
+    if (m_fd >= 0) {
+        close(m_fd);
+        m_fd = -1;
+    }
+}
+
+MappedFile::MappedFile()
+    : m_data(nullptr)
+    , m_mappedSize(0)
+    , m_size(0)
+    , m_fd(-1)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Create(const std::string& path)
+{
+    Close();
+    m_lastError.clear();
+    m_fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        m_lastError = "Failed to create " + path;
+        return false;
+    }
+    return true;
+}
+
+bool MappedFile::OpenReadOnly(const std::string& path)
+{
+    Close();
+    m_lastError.clear();
+    m_fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st = {};
+    if (m_fd < 0 || fstat(m_fd, &st) != 0) {
+        m_lastError = "Failed to open " + path;
+        Close();
+        return false;
+    }
+    m_size = static_cast<uint64_t>(st.st_size);
+    if (m_size == 0) {
+        m_lastError = path + " is empty";
+        Close();
+        return false;
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(m_size), PROT_READ, MAP_SHARED, m_fd, 0);
+    if (data == MAP_FAILED) {
+        m_lastError = "Failed to map " + path;
+        Close();
+        return false;
+    }
+    // Replay walks the file front to back: read ahead aggressively, drop pages behind
+    madvise(data, static_cast<size_t>(m_size), MADV_SEQUENTIAL);
+    m_data = static_cast<uint8_t*>(data);
+    m_mappedSize = static_cast<size_t>(m_size);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data) {
+        munmap(m_data, m_mappedSize);
+        m_data = nullptr;
+        m_mappedSize = 0;
+    }
+    if (m_fd >= 0) {
+        close(m_fd);
+        m_fd = -1;
+    }
+    m_size = 0;
+}
+
+uint8_t* MappedFile::MapWindow(uint64_t offset, size_t size)
+{
+    UnmapWindow();
+    if (m_fd < 0 || offset % MapGranularity() != 0) {
+        m_lastError = "Invalid file window";
+        return nullptr;
+    }
+
+    // Sparse extension, blocks are allocated as the window is written
+    struct stat st = {};
+    if (fstat(m_fd, &st) != 0 ||
+        (static_cast<uint64_t>(st.st_size) < offset + size && ftruncate(m_fd, static_cast<off_t>(offset + size)) != 0)) {
+        m_lastError = "Failed to extend file";
+        return nullptr;
+    }
+
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, static_cast<off_t>(offset));
+    if (data == MAP_FAILED) {
+        m_lastError = "Failed to map file window";
+        return nullptr;
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+    m_data = static_cast<uint8_t*>(data);
+    m_mappedSize = size;
+    return m_data;
+}
+
+void MappedFile::UnmapWindow()
+{
+    if (m_data) {
+        // Start writeback of the whole window now instead of waiting for the flusher threads
+        msync(m_data, m_mappedSize, MS_ASYNC);
+        munmap(m_data, m_mappedSize);
+        m_data = nullptr;
+        m_mappedSize = 0;
+    }
+}
+
+bool MappedFile::Truncate(uint64_t size)
+{
+    if (m_fd < 0 || ftruncate(m_fd, static_cast<off_t>(size)) != 0) {
+        m_lastError = "Failed to truncate file";
+        return false;
+    }
+    return true;
+}
+
+size_t MappedFile::MapGranularity()
+{
+    static const size_t granularity = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return granularity;
+}
+
+/**
+ * @brief 互斥锁所在的共享对象。State 为0表示尚未初始化，1表示正在初始化，2表示可用
+ */
+struct NamedMutex::SharedBlock {
+    std::atomic<uint32_t> State;
+    pthread_mutex_t Mutex;
+};
+
+NamedMutex::NamedMutex()
+    : m_block(nullptr)
+{
+}
+
+NamedMutex::~NamedMutex()
+{
+    Close();
+}
+
+bool NamedMutex::Open(const std::string& name)
+{
+    Close();
+    SharedBlock* block = static_cast<SharedBlock*>(MapSmallObject(name, sizeof(SharedBlock)));
+    if (!block) {
+        return false;
+    }
+
+    uint32_t expected = 0;
+    if (block->State.compare_exchange_strong(expected, 1, std::memory_order_acquire)) {
+        // A robust mutex hands EOWNERDEAD to the next locker when its owner dies, like WAIT_ABANDONED
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+        pthread_mutex_init(&block->Mutex, &attr);
+        pthread_mutexattr_destroy(&attr);
+        block->State.store(2, std::memory_order_release);
+    }
+    else {
+        for (int i = 0; i < kInitPollCount && block->State.load(std::memory_order_acquire) != 2; ++i) {
+            std::this_thread::sleep_for(kInitPollInterval);
+        }
+        if (block->State.load(std::memory_order_acquire) != 2) {
+            munmap(block, sizeof(SharedBlock));
+            return false;
+        }
+    }
+    m_block = block;
+    return true;
+}
+
+void NamedMutex::Close()
+{
+    if (m_block) {
+        munmap(m_block, sizeof(SharedBlock));
+        m_block = nullptr;
+    }
+}
+
+LockResult NamedMutex::Lock(uint32_t timeoutMs)
+{
+    // pthread_mutex_timedlock takes an absolute CLOCK_REALTIME deadline
+    timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeoutMs / 1000;
+    deadline.tv_nsec += static_cast<long>(timeoutMs % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1000000000;
+    }
+
+    int result = pthread_mutex_timedlock(&m_block->Mutex, &deadline);
+    if (result == 0) {
+        return LockResult::Acquired;
+    }
+    if (result == EOWNERDEAD) {
+        pthread_mutex_consistent(&m_block->Mutex);
+        return LockResult::Abandoned;
+    }
+    return LockResult::Timeout;
+}
+
+void NamedMutex::Unlock()
+{
+    pthread_mutex_unlock(&m_block->Mutex);
+}
+
+NamedEvent::NamedEvent()
+    : m_word(nullptr)
+{
+}
+
+NamedEvent::~NamedEvent()
+{
+    Close();
+}
+
+bool NamedEvent::Open(const std::string& name)
+{
+    Close();
+    // A zero-filled new object is a valid, non-signaled event, so there is nothing to initialize
+    m_word = static_cast<std::atomic<uint32_t>*>(MapSmallObject(name, sizeof(std::atomic<uint32_t>)));
+    return m_word != nullptr;
+}
+
+void NamedEvent::Close()
+{
+    if (m_word) {
+        munmap(m_word, sizeof(std::atomic<uint32_t>));
+        m_word = nullptr;
+    }
+}
+
+bool NamedEvent::IsOpen() const
+{
+    return m_word != nullptr;
+}
+
+void NamedEvent::Signal()
+{
+    // Setting an already signaled event wakes nobody, as with SetEvent
+    if (m_word->exchange(1, std::memory_order_release) == 0) {
+        Futex(m_word, FUTEX_WAKE, 1, nullptr);
+    }
+}
+
+bool NamedEvent::Wait(uint32_t timeoutMs)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    for (;;) {
+        if (TryConsume(m_word)) {
+            return true;
+        }
+        auto remaining = deadline - std::chrono::steady_clock::now();
+        if (remaining <= std::chrono::nanoseconds::zero()) {
+            return false;
+        }
+        timespec timeout = ToTimespec(std::chrono::duration_cast<std::chrono::nanoseconds>(remaining));
+        Futex(m_word, FUTEX_WAIT, 0, &timeout);
+    }
+}
+
+int NamedEvent::WaitAny(NamedEvent* const* events, size_t count, uint32_t timeoutMs)
+{
+    if (count == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+        return -1;
+    }
+    if (count > kMaxWaitAnyEvents) {
+        return -1;
+    }
+
+    static std::atomic<bool> waitvMissing(false);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    for (;;) {
+        for (size_t i = 0; i < count; ++i) {
+            if (TryConsume(events[i]->m_word)) {
+                return static_cast<int>(i);
+            }
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return -1;
+        }
+
+        if (!waitvMissing.load(std::memory_order_relaxed)) {
+            FutexWaitv waiters[kMaxWaitAnyEvents] = {};
+            for (size_t i = 0; i < count; ++i) {
+                waiters[i].val = 0;
+                waiters[i].uaddr = reinterpret_cast<uint64_t>(events[i]->m_word);
+                waiters[i].flags = kFutex2Size32;
+            }
+            // futex_waitv takes an absolute deadline on the given clock
+            timespec absolute = ToTimespec(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                deadline.time_since_epoch()));
+            if (syscall(SYS_futex_waitv, waiters, static_cast<unsigned int>(count), 0, &absolute,
+                        CLOCK_MONOTONIC) >= 0) {
+                continue;
+            }
+            // Woken, interrupted, an event already set or the deadline passed: recheck the words
+            if (errno == EINTR || errno == EAGAIN || errno == ETIMEDOUT) {
+                continue;
+            }
+            if (errno != ENOSYS) {
+                return -1;
+            }
+            waitvMissing.store(true, std::memory_order_relaxed);
+        }
+
+        // Older kernels: block on the first event in short slices and poll the rest
+        auto slice = std::min<std::chrono::steady_clock::duration>(deadline - now,
+                                                                   std::chrono::milliseconds(kWaitAnySliceMs));
+        timespec timeout = ToTimespec(std::chrono::duration_cast<std::chrono::nanoseconds>(slice));
+        Futex(events[0]->m_word, FUTEX_WAIT, 0, &timeout);
+    }
+}
+
+ChildProcess::ChildProcess()
+    : m_exitCode(-1)
+    , m_pid(0)
+{
+}
+
+ChildProcess::~ChildProcess()
+{
+    // Reap the child if it has already exited, never block here
+    if (m_pid > 0 && m_exitCode < 0) {
+        Wait(0);
+    }
+}
+
+bool ChildProcess::Start(const std::vector<std::string>& args)
+{
+    char modulePath[PATH_MAX] = {};
+    ssize_t length = readlink("/proc/self/exe", modulePath, sizeof(modulePath) - 1);
+    if (length <= 0) {
+        return false;
+    }
+
+    std::vector<std::string> argStorage;
+    argStorage.push_back(modulePath);
+    argStorage.insert(argStorage.end(), args.begin(), args.end());
+    std::vector<char*> argv;
+    for (std::string& arg : argStorage) {
+        argv.push_back(&arg[0]);
+    }
+    argv.push_back(nullptr);
+
+    pid_t pid = 0;
+    if (posix_spawn(&pid, modulePath, nullptr, nullptr, argv.data(), environ) != 0) {
+        return false;
+    }
+    m_pid = pid;
+    m_exitCode = -1;
+    return true;
+}
+
+bool ChildProcess::Wait(uint32_t timeoutMs)
+{
+    if (m_pid <= 0) {
+        return false;
+    }
+    if (m_exitCode >= 0) {
+        return true;
+    }
+
+    // waitpid has no timeout, poll it
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    for (;;) {
+        int status = 0;
+        pid_t result = waitpid(m_pid, &status, WNOHANG);
+        if (result == m_pid) {
+            m_exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+            return true;
+        }
+        if (result < 0 || std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void ChildProcess::Terminate()
+{
+    if (m_pid > 0 && m_exitCode < 0) {
+        kill(m_pid, SIGKILL);
+        int status = 0;
+        waitpid(m_pid, &status, 0);
+        m_exitCode = 128 + SIGKILL;
+    }
+}
+
+void RemoveSharedObject(const std::string& name)
+{
+    shm_unlink(ShmPath(name).c_str());
+    unlink(HugePagePath(name).c_str());
+}
+
+uint32_t CurrentProcessId()
+{
+    return static_cast<uint32_t>(getpid());
+}
+
+int32_t CurrentNumaNode()
+{
+    unsigned int cpu = 0;
+    unsigned int node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+        return 0;
+    }
+    return static_cast<int32_t>(node);
+}
+
+bool ProcessExited(uint32_t processId)
+{
+    // EPERM means the process exists but belongs to someone else
+    return kill(static_cast<pid_t>(processId), 0) != 0 && errno == ESRCH;
+}
+
+bool PinCurrentThread(uint32_t cpu)
+{
+    if (cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+}
+
+} // namespace SharedMemory
+
+#endif // !_WIN32
@@ -0,0 +1,584 @@
+/**
+ * @file PlatformWin32.cpp
+ * @brief 平台层的 Windows 实现：文件映射对象、命名 Mutex/Event 和进程工具
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#include "Platform.h"
+
+#ifdef _WIN32
+
+#define NOMINMAX  // 防止Windows.h定义min和max宏
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h> // 注意使用小写的windows.h而不是Windows.h
+
+#include <sstream>
+#include <algorithm>
+
+namespace SharedMemory {
+
+namespace {
+
+    size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    /**
+     * @brief 为当前进程启用 SeLockMemoryPrivilege，大页映射需要该权限
+     */
+    bool EnableLockMemoryPrivilege()
+    {
+        HANDLE token = NULL;
+        if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+            return false;
+        }
+
+        TOKEN_PRIVILEGES privileges = {};
+        privileges.PrivilegeCount = 1;
+        privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+        bool success = LookupPrivilegeValueA(NULL, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid)
+                    && AdjustTokenPrivileges(token, FALSE, &privileges, 0, NULL, NULL)
+                    && GetLastError() == ERROR_SUCCESS;  // ERROR_NOT_ALL_ASSIGNED when the account lacks the right
+        CloseHandle(token);
+        return success;
+    }
+
+    DWORD NumaPreference(int32_t numaNode)
+    {
+        return numaNode >= 0 ? static_cast<DWORD>(numaNode) : NUMA_NO_PREFERRED_NODE;
+    }
+
+    HANDLE CreateSection(const std::string& name, uint64_t size, DWORD protection, int32_t numaNode)
+    {
+        // The 64-bit size is split into high and low DWORDs
+        return CreateFileMappingNumaA(
+            INVALID_HANDLE_VALUE,
+            NULL,
+            protection,
+            static_cast<DWORD>(size >> 32),
+            static_cast<DWORD>(size & 0xFFFFFFFF),
+            name.c_str(),
+            NumaPreference(numaNode)
+        );
+    }
+
+    uint8_t* MapSection(HANDLE section, DWORD access, SIZE_T size, int32_t numaNode)
+    {
+        return static_cast<uint8_t*>(MapViewOfFileExNuma(section, access, 0, 0, size, NULL, NumaPreference(numaNode)));
+    }
+
+    /**
+     * @brief 扩大进程工作集的最小和最大值，VirtualLock 锁定的页数不能超过最小工作集
+     */
+    bool GrowWorkingSet(SIZE_T bytes)
+    {
+        SIZE_T minimum = 0;
+        SIZE_T maximum = 0;
+        HANDLE process = GetCurrentProcess();
+        return GetProcessWorkingSetSize(process, &minimum, &maximum)
+            && SetProcessWorkingSetSize(process, minimum + bytes, maximum + bytes);
+    }
+
+} // namespace
+
+SharedMapping::SharedMapping()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_alreadyExisted(false)
+    , m_largePages(false)
+    , m_prefaulted(false)
+    , m_locked(false)
+    , m_numaNode(-1)
+    , m_handle(NULL)
+{
+}
+
+SharedMapping::~SharedMapping()
+{
+    Close();
+}
+
+bool SharedMapping::Create(const std::string& name, size_t size, const MappingOptions& options)
+{
+    Close();
+    m_lastError.clear();
+    m_numaNode = options.numaNode == kNumaCurrentNode ? CurrentNumaNode() : options.numaNode;
+
+    // Large pages must be committed up front and the size must be a multiple of the large page size
+    m_largePages = false;
+    m_size = size;
+    if (options.largePages) {
+        size_t largePageSize = GetLargePageMinimum();
+        if (largePageSize == 0) {
+            m_lastError = "Large pages are not supported";
+        }
+        else if (!EnableLockMemoryPrivilege()) {
+            m_lastError = "SeLockMemoryPrivilege not held";
+        }
+        else {
+            m_size = AlignUp(m_size, largePageSize);
+            m_largePages = true;
+        }
+    }
+
+    HANDLE section = CreateSection(name, m_size,
+                                   m_largePages ? (PAGE_READWRITE | SEC_COMMIT | SEC_LARGE_PAGES) : PAGE_READWRITE,
+                                   m_numaNode);
+    if (section == NULL && m_largePages) {
+        m_lastError = "Failed to create large page mapping";
+        m_largePages = false;
+        section = CreateSection(name, m_size, PAGE_READWRITE, m_numaNode);
+    }
+    if (section == NULL && m_numaNode >= 0) {
+        // No such node on this machine
+        m_numaNode = -1;
+        section = CreateSection(name, m_size, PAGE_READWRITE, m_numaNode);
+    }
+    if (section == NULL) {
+        m_lastError = "Failed to create file mapping object";
+        return false;
+    }
+    m_alreadyExisted = ::GetLastError() == ERROR_ALREADY_EXISTS;
+    m_handle = section;
+
+    m_data = MapSection(section,
+                        m_largePages ? (FILE_MAP_ALL_ACCESS | FILE_MAP_LARGE_PAGES) : FILE_MAP_ALL_ACCESS,
+                        m_size,
+                        m_numaNode);
+    if (m_data == nullptr && m_largePages) {
+        // The section may already exist with normal pages, created by a peer without large pages
+        m_lastError = "Existing mapping uses normal pages";
+        m_largePages = false;
+        m_data = MapSection(section, FILE_MAP_ALL_ACCESS, m_size, m_numaNode);
+    }
+    if (m_data == nullptr) {
+        m_lastError = "Failed to map view of file";
+        Close();
+        return false;
+    }
+    CommitPages(options);
+    return true;
+}
+
+bool SharedMapping::Open(const std::string& name, const MappingOptions& options)
+{
+    Close();
+    m_lastError.clear();
+    m_largePages = false;
+    m_numaNode = options.numaNode == kNumaCurrentNode ? CurrentNumaNode() : options.numaNode;
+
+    HANDLE section = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+    if (section == NULL) {
+        m_lastError = "Shared memory does not exist, start the producer first";
+        return false;
+    }
+    m_handle = section;
+    m_alreadyExisted = true;
+
+    // Mapping the whole section also covers a producer that rounded it up to large pages
+    m_data = MapSection(section, FILE_MAP_ALL_ACCESS, 0, m_numaNode);
+    if (m_data == nullptr) {
+        m_lastError = "Failed to map view of file";
+        Close();
+        return false;
+    }
+
+    MEMORY_BASIC_INFORMATION info = {};
+    VirtualQuery(m_data, &info, sizeof(info));
+    m_size = info.RegionSize;
+    CommitPages(options);
+    return true;
+}
+
+void SharedMapping::CommitPages(const MappingOptions& options)
+{
+    m_prefaulted = false;
+    m_locked = false;
+
+    // Large pages are committed and non-pageable from the start
+    if (m_largePages) {
+        m_prefaulted = true;
+        m_locked = true;
+        return;
+    }
+
+    if (options.lockPages && GrowWorkingSet(m_size)) {
+        // Locking faults every page in as well
+        m_locked = VirtualLock(m_data, m_size) != FALSE;
+    }
+    if (options.prefault && !m_locked) {
+        // Touch one byte per page, a read is enough to commit a page of a page file backed section
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+        volatile const uint8_t* pages = m_data;
+        for (size_t offset = 0; offset < m_size; offset += systemInfo.dwPageSize) {
+            (void)pages[offset];
+        }
+    }
+    m_prefaulted = options.prefault || m_locked;
+}
+
+void SharedMapping::Close()
+{
+    if (m_data) {
+        if (m_locked) {
+            VirtualUnlock(m_data, m_size);
+            m_locked = false;
+        }
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+    if (m_handle) {
+        CloseHandle(m_handle);
+        m_handle = NULL;
+    }
+}
+
+MappedFile::MappedFile()
+    : m_data(nullptr)
+    , m_mappedSize(0)
+    , m_size(0)
+    , m_file(INVALID_HANDLE_VALUE)
+    , m_section(NULL)
+    , m_writable(false)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Create(const std::string& path)
+{
+    Close();
+    m_lastError.clear();
+    m_file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS,
+                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_lastError = "Failed to create " + path;
+        return false;
+    }
+    return true;
+}
+
+bool MappedFile::OpenReadOnly(const std::string& path)
+{
+    Close();
+    m_lastError.clear();
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    LARGE_INTEGER size = {};
+    if (m_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_file, &size)) {
+        m_lastError = "Failed to open " + path;
+        Close();
+        return false;
+    }
+    m_size = static_cast<uint64_t>(size.QuadPart);
+    if (m_size == 0) {
+        m_lastError = path + " is empty";
+        Close();
+        return false;
+    }
+
+    m_section = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+    m_data = m_section ? static_cast<uint8_t*>(MapViewOfFile(m_section, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+    if (m_data == nullptr) {
+        m_lastError = "Failed to map " + path;
+        Close();
+        return false;
+    }
+    m_mappedSize = static_cast<size_t>(m_size);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    UnmapWindow();
+    if (m_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+    m_mappedSize = 0;
+    m_size = 0;
+}
+
+uint8_t* MappedFile::MapWindow(uint64_t offset, size_t size)
+{
+    UnmapWindow();
+    if (m_file == INVALID_HANDLE_VALUE || offset % MapGranularity() != 0) {
+        m_lastError = "Invalid file window";
+        return nullptr;
+    }
+
+    // A section larger than the file extends the file to the section size
+    LARGE_INTEGER current = {};
+    GetFileSizeEx(m_file, &current);
+    uint64_t end = std::max<uint64_t>(offset + size, static_cast<uint64_t>(current.QuadPart));
+    m_section = CreateFileMappingA(m_file, NULL, PAGE_READWRITE,
+                                   static_cast<DWORD>(end >> 32), static_cast<DWORD>(end & 0xFFFFFFFF), NULL);
+    if (m_section == NULL) {
+        m_lastError = "Failed to extend file";
+        return nullptr;
+    }
+    m_data = static_cast<uint8_t*>(MapViewOfFile(m_section, FILE_MAP_WRITE,
+                                                 static_cast<DWORD>(offset >> 32),
+                                                 static_cast<DWORD>(offset & 0xFFFFFFFF), size));
+    if (m_data == nullptr) {
+        m_lastError = "Failed to map file window";
+        CloseHandle(m_section);
+        m_section = NULL;
+        return nullptr;
+    }
+    m_mappedSize = size;
+    m_writable = true;
+    return m_data;
+}
+
+void MappedFile::UnmapWindow()
+{
+    if (m_data) {
+        // Queues the dirty pages of the whole window for writing, the lazy writer would trickle them out
+        if (m_writable) {
+            FlushViewOfFile(m_data, 0);
+        }
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+        m_mappedSize = 0;
+    }
+    m_writable = false;
+    if (m_section) {
+        CloseHandle(m_section);
+        m_section = NULL;
+    }
+}
+
+bool MappedFile::Truncate(uint64_t size)
+{
+    LARGE_INTEGER position = {};
+    position.QuadPart = static_cast<LONGLONG>(size);
+    if (m_file == INVALID_HANDLE_VALUE || m_section != NULL || !SetFilePointerEx(m_file, position, NULL, FILE_BEGIN) ||
+        !SetEndOfFile(m_file)) {
+        m_lastError = "Failed to truncate file";
+        return false;
+    }
+    return true;
+}
+
+size_t MappedFile::MapGranularity()
+{
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    return systemInfo.dwAllocationGranularity;
+}
+
+NamedMutex::NamedMutex()
+    : m_handle(NULL)
+{
+}
+
+NamedMutex::~NamedMutex()
+{
+    Close();
+}
+
+bool NamedMutex::Open(const std::string& name)
+{
+    Close();
+    m_handle = CreateMutexA(NULL, FALSE, name.c_str());
+    return m_handle != NULL;
+}
+
+void NamedMutex::Close()
+{
+    if (m_handle) {
+        CloseHandle(m_handle);
+        m_handle = NULL;
+    }
+}
+
+LockResult NamedMutex::Lock(uint32_t timeoutMs)
+{
+    switch (WaitForSingleObject(m_handle, timeoutMs)) {
+        case WAIT_OBJECT_0:
+            return LockResult::Acquired;
+        case WAIT_ABANDONED:
+            return LockResult::Abandoned;
+        default:
+            return LockResult::Timeout;
+    }
+}
+
+void NamedMutex::Unlock()
+{
+    ReleaseMutex(m_handle);
+}
+
+NamedEvent::NamedEvent()
+    : m_handle(NULL)
+{
+}
+
+NamedEvent::~NamedEvent()
+{
+    Close();
+}
+
+bool NamedEvent::Open(const std::string& name)
+{
+    Close();
+    m_handle = CreateEventA(NULL, FALSE, FALSE, name.c_str());
+    return m_handle != NULL;
+}
+
+void NamedEvent::Close()
+{
+    if (m_handle) {
+        CloseHandle(m_handle);
+        m_handle = NULL;
+    }
+}
+
+bool NamedEvent::IsOpen() const
+{
+    return m_handle != NULL;
+}
+
+void NamedEvent::Signal()
+{
+    SetEvent(m_handle);
+}
+
+bool NamedEvent::Wait(uint32_t timeoutMs)
+{
+    return WaitForSingleObject(m_handle, timeoutMs) == WAIT_OBJECT_0;
+}
+
+int NamedEvent::WaitAny(NamedEvent* const* events, size_t count, uint32_t timeoutMs)
+{
+    static_assert(kMaxWaitAnyEvents <= MAXIMUM_WAIT_OBJECTS, "WaitForMultipleObjects limit");
+    if (count > kMaxWaitAnyEvents) {
+        return -1;
+    }
+
+    HANDLE handles[kMaxWaitAnyEvents];
+    DWORD handleCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        handles[handleCount++] = events[i]->m_handle;
+    }
+
+    DWORD waitResult = WaitForMultipleObjects(handleCount, handles, FALSE, timeoutMs);
+    if (waitResult < WAIT_OBJECT_0 + handleCount) {
+        return static_cast<int>(waitResult - WAIT_OBJECT_0);
+    }
+    return -1;
+}
+
+ChildProcess::ChildProcess()
+    : m_exitCode(-1)
+    , m_process(NULL)
+{
+}
+
+ChildProcess::~ChildProcess()
+{
+    if (m_process) {
+        CloseHandle(m_process);
+    }
+}
+
+bool ChildProcess::Start(const std::vector<std::string>& args)
+{
+    char modulePath[MAX_PATH] = {};
+    GetModuleFileNameA(NULL, modulePath, MAX_PATH);
+
+    std::stringstream cmd;
+    cmd << "\"" << modulePath << "\"";
+    for (const std::string& arg : args) {
+        cmd << " \"" << arg << "\"";
+    }
+    std::string cmdLine = cmd.str();
+
+    STARTUPINFOA startupInfo = {};
+    startupInfo.cb = sizeof(startupInfo);
+    PROCESS_INFORMATION processInfo = {};
+    if (!CreateProcessA(NULL, &cmdLine[0], NULL, NULL, FALSE, 0, NULL, NULL, &startupInfo, &processInfo)) {
+        return false;
+    }
+    CloseHandle(processInfo.hThread);
+    m_process = processInfo.hProcess;
+    m_exitCode = -1;
+    return true;
+}
+
+bool ChildProcess::Wait(uint32_t timeoutMs)
+{
+    if (!m_process) {
+        return false;
+    }
+    if (WaitForSingleObject(m_process, timeoutMs) != WAIT_OBJECT_0) {
+        return false;
+    }
+    DWORD exitCode = STILL_ACTIVE;
+    GetExitCodeProcess(m_process, &exitCode);
+    m_exitCode = static_cast<int>(exitCode);
+    return true;
+}
+
+void ChildProcess::Terminate()
+{
+    if (m_process && m_exitCode < 0) {
+        TerminateProcess(m_process, 1);
+        Wait(INFINITE);
+    }
+}
+
+void RemoveSharedObject(const std::string& name)
+{
+    // Sections go away with their last handle
+    (void)name;
+}
+
+uint32_t CurrentProcessId()
+{
+    return GetCurrentProcessId();
+}
+
+int32_t CurrentNumaNode()
+{
+    // Processor numbers and node numbers of the first processor group only
+    BYTE node = 0;
+    if (!GetNumaProcessorNode(static_cast<BYTE>(GetCurrentProcessorNumber()), &node)) {
+        return 0;
+    }
+    return node;
+}
+
+bool ProcessExited(uint32_t processId)
+{
+    HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, processId);
+    if (process == NULL) {
+        // Access denied means the process exists but belongs to someone else
+        return ::GetLastError() == ERROR_INVALID_PARAMETER;
+    }
+    bool exited = WaitForSingleObject(process, 0) == WAIT_OBJECT_0;
+    CloseHandle(process);
+    return exited;
+}
+
+bool PinCurrentThread(uint32_t cpu)
+{
+    // The affinity mask covers the first processor group only
+    if (cpu >= 64) {
+        return false;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu) != 0;
+}
+
+} // namespace SharedMemory
+
+#endif // _WIN32
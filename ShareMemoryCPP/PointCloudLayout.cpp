@@ -0,0 +1,272 @@
+/**
+ * @file PointCloudLayout.cpp
+ * @brief 结构化点云字段布局的实现
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#include "PointCloudLayout.h"
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+namespace SharedMemory {
+
+namespace {
+
+    size_t AlignField(size_t value)
+    {
+        return (value + kPointFieldAlignment - 1) & ~(kPointFieldAlignment - 1);
+    }
+
+    size_t FieldBytes(const PointField& field, uint32_t pointCount)
+    {
+        return static_cast<size_t>(pointCount) * field.Components *
+               PointFieldTypeSize(static_cast<PointFieldType>(field.Type));
+    }
+
+    template <typename T>
+    T Quantize(float value, float scale, float bias)
+    {
+        float raw = std::round((value - bias) / scale);
+        // Saturate instead of wrapping, NaN maps to 0
+        if (!(raw >= static_cast<float>(std::numeric_limits<T>::lowest()))) {
+            return raw != raw ? T(0) : std::numeric_limits<T>::lowest();
+        }
+        if (raw >= static_cast<float>(std::numeric_limits<T>::max())) {
+            return std::numeric_limits<T>::max();
+        }
+        return static_cast<T>(raw);
+    }
+
+    template <typename T>
+    void EncodeAs(const float* values, size_t valueStride, uint32_t count, uint8_t* dst, size_t stride,
+                  float scale, float bias)
+    {
+        for (uint32_t i = 0; i < count; ++i) {
+            T raw = std::numeric_limits<T>::is_integer ? Quantize<T>(values[i * valueStride], scale, bias)
+                                                       : static_cast<T>((values[i * valueStride] - bias) / scale);
+            memcpy(dst + i * stride, &raw, sizeof(T));
+        }
+    }
+
+    template <typename T>
+    void DecodeAs(const uint8_t* src, size_t stride, uint32_t count, float* out, float scale, float bias)
+    {
+        // Byte-wise loads keep interleaved and unaligned fields legal; packed arrays still vectorize
+        for (uint32_t i = 0; i < count; ++i) {
+            T raw;
+            memcpy(&raw, src + i * stride, sizeof(T));
+            out[i] = static_cast<float>(raw) * scale + bias;
+        }
+    }
+
+} // namespace
+
+size_t PointFieldTypeSize(PointFieldType type)
+{
+    switch (type) {
+        case PointFieldType::Float32: return 4;
+        case PointFieldType::Float64: return 8;
+        case PointFieldType::Int8: return 1;
+        case PointFieldType::UInt8: return 1;
+        case PointFieldType::Int16: return 2;
+        case PointFieldType::UInt16: return 2;
+        case PointFieldType::Int32: return 4;
+        case PointFieldType::UInt32: return 4;
+    }
+    return 0;
+}
+
+bool PointCloudLayout::Add(const std::string& name, PointFieldType type, uint32_t components, float scale, float bias)
+{
+    if (name.empty() || name.size() >= kPointFieldNameSize || components == 0 || scale == 0.0f ||
+        PointFieldTypeSize(type) == 0 || m_fields.size() >= kMaxPointFields || Find(name) >= 0) {
+        return false;
+    }
+
+    PointField field;
+    memset(&field, 0, sizeof(field));
+    memcpy(field.Name, name.data(), name.size());
+    field.Type = static_cast<uint32_t>(type);
+    field.Components = components;
+    field.Stride = static_cast<uint32_t>(PointFieldTypeSize(type) * components);
+    field.Scale = scale;
+    field.Bias = bias;
+    m_fields.push_back(field);
+    return true;
+}
+
+PointCloudLayout PointCloudLayout::Xyz()
+{
+    PointCloudLayout layout;
+    layout.Add("x", PointFieldType::Float32);
+    layout.Add("y", PointFieldType::Float32);
+    layout.Add("z", PointFieldType::Float32);
+    return layout;
+}
+
+PointCloudLayout PointCloudLayout::QuantizedXyz(float scale)
+{
+    PointCloudLayout layout;
+    layout.Add("x", PointFieldType::Int16, 1, scale);
+    layout.Add("y", PointFieldType::Int16, 1, scale);
+    layout.Add("z", PointFieldType::Int16, 1, scale);
+    return layout;
+}
+
+int32_t PointCloudLayout::Find(const std::string& name) const
+{
+    for (size_t i = 0; i < m_fields.size(); ++i) {
+        if (name == m_fields[i].Name) {
+            return static_cast<int32_t>(i);
+        }
+    }
+    return -1;
+}
+
+size_t PointCloudLayout::FieldOffset(uint32_t index, uint32_t pointCount) const
+{
+    size_t offset = sizeof(PointCloudHeader) + sizeof(PointField) * m_fields.size();
+    for (uint32_t i = 0; i < index; ++i) {
+        offset = AlignField(offset) + FieldBytes(m_fields[i], pointCount);
+    }
+    return AlignField(offset);
+}
+
+size_t PointCloudLayout::FrameSize(uint32_t pointCount) const
+{
+    if (m_fields.empty()) {
+        return sizeof(PointCloudHeader);
+    }
+    uint32_t last = FieldCount() - 1;
+    return FieldOffset(last, pointCount) + FieldBytes(m_fields[last], pointCount);
+}
+
+void PointCloudLayout::WriteDirectory(uint8_t* frame, uint32_t pointCount) const
+{
+    size_t tableSize = sizeof(PointCloudHeader) + sizeof(PointField) * m_fields.size();
+    memset(frame, 0, tableSize);
+
+    PointCloudHeader* header = reinterpret_cast<PointCloudHeader*>(frame);
+    header->Magic = kPointCloudMagic;
+    header->FieldCount = FieldCount();
+    header->PointCount = pointCount;
+
+    PointField* fields = reinterpret_cast<PointField*>(header + 1);
+    size_t offset = tableSize;
+    for (size_t i = 0; i < m_fields.size(); ++i) {
+        size_t aligned = AlignField(offset);
+        memset(frame + offset, 0, aligned - offset);
+        fields[i] = m_fields[i];
+        fields[i].Offset = aligned;
+        offset = aligned + FieldBytes(m_fields[i], pointCount);
+    }
+}
+
+bool PointCloudFields::Parse(const uint8_t* data, size_t size, uint64_t frameId)
+{
+    m_data = nullptr;
+    m_fieldCount = 0;
+    m_pointCount = 0;
+    m_frameId = frameId;
+    if (!data || size < sizeof(PointCloudHeader)) {
+        return false;
+    }
+
+    const PointCloudHeader* header = reinterpret_cast<const PointCloudHeader*>(data);
+    if (header->Magic != kPointCloudMagic || header->FieldCount > kMaxPointFields ||
+        size < sizeof(PointCloudHeader) + sizeof(PointField) * header->FieldCount) {
+        return false;
+    }
+
+    // 64-bit arithmetic: the last point's end cannot overflow for 32-bit counts and strides
+    const PointField* fields = reinterpret_cast<const PointField*>(header + 1);
+    for (uint32_t i = 0; i < header->FieldCount; ++i) {
+        const PointField& field = fields[i];
+        uint64_t elementSize = PointFieldTypeSize(static_cast<PointFieldType>(field.Type));
+        uint64_t pointBytes = elementSize * field.Components;
+        if (elementSize == 0 || field.Components == 0 || field.Scale == 0.0f ||
+            field.Name[kPointFieldNameSize - 1] != '\0' || field.Stride < pointBytes || field.Offset > size) {
+            return false;
+        }
+        if (header->PointCount > 0 &&
+            static_cast<uint64_t>(header->PointCount - 1) * field.Stride + pointBytes > size - field.Offset) {
+            return false;
+        }
+    }
+
+    m_data = data;
+    m_fieldCount = header->FieldCount;
+    m_pointCount = header->PointCount;
+    return true;
+}
+
+int32_t PointCloudFields::Find(const char* name) const
+{
+    for (uint32_t i = 0; i < m_fieldCount; ++i) {
+        if (strcmp(Fields()[i].Name, name) == 0) {
+            return static_cast<int32_t>(i);
+        }
+    }
+    return -1;
+}
+
+const float* PointCloudFields::Floats(uint32_t index) const
+{
+    if (index >= m_fieldCount) {
+        return nullptr;
+    }
+    const PointField& field = Fields()[index];
+    if (field.Type != static_cast<uint32_t>(PointFieldType::Float32) || field.Components != 1 ||
+        field.Stride != sizeof(float) || field.Scale != 1.0f || field.Bias != 0.0f ||
+        reinterpret_cast<uintptr_t>(FieldData(index)) % alignof(float) != 0) {
+        return nullptr;
+    }
+    return reinterpret_cast<const float*>(FieldData(index));
+}
+
+bool PointCloudFields::Decode(uint32_t index, uint32_t component, float* out) const
+{
+    if (index >= m_fieldCount || component >= Fields()[index].Components) {
+        return false;
+    }
+    DecodePointField(Fields()[index], component, FieldData(index), m_pointCount, out);
+    return true;
+}
+
+void EncodePointField(const PointField& field, uint32_t component, const float* values, size_t valueStride,
+                      uint32_t count, uint8_t* fieldData)
+{
+    PointFieldType type = static_cast<PointFieldType>(field.Type);
+    uint8_t* dst = fieldData + component * PointFieldTypeSize(type);
+    switch (type) {
+        case PointFieldType::Float32: EncodeAs<float>(values, valueStride, count, dst, field.Stride, field.Scale, field.Bias); break;
+        case PointFieldType::Float64: EncodeAs<double>(values, valueStride, count, dst, field.Stride, field.Scale, field.Bias); break;
+        case PointFieldType::Int8: EncodeAs<int8_t>(values, valueStride, count, dst, field.Stride, field.Scale, field.Bias); break;
+        case PointFieldType::UInt8: EncodeAs<uint8_t>(values, valueStride, count, dst, field.Stride, field.Scale, field.Bias); break;
+        case PointFieldType::Int16: EncodeAs<int16_t>(values, valueStride, count, dst, field.Stride, field.Scale, field.Bias); break;
+        case PointFieldType::UInt16: EncodeAs<uint16_t>(values, valueStride, count, dst, field.Stride, field.Scale, field.Bias); break;
+        case PointFieldType::Int32: EncodeAs<int32_t>(values, valueStride, count, dst, field.Stride, field.Scale, field.Bias); break;
+        case PointFieldType::UInt32: EncodeAs<uint32_t>(values, valueStride, count, dst, field.Stride, field.Scale, field.Bias); break;
+    }
+}
+
+void DecodePointField(const PointField& field, uint32_t component, const uint8_t* fieldData,
+                      uint32_t count, float* out)
+{
+    PointFieldType type = static_cast<PointFieldType>(field.Type);
+    const uint8_t* src = fieldData + component * PointFieldTypeSize(type);
+    switch (type) {
+        case PointFieldType::Float32: DecodeAs<float>(src, field.Stride, count, out, field.Scale, field.Bias); break;
+        case PointFieldType::Float64: DecodeAs<double>(src, field.Stride, count, out, field.Scale, field.Bias); break;
+        case PointFieldType::Int8: DecodeAs<int8_t>(src, field.Stride, count, out, field.Scale, field.Bias); break;
+        case PointFieldType::UInt8: DecodeAs<uint8_t>(src, field.Stride, count, out, field.Scale, field.Bias); break;
+        case PointFieldType::Int16: DecodeAs<int16_t>(src, field.Stride, count, out, field.Scale, field.Bias); break;
+        case PointFieldType::UInt16: DecodeAs<uint16_t>(src, field.Stride, count, out, field.Scale, field.Bias); break;
+        case PointFieldType::Int32: DecodeAs<int32_t>(src, field.Stride, count, out, field.Scale, field.Bias); break;
+        case PointFieldType::UInt32: DecodeAs<uint32_t>(src, field.Stride, count, out, field.Scale, field.Bias); break;
+    }
+}
+
+} // namespace SharedMemory
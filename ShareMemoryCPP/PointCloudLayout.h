@@ -0,0 +1,184 @@
+/**
+ * @file PointCloudLayout.h
+ * @brief 结构化点云的字段布局：按字段分开存放的数组（SoA）、附加属性和量化坐标
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace SharedMemory {
+
+    const uint32_t kPointCloudMagic = 0x44435450;  ///< 'PTCD'
+    const uint32_t kMaxPointFields = 16;           ///< 一帧点云中的最大字段数
+    const size_t kPointFieldNameSize = 16;         ///< 字段名缓冲区大小，含结尾的0
+    const size_t kPointFieldAlignment = 64;        ///< 字段数组的对齐粒度，与 kCacheLineSize 相同
+
+    /**
+     * @brief 点云字段的分量类型
+     */
+    enum class PointFieldType : uint32_t {
+        Float32 = 0,
+        Float64 = 1,
+        Int8 = 2,
+        UInt8 = 3,
+        Int16 = 4,    ///< 常用于量化坐标
+        UInt16 = 5,
+        Int32 = 6,
+        UInt32 = 7
+    };
+
+    /**
+     * @brief 分量类型的字节数，未知类型返回0
+     */
+    size_t PointFieldTypeSize(PointFieldType type);
+
+    /**
+     * @brief 结构化点云的数据格式：PointCloudHeader | PointField x FieldCount | 各字段数组（每个数组按缓存行对齐）
+     *
+     * 第 i 个点的第 c 个分量位于 Offset + i * Stride + c * 分量大小，解码值为 原始值 * Scale + Bias。
+     * PointCloudLayout 写出的每个字段都是紧密排列的数组，其他写入方也可以用 Offset/Stride 描述交错存储的字段。
+     */
+    #pragma pack(push, 1)
+    struct PointCloudHeader {
+        uint32_t Magic;                 ///< kPointCloudMagic
+        uint32_t FieldCount;            ///< 字段数
+        uint32_t PointCount;            ///< 点数
+        uint8_t Reserved[kPointFieldAlignment - 12];
+    };
+
+    struct PointField {
+        char Name[kPointFieldNameSize]; ///< 字段名，以0结尾，如 "x"、"intensity"、"normal"
+        uint32_t Type;                  ///< 分量类型，来自 PointFieldType 枚举
+        uint32_t Components;            ///< 每个点的分量数，如法向量为3
+        uint64_t Offset;                ///< 第0个点的数据相对帧起始处的偏移
+        uint32_t Stride;                ///< 相邻两个点之间的字节数
+        float Scale;                    ///< 量化比例，解码值 = 原始值 * Scale + Bias
+        float Bias;                     ///< 量化偏移
+        uint8_t Reserved[kPointFieldAlignment - 44];
+    };
+    #pragma pack(pop)
+
+    static_assert(sizeof(PointCloudHeader) == kPointFieldAlignment, "point fields must start on a cache line");
+    static_assert(sizeof(PointField) == kPointFieldAlignment, "each point field must own one cache line");
+
+    /**
+     * @brief 结构化点云的字段列表，生产者据此分配帧并写入字段目录
+     *
+     * 字段按添加顺序排列，每个字段是一个 PointCount * Components 个分量的紧密数组，
+     * 数组起始地址按缓存行对齐，消费者可以直接做向量化处理而不需要先转置。
+     */
+    class PointCloudLayout {
+    public:
+        /**
+         * @brief 追加一个字段
+         * @param scale 整数类型的量化比例，浮点类型通常为1
+         * @return 名称为空、过长或重复，分量数为0，scale为0或字段数已满时返回 false
+         */
+        bool Add(const std::string& name, PointFieldType type, uint32_t components = 1,
+                 float scale = 1.0f, float bias = 0.0f);
+
+        /**
+         * @brief x、y、z 三个32位浮点字段
+         */
+        static PointCloudLayout Xyz();
+
+        /**
+         * @brief x、y、z 三个16位定点字段，可表示的坐标范围为 ±32767 * scale
+         */
+        static PointCloudLayout QuantizedXyz(float scale);
+
+        uint32_t FieldCount() const { return static_cast<uint32_t>(m_fields.size()); }
+        const PointField& Field(uint32_t index) const { return m_fields[index]; }
+
+        /**
+         * @brief 按名称查找字段
+         * @return 字段索引，不存在时返回-1
+         */
+        int32_t Find(const std::string& name) const;
+
+        /**
+         * @brief 第 index 个字段数组相对帧起始处的偏移
+         */
+        size_t FieldOffset(uint32_t index, uint32_t pointCount) const;
+
+        /**
+         * @brief 一帧的总大小，含头部、字段目录和对齐填充
+         */
+        size_t FrameSize(uint32_t pointCount) const;
+
+        /**
+         * @brief 写入头部和字段目录，并把字段数组之间的对齐间隙填0
+         * @param frame 至少 FrameSize(pointCount) 字节
+         */
+        void WriteDirectory(uint8_t* frame, uint32_t pointCount) const;
+
+    private:
+        std::vector<PointField> m_fields;   ///< Offset 和 Stride 在 WriteDirectory 时按点数填写
+    };
+
+    /**
+     * @brief 结构化点云的只读解析结果，不拷贝数据，有效期与被解析的缓冲区相同
+     */
+    class PointCloudFields {
+    public:
+        PointCloudFields() : m_data(nullptr), m_fieldCount(0), m_pointCount(0), m_frameId(0) {}
+
+        /**
+         * @brief 解析并校验字段目录，所有字段的数据都必须落在 size 范围内
+         * @return 数据不是合法的结构化点云时返回 false
+         */
+        bool Parse(const uint8_t* data, size_t size, uint64_t frameId = 0);
+
+        uint32_t FieldCount() const { return m_fieldCount; }
+        uint32_t PointCount() const { return m_pointCount; }
+        uint64_t FrameId() const { return m_frameId; }
+        const PointField& Field(uint32_t index) const { return Fields()[index]; }
+        const uint8_t* FieldData(uint32_t index) const { return m_data + Fields()[index].Offset; }
+
+        /**
+         * @brief 按名称查找字段
+         * @return 字段索引，不存在时返回-1
+         */
+        int32_t Find(const char* name) const;
+
+        /**
+         * @brief 字段为紧密排列、未量化的单分量32位浮点数组时直接返回其地址，否则返回 nullptr
+         */
+        const float* Floats(uint32_t index) const;
+
+        /**
+         * @brief 把字段的第 component 个分量解码为浮点数
+         * @param out 至少 PointCount() 个浮点数
+         */
+        bool Decode(uint32_t index, uint32_t component, float* out) const;
+
+    private:
+        const uint8_t* m_data;
+        uint32_t m_fieldCount;
+        uint32_t m_pointCount;
+        uint64_t m_frameId;
+
+        const PointField* Fields() const { return reinterpret_cast<const PointField*>(m_data + sizeof(PointCloudHeader)); }
+    };
+
+    /**
+     * @brief 把 count 个浮点数按字段的类型和量化参数编码到字段的第 component 个分量，整数类型四舍五入并饱和
+     * @param valueStride values 中相邻两个值之间的浮点数个数，交错的 XYZ 源数据为3
+     * @param fieldData 字段第0个点的地址（帧起始处加 Offset）
+     */
+    void EncodePointField(const PointField& field, uint32_t component, const float* values, size_t valueStride,
+                          uint32_t count, uint8_t* fieldData);
+
+    /**
+     * @brief EncodePointField 的逆操作，把字段的第 component 个分量解码为 count 个浮点数
+     */
+    void DecodePointField(const PointField& field, uint32_t component, const uint8_t* fieldData,
+                          uint32_t count, float* out);
+
+} // namespace SharedMemory
@@ -15,6 +15,9 @@
 #include <thread>
 #include <chrono>
 #include "ShareMemoryManager.h"
+#include "Benchmark.h"
+#include "TypedFrames.h"
+#include "FrameTrace.h"
 #include <cmath>
 
 using namespace SharedMemory;
@@ -60,15 +63,13 @@ std::vector<uint8_t> GenerateTestPointCloud(int numPoints)
 }
 
 /**
- * @brief Generate test height map data
+ * @brief Generate test height map data in place
+ * @param heightData Output buffer of width * height floats (e.g. from BeginWrite)
  * @param width Number of points in width direction
  * @param height Number of points in height direction
- * @return Array of height values (z value for each point)
  */
-std::vector<float> GenerateTestHeightMap(uint32_t width, uint32_t height)
+void GenerateTestHeightMap(float* heightData, uint32_t width, uint32_t height)
 {
-    std::vector<float> heightData(width * height);
-    
     // Generate terrain with multiple sine waves
     const float frequency1 = 2.0f * 3.14159f / width;   // Frequency in X direction
     const float frequency2 = 2.0f * 3.14159f / height;  // Frequency in Y direction
@@ -95,22 +96,44 @@ std::vector<float> GenerateTestHeightMap(uint32_t width, uint32_t height)
             heightData[y * width + x] = z;
         }
     }
-    
+}
+
+/**
+ * @brief Generate test height map data
+ * @param width Number of points in width direction
+ * @param height Number of points in height direction
+ * @return Array of height values (z value for each point)
+ */
+std::vector<float> GenerateTestHeightMap(uint32_t width, uint32_t height)
+{
+    std::vector<float> heightData(width * height);
+    GenerateTestHeightMap(heightData.data(), width, height);
     return heightData;
 }
 
-int main()
+/**
+ * @brief Original producer/consumer demo, sends 10 frames paced by the consumer
+ * @param tracePath Chrome trace file to write the per-stage timings to, empty to disable tracing
+ * @return Process exit code
+ */
+int RunDemo(const std::string& tracePath)
 {
     try
     {
         std::cout << "Shared Memory Test Program Starting..." << std::endl;
+        if (!tracePath.empty()) {
+            FrameTrace::Start();
+        }
         
         // Create shared memory manager
         const std::string memoryName = "TestSharedMemory";
         const size_t memorySize = 1024 * 1024 * 10; // 10MB
         
-        // Create producer
-        ShareMemoryManager producer(memoryName, memorySize);
+        // Create producer, each write waits until the consumer has taken the previous frame
+        ShareMemoryConfig producerConfig;
+        producerConfig.writePolicy = WritePolicy::Wait;
+        producerConfig.writeTimeoutMs = 1000;
+        ShareMemoryManager producer(memoryName, memorySize, producerConfig);
         if (!producer.Initialize())
         {
             std::cerr << "Failed to initialize producer shared memory" << std::endl;
@@ -129,7 +152,8 @@ int main()
         consumer.SetDataReceivedCallback([](const uint8_t* data, size_t size, uint32_t dataType, uint32_t width, uint32_t height) {
             std::cout << "\n[Consumer] Received data:"
                      << "\n - Type: " << (dataType == static_cast<uint32_t>(FrameType::HEIGHTMAP) ? "HeightMap" : 
-                                        (dataType == static_cast<uint32_t>(FrameType::IMAGE) ? "Image" : "PointCloud"))
+                                        (dataType == static_cast<uint32_t>(FrameType::IMAGE) ? "Image" :
+                                        (dataType == static_cast<uint32_t>(FrameType::POINTFIELDS) ? "PointFields" : "PointCloud")))
                      << "\n - Size: " << size << " bytes"
                      << "\n - Width: " << width
                      << "\n - Height: " << height
@@ -146,6 +170,33 @@ int main()
                 }
                 std::cout << " - Height range: [" << minHeight << ", " << maxHeight << "]" << std::endl;
             }
+            else if (dataType == static_cast<uint32_t>(FrameType::POINTFIELDS)) {
+                // Each field is its own array, quantized ones are decoded on the way out
+                PointCloudFields cloud;
+                if (cloud.Parse(data, size)) {
+                    std::vector<float> values(cloud.PointCount());
+                    for (uint32_t i = 0; i < cloud.FieldCount(); ++i) {
+                        const PointField& field = cloud.Field(i);
+                        std::cout << " - Field " << field.Name << ": type " << field.Type
+                                  << ", scale " << field.Scale;
+                        if (cloud.PointCount() > 0 && cloud.Decode(i, 0, values.data())) {
+                            std::cout << ", first value " << values[0];
+                        }
+                        std::cout << std::endl;
+                    }
+                }
+            }
+        });
+
+        // Synchronized captures arrive as one callback
+        consumer.SetBundleReceivedCallback([](const FrameBundle& bundle) {
+            std::cout << "\n[Consumer] Received bundle:"
+                     << "\n - Frame ID: " << bundle.FrameId()
+                     << "\n - Frames: " << bundle.Count() << std::endl;
+            for (uint32_t i = 0; i < bundle.Count(); ++i) {
+                std::cout << " - [" << i << "] Type: " << bundle.Info(i).dataType
+                         << ", Size: " << bundle.Size(i) << " bytes" << std::endl;
+            }
         });
 
         // Start consumer monitoring
@@ -159,6 +210,7 @@ int main()
         while (frameCount < totalFrames)
         {
             std::vector<uint8_t> data;
+            bool writeSuccess = false;
             DataInfo info = {};
             info.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
                 std::chrono::system_clock::now().time_since_epoch()
@@ -172,6 +224,7 @@ int main()
                 info.dataType = static_cast<uint32_t>(FrameType::IMAGE);
                 data = GenerateTestImage(info.width, info.height, info.channels);
                 std::cout << "Preparing to write RGB image data..." << std::endl;
+                writeSuccess = producer.WriteData(data.data(), data.size(), info);
             } 
             else if (frameCount % 3 == 1) {  // Send point cloud data every three frames
                 // Generate point cloud with 1000 points
@@ -180,6 +233,7 @@ int main()
                 info.dataType = static_cast<uint32_t>(FrameType::POINTCLOUD);
                 data = GenerateTestPointCloud(info.width);
                 std::cout << "Preparing to write XYZ point cloud data..." << std::endl;
+                writeSuccess = producer.WriteData(data.data(), data.size(), info);
             }
             else {  // Send height map data every three frames
                 // Generate 200x200 height map
@@ -188,28 +242,107 @@ int main()
                 info.xSpacing = 0.1f;
                 info.ySpacing = 0.1f;
                 info.dataType = static_cast<uint32_t>(FrameType::HEIGHTMAP);
-                
-                std::vector<float> heightData = GenerateTestHeightMap(info.width, info.height);
-                
-                // Convert to byte data
-                data.resize(heightData.size() * sizeof(float));
-                memcpy(data.data(), heightData.data(), data.size());
                 std::cout << "Preparing to write height map data..." << std::endl;
+
+                // Generate the height map directly into shared memory
+                HeightMapFrame shape;
+                shape.width = info.width;
+                shape.height = info.height;
+                shape.xSpacing = info.xSpacing;
+                shape.ySpacing = info.ySpacing;
+                shape.timestamp = info.timestamp;
+                Publisher<HeightMapFrame> heightMapPublisher(producer);
+                float* heights = heightMapPublisher.BeginFrame(shape);
+                if (heights) {
+                    GenerateTestHeightMap(heights, shape.width, shape.height);
+                    writeSuccess = heightMapPublisher.CommitFrame(shape);
+                }
             }
 
-            // Write data
-            bool writeSuccess = producer.WriteData(data.data(), data.size(), info);
-            
             if (writeSuccess) {
                 frameCount++;
             }
-            
-            // Wait before next frame
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
         }
 
+        // Send one capture of all three types as a bundle: one slot, one frame ID, one checksum
+        {
+            std::vector<uint8_t> image = GenerateTestImage(640, 480, 3);
+            std::vector<uint8_t> pointCloud = GenerateTestPointCloud(1000);
+            std::vector<float> heightMap = GenerateTestHeightMap(200, 200);
+            uint64_t timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()
+            ).count();
+
+            std::vector<BundleFrame> frames(3);
+            frames[0].data = image.data();
+            frames[0].size = image.size();
+            frames[0].info.width = 640;
+            frames[0].info.height = 480;
+            frames[0].info.channels = 3;
+            frames[0].info.dataType = static_cast<uint32_t>(FrameType::IMAGE);
+            frames[1].data = pointCloud.data();
+            frames[1].size = pointCloud.size();
+            frames[1].info.width = 1000;
+            frames[1].info.height = 3;
+            frames[1].info.dataType = static_cast<uint32_t>(FrameType::POINTCLOUD);
+            frames[2].data = reinterpret_cast<const uint8_t*>(heightMap.data());
+            frames[2].size = heightMap.size() * sizeof(float);
+            frames[2].info.width = 200;
+            frames[2].info.height = 200;
+            frames[2].info.xSpacing = 0.1f;
+            frames[2].info.ySpacing = 0.1f;
+            frames[2].info.dataType = static_cast<uint32_t>(FrameType::HEIGHTMAP);
+            for (BundleFrame& frame : frames) {
+                frame.info.timestamp = timestamp;
+            }
+
+            std::cout << "Preparing to write RGB + point cloud + height map bundle..." << std::endl;
+            producer.WriteBundle(frames);
+        }
+
+        // Send the same kind of cloud as separate x/y/z arrays with 1mm fixed point coordinates and an intensity
+        {
+            const uint32_t pointCount = 1000;
+            std::vector<uint8_t> xyz = GenerateTestPointCloud(pointCount);
+            const float* points = reinterpret_cast<const float*>(xyz.data());
+
+            PointCloudLayout layout = PointCloudLayout::QuantizedXyz(0.001f);
+            layout.Add("intensity", PointFieldType::UInt8);
+
+            std::cout << "Preparing to write quantized SoA point cloud data..." << std::endl;
+            std::vector<uint8_t*> fields;
+            if (producer.BeginPointCloud(layout, pointCount, fields)) {
+                for (uint32_t axis = 0; axis < 3; ++axis) {
+                    EncodePointField(layout.Field(axis), 0, points + axis, 3, pointCount, fields[axis]);
+                }
+                for (uint32_t i = 0; i < pointCount; ++i) {
+                    fields[3][i] = static_cast<uint8_t>(i);
+                }
+                uint64_t timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()
+                ).count();
+                producer.CommitPointCloud(layout, pointCount, timestamp);
+            }
+        }
+
+        // Let the consumer take the last frame before it stops
+        producer.WaitForWritable(1000);
+        ShareMemoryStatistics stats = producer.GetStatistics();
+        std::cout << "Producer waited " << stats.throttledNs / 1000000 << " ms for the consumer over "
+                  << stats.throttledWrites << " writes" << std::endl;
+
         // Stop consumer monitoring
         consumer.StopMonitoring();
+
+        if (!tracePath.empty()) {
+            FrameTrace::Stop();
+            if (FrameTrace::WriteChromeTrace(tracePath)) {
+                std::cout << "Trace written to " << tracePath << std::endl;
+            }
+            else {
+                std::cerr << "Failed to write trace " << tracePath << std::endl;
+            }
+        }
         
         std::cout << "Test completed successfully." << std::endl;
     }
@@ -222,6 +355,39 @@ int main()
     return 0;
 }
 
+int main(int argc, char* argv[])
+{
+    try
+    {
+        if (argc > 1 && std::string(argv[1]) == "--bench-consumer") {
+            // Consumer half of a cross-process benchmark case
+            return Benchmark::RunConsumerProcess(argc, argv);
+        }
+        if (argc > 1 && std::string(argv[1]) == "--demo") {
+            // --demo [--trace <file>]
+            std::string tracePath;
+            if (argc > 3 && std::string(argv[2]) == "--trace") {
+                tracePath = argv[3];
+            }
+            return RunDemo(tracePath);
+        }
+
+        BenchmarkOptions options;
+        if (!Benchmark::ParseArguments(argc, argv, options)) {
+            Benchmark::PrintUsage();
+            return 2;
+        }
+
+        Benchmark benchmark(options);
+        return benchmark.Run();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Program exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
 // 运行程序: Ctrl + F5 或调试 >"开始执行(不调试)"菜单
 // 调试程序: F5 或调试 >"开始调试"菜单
 
@@ -6,10 +6,11 @@
  */
 
 #include "ShareMemoryManager.h"
-#include <iostream>
-#include <fstream>
+#include "FrameWorkerPool.h"
+#include "FrameTrace.h"
 #include <sstream>
-#include <iomanip>
+#include <cstring>
+#include <algorithm>
 #include <chrono>
 #include <vector>
 #include <thread>
@@ -17,301 +18,2993 @@
 
 namespace SharedMemory {
 
-ShareMemoryManager::ShareMemoryManager(const std::string& name, size_t size)
+namespace {
+
+    constexpr size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    // Header | statistics | mode specific control block | slot descriptors | page aligned payload
+    const size_t kStatsOffset = sizeof(SharedMemoryHeader);
+    const size_t kControlOffset = kStatsOffset + sizeof(SharedMemoryStats);
+
+    uint64_t NowNs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    uint32_t LatencyBucket(uint64_t latencyNs)
+    {
+        uint64_t micros = latencyNs / 1000;
+        uint32_t bucket = 0;
+        while (micros != 0 && bucket < kLatencyBucketCount - 1) {
+            micros >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    // ReaderEntry::State values
+    const uint32_t kReaderFree = 0;
+    const uint32_t kReaderClaiming = 1;
+    const uint32_t kReaderActive = 2;
+
+    // A latest-only reader may lose the race against the producer a few times in a row
+    const int kBroadcastPinRetries = 3;
+
+    const uint32_t kMaxBroadcastReaders = 64;
+
+    // A peer that read or wrote this recently is alive, no need to ask the OS
+    const uint64_t kHeartbeatGraceNs = 10ull * 1000 * 1000;
+
+    bool FrameIdBefore(uint64_t a, uint64_t b)
+    {
+        return a < b;
+    }
+
+    // Structured point clouds: width = points, height = fields
+    DataInfo PointCloudInfo(const PointCloudLayout& layout, uint32_t pointCount, uint64_t timestamp)
+    {
+        DataInfo info = {};
+        info.width = pointCount;
+        info.height = layout.FieldCount();
+        info.dataType = static_cast<uint32_t>(FrameType::POINTFIELDS);
+        info.timestamp = timestamp;
+        return info;
+    }
+
+    // PoolSizeClass::FreeHead packs a change counter above the cache line number of the top block
+    uint64_t PackFreeHead(uint64_t previous, uint32_t link)
+    {
+        return (((previous >> 32) + 1) << 32) | link;
+    }
+
+    uint32_t FreeHeadLink(uint64_t head)
+    {
+        return static_cast<uint32_t>(head);
+    }
+
+    // Every region starts on its own cache line, the mapping itself is page aligned
+    static_assert(kControlOffset % kCacheLineSize == 0, "control blocks must start on a cache line");
+    static_assert(sizeof(RingControlBlock) % kCacheLineSize == 0, "slot descriptors must start on a cache line");
+    static_assert(sizeof(PoolControlBlock) % kCacheLineSize == 0, "block handles must start on a cache line");
+    static_assert(sizeof(BroadcastControlBlock) % kCacheLineSize == 0, "reader entries must start on a cache line");
+    static_assert(sizeof(ReaderEntry) == kCacheLineSize, "each reader must own exactly one cache line");
+    static_assert(sizeof(TripleBufferControlBlock) % kCacheLineSize == 0, "slot descriptors must start on a cache line");
+
+    const uint32_t kLegacyHeaderMagic = 0x12345678;
+
+} // namespace
+
+FrameView::FrameView()
+    : m_owner(nullptr)
+    , m_data(nullptr)
+    , m_size(0)
+    , m_info()
+    , m_frameId(0)
+    , m_slotIndex(0)
+{
+}
+
+FrameView::~FrameView()
+{
+    Release();
+}
+
+FrameView::FrameView(FrameView&& other) noexcept
+    : m_owner(other.m_owner)
+    , m_data(other.m_data)
+    , m_size(other.m_size)
+    , m_info(other.m_info)
+    , m_frameId(other.m_frameId)
+    , m_slotIndex(other.m_slotIndex)
+{
+    other.m_owner = nullptr;
+    other.m_data = nullptr;
+    other.m_size = 0;
+}
+
+FrameView& FrameView::operator=(FrameView&& other) noexcept
+{
+    if (this != &other) {
+        Release();
+        m_owner = other.m_owner;
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_info = other.m_info;
+        m_frameId = other.m_frameId;
+        m_slotIndex = other.m_slotIndex;
+        other.m_owner = nullptr;
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+void FrameView::Release()
+{
+    if (m_owner) {
+        m_owner->ReleaseView(*this);
+        m_owner = nullptr;
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
+
+bool FrameBundle::Parse(const uint8_t* data, size_t size, uint64_t frameId)
+{
+    m_data = nullptr;
+    m_count = 0;
+    m_frameId = frameId;
+    if (!data || size < sizeof(BundleHeader)) {
+        return false;
+    }
+
+    const BundleHeader* header = reinterpret_cast<const BundleHeader*>(data);
+    if (header->Magic != kBundleMagic || header->FrameCount > kMaxBundleFrames ||
+        size < sizeof(BundleHeader) + sizeof(BundleEntry) * header->FrameCount) {
+        return false;
+    }
+
+    const BundleEntry* entries = reinterpret_cast<const BundleEntry*>(header + 1);
+    for (uint32_t i = 0; i < header->FrameCount; ++i) {
+        if (entries[i].Offset > size || entries[i].Size > size - entries[i].Offset) {
+            return false;
+        }
+    }
+
+    m_data = data;
+    m_count = header->FrameCount;
+    return true;
+}
+
+size_t FrameView::RawSize() const
+{
+    return IsCompressed() ? DecompressedSize(m_data, m_size) : m_size;
+}
+
+bool FrameView::Decompress(uint8_t* dst, size_t capacity, DataInfo* info) const
+{
+    if (IsCompressed()) {
+        return DecompressFrame(m_data, m_size, dst, capacity, info);
+    }
+    if (!m_data || capacity < m_size) {
+        return false;
+    }
+    memcpy(dst, m_data, m_size);
+    if (info) {
+        *info = m_info;
+    }
+    return true;
+}
+
+size_t DecompressedSize(const uint8_t* data, size_t size)
+{
+    if (!data || size < sizeof(CompressedHeader)) {
+        return 0;
+    }
+    const CompressedHeader* header = reinterpret_cast<const CompressedHeader*>(data);
+    if (header->Magic != kCompressedMagic || header->StoredSize > size - sizeof(CompressedHeader)) {
+        return 0;
+    }
+    return static_cast<size_t>(header->RawSize);
+}
+
+bool DecompressFrame(const uint8_t* data, size_t size, uint8_t* dst, size_t capacity, DataInfo* info)
+{
+    size_t rawSize = DecompressedSize(data, size);
+    if (rawSize == 0 || rawSize > capacity) {
+        return false;
+    }
+    const CompressedHeader* header = reinterpret_cast<const CompressedHeader*>(data);
+    if (!CodecDecompress(static_cast<CompressionCodec>(header->Codec), data + sizeof(CompressedHeader),
+                         static_cast<size_t>(header->StoredSize), header->ElementSize, dst, rawSize)) {
+        return false;
+    }
+    if (info) {
+        *info = header->info;
+    }
+    return true;
+}
+
+bool DeltaFrame::Parse(const uint8_t* data, size_t size, uint64_t frameId)
+{
+    m_data = nullptr;
+    m_frameId = frameId;
+    if (!data || size < sizeof(DeltaHeader)) {
+        return false;
+    }
+
+    const DeltaHeader* header = reinterpret_cast<const DeltaHeader*>(data);
+    uint64_t pixels = static_cast<uint64_t>(header->info.width) * header->info.height;
+    if (header->Magic != kDeltaMagic || header->RegionCount > kMaxDeltaRegions || header->BytesPerPixel == 0 ||
+        header->FullSize != pixels * header->BytesPerPixel ||
+        size < sizeof(DeltaHeader) + sizeof(DeltaRegion) * header->RegionCount) {
+        return false;
+    }
+
+    // 64-bit arithmetic: none of the products below can overflow for 32-bit dimensions
+    const DeltaRegion* regions = reinterpret_cast<const DeltaRegion*>(header + 1);
+    for (uint32_t i = 0; i < header->RegionCount; ++i) {
+        const DeltaRegion& region = regions[i];
+        uint64_t bytes = static_cast<uint64_t>(region.Width) * region.Height * header->BytesPerPixel;
+        if (static_cast<uint64_t>(region.X) + region.Width > header->info.width ||
+            static_cast<uint64_t>(region.Y) + region.Height > header->info.height ||
+            region.Offset > size || bytes > size - region.Offset) {
+            return false;
+        }
+    }
+
+    m_data = data;
+    return true;
+}
+
+void DeltaFrame::ApplyTo(uint8_t* target) const
+{
+    const DeltaHeader& header = Header();
+    size_t pitch = static_cast<size_t>(header.info.width) * header.BytesPerPixel;
+    for (uint32_t i = 0; i < header.RegionCount; ++i) {
+        const DeltaRegion& region = Regions()[i];
+        size_t rowBytes = static_cast<size_t>(region.Width) * header.BytesPerPixel;
+        uint8_t* dst = target + region.Y * pitch + static_cast<size_t>(region.X) * header.BytesPerPixel;
+        const uint8_t* src = m_data + region.Offset;
+        if (rowBytes == pitch) {
+            memcpy(dst, src, rowBytes * region.Height);
+            continue;
+        }
+        for (uint32_t row = 0; row < region.Height; ++row) {
+            memcpy(dst + row * pitch, src + row * rowBytes, rowBytes);
+        }
+    }
+}
+
+DeltaResult PersistentFrame::Apply(const uint8_t* data, size_t size, const DataInfo& info, uint64_t frameId)
+{
+    if (info.dataType == static_cast<uint32_t>(FrameType::BUNDLE)) {
+        return DeltaResult::Ignored;
+    }
+
+    m_dirty.clear();
+    if (info.dataType == static_cast<uint32_t>(FrameType::COMPRESSED)) {
+        size_t rawSize = DecompressedSize(data, size);
+        std::vector<uint8_t> raw(rawSize);
+        DataInfo rawInfo;
+        if (rawSize == 0 || !DecompressFrame(data, size, raw.data(), raw.size(), &rawInfo)) {
+            return DeltaResult::Ignored;
+        }
+        m_data.swap(raw);
+        m_info = rawInfo;
+        m_frameId = frameId;
+        DirtyRect all;
+        all.height = rawInfo.height;
+        m_dirty.push_back(all);
+        return DeltaResult::Keyframe;
+    }
+    if (info.dataType != static_cast<uint32_t>(FrameType::DELTA)) {
+        m_data.assign(data, data + size);
+        m_info = info;
+        m_frameId = frameId;
+        DirtyRect all;
+        all.height = info.height;
+        m_dirty.push_back(all);
+        return DeltaResult::Keyframe;
+    }
+
+    DeltaFrame delta;
+    if (!delta.Parse(data, size, frameId)) {
+        return DeltaResult::Ignored;
+    }
+    if (m_frameId == 0 || delta.BaseFrameId() != m_frameId || delta.FullSize() != m_data.size()) {
+        return DeltaResult::OutOfSync;
+    }
+
+    delta.ApplyTo(m_data.data());
+    m_info = delta.Info();
+    m_frameId = frameId;
+    for (uint32_t i = 0; i < delta.Count(); ++i) {
+        const DeltaRegion& region = delta.Region(i);
+        DirtyRect rect;
+        rect.x = region.X;
+        rect.y = region.Y;
+        rect.width = region.Width;
+        rect.height = region.Height;
+        m_dirty.push_back(rect);
+    }
+    return DeltaResult::Applied;
+}
+
+DeltaResult PersistentFrame::Apply(const FrameView& view)
+{
+    return Apply(view.Data(), view.Size(), view.Info(), view.FrameId());
+}
+
+void PersistentFrame::Reset()
+{
+    m_data.clear();
+    m_info = DataInfo();
+    m_frameId = 0;
+    m_dirty.clear();
+}
+
+ShareMemoryManager::ShareMemoryManager(const std::string& name, size_t size, const ShareMemoryConfig& config)
     : m_name(name)
-    , m_size(size + sizeof(SharedMemoryHeader))
-    , m_hMapFile(NULL)
+    , m_config(config)
+    , m_logger(AsyncLogger::Get(config.logFilePath, config.logToConsole))
+    , m_frameLogCounter(0)
+    , m_capacity(size)
+    , m_slotStride(size)
+    , m_dataOffset(AlignUp(kControlOffset, kPayloadAlignment))
+    , m_size(AlignUp(kControlOffset, kPayloadAlignment) + size)
+    , m_ownsMapping(true)
     , m_pBuffer(nullptr)
     , m_pHeader(nullptr)
+    , m_pStats(nullptr)
+    , m_pRing(nullptr)
+    , m_pSlots(nullptr)
+    , m_pBroadcast(nullptr)
+    , m_pReaders(nullptr)
+    , m_pTriple(nullptr)
+    , m_pPool(nullptr)
+    , m_pPoolBlocks(nullptr)
+    , m_frontHeld(false)
     , m_pData(nullptr)
-    , m_hMutex(NULL)
     , m_frameId(0)
+    , m_readFrameId(0)
+    , m_processId(CurrentProcessId())
+    , m_traceChannel(FrameTrace::RegisterChannel(name))
+    , m_readerIndex(-1)
+    , m_readerEpoch(0)
+    , m_readerGeneration(0)
+    , m_deltaBaseId(0)
+    , m_deltaSize(0)
+    , m_deltaInfo()
+    , m_deltasSinceKeyframe(0)
+    , m_writePending(false)
+    , m_pendingSlot(0)
+    , m_pendingSize(0)
     , m_isMonitoring(false)
     , m_dataCallback(nullptr)
 {
+    if (IsPoolMode()) {
+        if (m_config.slotCount == 0) {
+            m_config.slotCount = 1;
+        }
+        // Layout: header | ring control block | slot descriptors | pool control block | block handles | frame pool
+        m_slotStride = AlignUp(size, kCacheLineSize);
+        if (m_config.poolBytes == 0) {
+            m_config.poolBytes = m_slotStride * m_config.slotCount;
+        }
+        m_config.poolBytes = AlignUp(std::max(m_config.poolBytes, std::max(m_slotStride, kCacheLineSize)), kCacheLineSize);
+        m_dataOffset = AlignUp(kControlOffset + sizeof(RingControlBlock) + sizeof(SlotDescriptor) * m_config.slotCount
+                               + sizeof(PoolControlBlock) + sizeof(uint64_t) * m_config.slotCount, kPayloadAlignment);
+        m_size = m_dataOffset + m_config.poolBytes;
+    }
+    else if (IsRingMode()) {
+        if (m_config.slotCount == 0) {
+            m_config.slotCount = 1;
+        }
+        // Layout: header | ring control block | slot descriptors | slot payloads
+        m_slotStride = AlignUp(size, kCacheLineSize);
+        m_dataOffset = AlignUp(kControlOffset + sizeof(RingControlBlock)
+                               + sizeof(SlotDescriptor) * m_config.slotCount, kPayloadAlignment);
+        m_size = m_dataOffset + m_slotStride * m_config.slotCount;
+    }
+    else if (IsBroadcastMode()) {
+        if (m_config.slotCount == 0) {
+            m_config.slotCount = 1;
+        }
+        if (m_config.maxReaders == 0) {
+            m_config.maxReaders = 1;
+        }
+        else if (m_config.maxReaders > kMaxBroadcastReaders) {
+            m_config.maxReaders = kMaxBroadcastReaders;
+        }
+        // Layout: header | broadcast control block | reader table | slot descriptors | slot payloads
+        m_slotStride = AlignUp(size, kCacheLineSize);
+        m_dataOffset = AlignUp(kControlOffset + sizeof(BroadcastControlBlock)
+                               + sizeof(ReaderEntry) * m_config.maxReaders
+                               + sizeof(SlotDescriptor) * m_config.slotCount, kPayloadAlignment);
+        m_size = m_dataOffset + m_slotStride * m_config.slotCount;
+        m_readerEvents.resize(m_config.maxReaders);
+    }
+    else if (IsTripleBufferMode()) {
+        // Back, middle and front buffers
+        m_config.slotCount = 3;
+        m_slotStride = AlignUp(size, kCacheLineSize);
+        m_dataOffset = AlignUp(kControlOffset + sizeof(TripleBufferControlBlock)
+                               + sizeof(SlotDescriptor) * m_config.slotCount, kPayloadAlignment);
+        m_size = m_dataOffset + m_slotStride * m_config.slotCount;
+    }
     Log("ShareMemoryManager constructed");
 }
 
-ShareMemoryManager::~ShareMemoryManager()
+ShareMemoryManager::~ShareMemoryManager()
+{
+    StopMonitoring();
+    Log("Cleaning up resources");
+    UnregisterReader();
+    // The mapping and the named objects close themselves, channel objects stay with their segment
+    m_mapping.Close();
+    Log("ShareMemoryManager destroyed");
+}
+
+bool ShareMemoryManager::Initialize()
+{
+    Log("Initializing shared memory manager");
+
+    // Create mutex
+    m_mutex = std::make_shared<NamedMutex>();
+    if (!m_mutex->Open(m_name + "_mutex")) {
+        SetError(ErrorCode::NoError, "Failed to create mutex");
+        return false;
+    }
+
+    // Create auto-reset event used to wake the consumer when a frame is published
+    m_event = std::make_shared<NamedEvent>();
+    if (!m_event->Open(m_name + "_event")) {
+        SetError(ErrorCode::NoError, "Failed to create event");
+        return false;
+    }
+
+    // The layout sums wrap on 32-bit builds long before a mapping this large could fit
+    if (m_size < m_capacity) {
+        SetError(ErrorCode::DataTooLarge, "Shared memory size exceeds the address space");
+        return false;
+    }
+    if (IsPoolMode() && m_config.poolBytes > kPoolMaxBytes) {
+        SetError(ErrorCode::DataTooLarge, "Frame pool exceeds the largest addressable pool");
+        return false;
+    }
+
+    bool alreadyExists = true;
+    bool largePages = false;
+    if (m_config.role == Role::Consumer) {
+        if (!OpenMapping()) {
+            return false;
+        }
+    }
+    else if (!CreateMapping(alreadyExists, largePages)) {
+        return false;
+    }
+
+    // Serialize the attach-or-initialize decision so two processes starting together
+    // don't both reset the header, and a late starter never sees it half written
+    // An abandoned mutex is ours now, AttachOrInitialize recovers whatever its owner left behind
+    if (m_mutex->Lock(m_config.lockTimeoutMs) == LockResult::Timeout) {
+        SetError(ErrorCode::NoError, "Timed out waiting for the shared memory mutex");
+        return false;
+    }
+    bool attached = alreadyExists && m_config.role != Role::Producer;
+    bool success = AttachOrInitialize(alreadyExists);
+    m_mutex->Unlock();
+    if (!success) {
+        return false;
+    }
+
+    std::stringstream ss;
+    ss << (attached ? "Attached to existing shared memory" : "Shared memory initialized successfully");
+    if (IsPoolMode()) {
+        ss << " - Pool mode, Frames in flight: " << m_config.slotCount
+           << ", Pool: " << m_pPool->ArenaSize << " bytes in " << m_pPool->ClassCount << " size classes"
+           << ", Max frame size: " << m_capacity << " bytes";
+    }
+    else if (IsRingMode()) {
+        ss << " - Ring mode, Slots: " << m_config.slotCount
+           << ", Slot size: " << m_capacity << " bytes";
+    }
+    else if (IsBroadcastMode()) {
+        ss << " - Broadcast mode, Slots: " << m_config.slotCount
+           << ", Readers: " << m_config.maxReaders
+           << ", Slot size: " << m_capacity << " bytes";
+    }
+    else if (IsTripleBufferMode()) {
+        ss << " - Triple buffer mode, Slot size: " << m_capacity << " bytes";
+    }
+    if (largePages) {
+        ss << ", Large pages";
+    }
+    if (m_mapping.Prefaulted()) {
+        ss << ", Prefaulted";
+    }
+    if (m_mapping.Locked()) {
+        ss << ", Locked";
+    }
+    if (m_mapping.NumaNode() >= 0) {
+        ss << ", NUMA node " << m_mapping.NumaNode();
+    }
+    if (m_config.copyMode != CopyMode::Standard) {
+        ss << ", Streaming copy: " << CpuFeatures::Get().StreamingIsa();
+    }
+    if (m_config.codec != CompressionCodec::None) {
+        ss << ", Codec: " << CodecName(m_config.codec);
+    }
+    ss << ", Mapping size: " << m_pHeader->MappingSize << " bytes";
+    if (attached) {
+        ss << ", Last frame ID: " << m_frameId;
+    }
+    Log(ss.str());
+    return true;
+}
+
+void ShareMemoryManager::RemoveNamedObjects(const std::string& name)
+{
+    RemoveSharedObject(name);
+    RemoveSharedObject(name + "_mutex");
+    RemoveSharedObject(name + "_event");
+    RemoveSharedObject(name + "_freed");
+    for (uint32_t i = 0; i < kMaxBroadcastReaders; ++i) {
+        RemoveSharedObject(name + "_reader" + std::to_string(i));
+    }
+}
+
+bool ShareMemoryManager::InitializeChannel(uint8_t* base, std::shared_ptr<NamedMutex> mutex,
+                                           std::shared_ptr<NamedEvent> event, bool alreadyExists)
+{
+    Log("Initializing shared memory channel " + m_name);
+
+    m_ownsMapping = false;
+    m_mutex = mutex;
+    m_event = event;
+    m_pBuffer = base;
+    bool attached = alreadyExists && m_config.role != Role::Producer;
+    if (!AttachOrInitialize(alreadyExists)) {
+        return false;
+    }
+
+    std::stringstream ss;
+    ss << (attached ? "Attached to channel " : "Channel initialized ") << m_name
+       << " - Mode: " << static_cast<uint32_t>(m_config.bufferMode)
+       << ", Slots: " << m_pHeader->SlotCount
+       << ", Slot size: " << m_capacity << " bytes";
+    Log(ss.str());
+    return true;
+}
+
+bool ShareMemoryManager::CreateMapping(bool& alreadyExists, bool& largePages)
+{
+    if (!m_mapping.Create(m_name, m_size, GetMappingOptions())) {
+        SetError(ErrorCode::NoError, m_mapping.GetLastError());
+        return false;
+    }
+    largePages = m_mapping.LargePages();
+    if (m_config.largePages && !largePages) {
+        Log(m_mapping.GetLastError() + ", using normal pages", LogLevel::Warning);
+    }
+    CheckMappingOptions();
+
+    // Large pages round the mapping up to a multiple of the large page size
+    alreadyExists = m_mapping.AlreadyExisted();
+    m_size = m_mapping.Size();
+    m_pBuffer = m_mapping.Data();
+    return true;
+}
+
+bool ShareMemoryManager::OpenMapping()
+{
+    // Consumers still write slot states, cursors and statistics, so the view must be writable
+    if (!m_mapping.Open(m_name, GetMappingOptions())) {
+        SetError(ErrorCode::NoError, m_mapping.GetLastError());
+        return false;
+    }
+    CheckMappingOptions();
+    m_pBuffer = m_mapping.Data();
+    return true;
+}
+
+void ShareMemoryManager::CheckMappingOptions()
+{
+    // None of these is fatal, the mapping works without them, only with more jitter
+    if (m_config.lockPages && !m_mapping.Locked()) {
+        Log("Failed to lock shared memory pages, the working set quota or RLIMIT_MEMLOCK is too small",
+            LogLevel::Warning);
+    }
+    if (m_config.numaNode != -1 && m_mapping.NumaNode() < 0) {
+        Log("Failed to place shared memory on NUMA node " + std::to_string(m_config.numaNode), LogLevel::Warning);
+    }
+}
+
+bool ShareMemoryManager::AttachOrInitialize(bool alreadyExists)
+{
+    const SharedMemoryHeader& peer = *reinterpret_cast<const SharedMemoryHeader*>(m_pBuffer);
+    if (alreadyExists) {
+        if (peer.Magic == 0 && m_config.role == Role::Consumer) {
+            SetError(ErrorCode::NoError, "Shared memory has not been initialized by a producer");
+            return false;
+        }
+        // Refuse layouts we cannot read, even as producer: a running pipeline must not be overwritten
+        if (!CheckPeerLayout(peer)) {
+            return false;
+        }
+    }
+    bool attach = alreadyExists && peer.Magic != 0 && m_config.role != Role::Producer;
+
+    // Setup header and data pointers
+    m_pHeader = reinterpret_cast<SharedMemoryHeader*>(m_pBuffer);
+    m_pStats = reinterpret_cast<SharedMemoryStats*>(m_pBuffer + kStatsOffset);
+    if (IsRingMode()) {
+        m_pRing = reinterpret_cast<RingControlBlock*>(m_pBuffer + kControlOffset);
+        m_pSlots = reinterpret_cast<SlotDescriptor*>(m_pRing + 1);
+        if (IsPoolMode()) {
+            m_pPool = reinterpret_cast<PoolControlBlock*>(m_pSlots + m_config.slotCount);
+            m_pPoolBlocks = reinterpret_cast<std::atomic<uint64_t>*>(m_pPool + 1);
+        }
+    }
+    else if (IsBroadcastMode()) {
+        m_pBroadcast = reinterpret_cast<BroadcastControlBlock*>(m_pBuffer + kControlOffset);
+        m_pReaders = reinterpret_cast<ReaderEntry*>(m_pBroadcast + 1);
+        m_pSlots = reinterpret_cast<SlotDescriptor*>(m_pReaders + m_config.maxReaders);
+    }
+    else if (IsTripleBufferMode()) {
+        m_pTriple = reinterpret_cast<TripleBufferControlBlock*>(m_pBuffer + kControlOffset);
+        m_pSlots = reinterpret_cast<SlotDescriptor*>(m_pTriple + 1);
+    }
+    m_pData = m_pBuffer + m_dataOffset;
+
+    if (attach) {
+        // Leave Ready frames, cursors and statistics of the running pipeline untouched,
+        // but free slots a crashed predecessor left in Writing or Reading
+        RecoverStuckSlots();
+        ResumeFrameId();
+        return true;
+    }
+
+    // Initialize header
+    m_pHeader->Version = kHeaderVersion;
+    m_pHeader->ChecksumType = static_cast<uint32_t>(m_config.checksumMode);
+    m_pHeader->Codec = static_cast<uint32_t>(m_config.codec);
+    m_pHeader->BufferMode = static_cast<uint32_t>(m_config.bufferMode);
+    m_pHeader->SlotCapacity = m_capacity;
+    m_pHeader->SlotCount = m_pSlots ? m_config.slotCount : 1;
+    m_pHeader->HeaderSize = static_cast<uint32_t>(sizeof(SharedMemoryHeader));
+    m_pHeader->DataOffset = m_dataOffset;
+    m_pHeader->MappingSize = m_size;
+    m_pHeader->Waiters.store(0);
+    m_pHeader->ProducerPid.store(0);
+    m_pHeader->WriteWaiters.store(0);
+    m_pHeader->ProducerHeartbeatNs.store(0);
+    m_pHeader->ConsumerPid.store(0);
+    m_pHeader->ConsumerHeartbeatNs.store(0);
+    m_pHeader->KeyframeRequest.store(0);
+    ResetStatistics();
+    ResetSlots();
+    
+    // Clear error message
+    memset(m_pHeader->ErrorMsg, 0, sizeof(m_pHeader->ErrorMsg));
+
+    // Magic last: a header with a valid magic is always fully initialized
+    std::atomic_thread_fence(std::memory_order_release);
+    m_pHeader->Magic = kHeaderMagic;
+    return true;
+}
+
+void ShareMemoryManager::ResumeFrameId()
+{
+    if (m_pRing) {
+        m_frameId = m_pRing->LastFrameId.load(std::memory_order_acquire);
+    }
+    else if (m_pBroadcast) {
+        m_frameId = m_pBroadcast->PublishedFrameId.load(std::memory_order_acquire);
+    }
+    else if (m_pTriple) {
+        m_frameId = m_pTriple->LastFrameId.load(std::memory_order_acquire);
+    }
+    else {
+        m_frameId = m_pHeader->Slot.FrameId.load(std::memory_order_acquire);
+    }
+}
+
+bool ShareMemoryManager::CheckPeerLayout(const SharedMemoryHeader& peer)
+{
+    if (peer.Magic == 0) {
+        return true;  // Created but not initialized yet
+    }
+
+    // Single slot mode has no descriptor array and records one slot, as AttachOrInitialize writes it
+    uint32_t slotCount = (IsRingMode() || IsBroadcastMode() || IsTripleBufferMode()) ? m_config.slotCount : 1;
+
+    std::stringstream ss;
+    if (peer.Magic == kLegacyHeaderMagic) {
+        ss << "Shared memory uses the legacy v1 layout, upgrade the peer process";
+    }
+    else if (peer.Magic != kHeaderMagic) {
+        ss << "Shared memory has an unknown header (magic 0x" << std::hex << peer.Magic << ")";
+    }
+    else if (peer.Version != kHeaderVersion) {
+        ss << "Shared memory layout version " << peer.Version
+           << " does not match ours (" << kHeaderVersion << ")";
+    }
+    else if (peer.BufferMode != static_cast<uint32_t>(m_config.bufferMode) ||
+             peer.SlotCount != slotCount ||
+             peer.SlotCapacity != m_capacity ||
+             peer.DataOffset != m_dataOffset ||
+             peer.MappingSize < m_size ||
+             (IsPoolMode() && peer.MappingSize != m_size)) {
+        ss << "Shared memory was created with a different configuration - Mode: " << peer.BufferMode
+           << ", Slots: " << peer.SlotCount << ", Slot size: " << peer.SlotCapacity << " bytes";
+    }
+    else if (IsBroadcastMode() &&
+             reinterpret_cast<const BroadcastControlBlock*>(m_pBuffer + kControlOffset)->MaxReaders !=
+                 m_config.maxReaders) {
+        // The reader table length decides where the slot descriptors start
+        ss << "Shared memory was created for "
+           << reinterpret_cast<const BroadcastControlBlock*>(m_pBuffer + kControlOffset)->MaxReaders
+           << " broadcast readers, we are configured for " << m_config.maxReaders;
+    }
+    else {
+        return true;
+    }
+
+    // m_pHeader is not set yet, so this does not touch the peer's header
+    SetError(ErrorCode::NoError, ss.str());
+    return false;
+}
+
+SlotDescriptor* ShareMemoryManager::GetSlot(uint32_t index)
+{
+    return m_pSlots ? &m_pSlots[index] : &m_pHeader->Slot;
+}
+
+uint8_t* ShareMemoryManager::GetSlotData(uint32_t index)
+{
+    if (m_pPoolBlocks) {
+        // The handle was stored before the slot became Ready, the status load ordered it for us
+        return m_pData + (m_pPoolBlocks[index].load(std::memory_order_relaxed) & ~kPoolClassMask);
+    }
+    return m_pData + static_cast<size_t>(index) * m_slotStride;
+}
+
+void ShareMemoryManager::ResetSlot(SlotDescriptor& slot)
+{
+    slot.DataSize = 0;
+    slot.Checksum = 0;
+    slot.FrameId.store(0, std::memory_order_relaxed);
+    slot.info = {};  // Initialize all fields to 0
+    slot.PublishTimeNs = 0;
+    slot.Status.store(static_cast<uint32_t>(MemoryStatus::Empty), std::memory_order_release);
+}
+
+void ShareMemoryManager::ResetSlots()
+{
+    ResetSlot(m_pHeader->Slot);
+
+    if (IsRingMode()) {
+        m_pRing->BufferSize = m_capacity;
+        m_pRing->MaxFrames = m_config.slotCount;
+        m_pRing->WriteIndex.store(0);
+        m_pRing->ReadIndex.store(0);
+        m_pRing->FrameCount.store(0);
+        m_pRing->LastFrameId.store(0);
+
+        for (uint32_t i = 0; i < m_config.slotCount; ++i) {
+            ResetSlot(m_pSlots[i]);
+        }
+        if (IsPoolMode()) {
+            ResetPool();
+        }
+    }
+    else if (IsBroadcastMode()) {
+        m_pBroadcast->BufferSize = m_capacity;
+        m_pBroadcast->MaxFrames = m_config.slotCount;
+        m_pBroadcast->MaxReaders = m_config.maxReaders;
+        m_pBroadcast->PublishedFrameId.store(0);
+
+        for (uint32_t i = 0; i < m_config.maxReaders; ++i) {
+            ReaderEntry& reader = m_pReaders[i];
+            reader.Policy = 0;
+            reader.ProcessId = 0;
+            reader.Cursor.store(0);
+            reader.Pinned.store(0);
+            reader.Waiting.store(0);
+            reader.HeartbeatNs.store(0);
+            reader.State.store(kReaderFree);
+        }
+
+        for (uint32_t i = 0; i < m_config.slotCount; ++i) {
+            ResetSlot(m_pSlots[i]);
+        }
+
+        // Readers registered before the reset notice the new epoch and register again
+        m_pBroadcast->Epoch.fetch_add(1);
+    }
+    else if (IsTripleBufferMode()) {
+        m_pTriple->BufferSize = m_capacity;
+        m_pTriple->BackIndex = 0;
+        m_pTriple->Middle.store(1);
+        m_pTriple->FrontIndex = 2;
+        m_pTriple->LastFrameId.store(0);
+        m_pTriple->DroppedFrames.store(0);
+
+        for (uint32_t i = 0; i < m_config.slotCount; ++i) {
+            ResetSlot(m_pSlots[i]);
+        }
+        m_frontHeld = false;
+    }
+}
+
+void ShareMemoryManager::ResetPool()
+{
+    m_pPool->ArenaSize = m_config.poolBytes;
+    m_pPool->ArenaTop.store(0);
+
+    // Quarter steps between powers of two keep the rounding loss under 25%. The smallest class
+    // grows with the frame size so that the largest frame is still reached within kPoolMaxClasses.
+    uint64_t largest = std::max<uint64_t>(AlignUp(m_capacity, kCacheLineSize), kCacheLineSize);
+    uint64_t octave = kPoolMinBlockSize;
+    while ((octave << 15) < largest) {
+        octave <<= 1;
+    }
+    for (uint32_t i = 0; i < kPoolMaxClasses; ++i) {
+        PoolSizeClass& sizeClass = m_pPool->Classes[i];
+        sizeClass.BlockSize = 0;
+        sizeClass.FreeHead.store(0);
+        sizeClass.FreeBlocks.store(0);
+        sizeClass.TotalBlocks.store(0);
+    }
+    uint64_t blockSize = octave;
+    uint32_t classCount = 0;
+    while (classCount < kPoolMaxClasses) {
+        m_pPool->Classes[classCount++].BlockSize = std::min(blockSize, largest);
+        if (blockSize >= largest) {
+            break;
+        }
+        blockSize += octave / 4;
+        if (blockSize >= octave * 2) {
+            octave *= 2;
+        }
+    }
+    m_pPool->ClassCount = classCount;
+
+    for (uint32_t i = 0; i < m_config.slotCount; ++i) {
+        m_pPoolBlocks[i].store(kPoolNoBlock);
+    }
+}
+
+uint32_t ShareMemoryManager::FindPoolClass(size_t size) const
+{
+    uint32_t classIndex = 0;
+    while (classIndex < m_pPool->ClassCount && m_pPool->Classes[classIndex].BlockSize < size) {
+        ++classIndex;
+    }
+    return classIndex;
+}
+
+bool ShareMemoryManager::AllocatePoolBlock(size_t size, uint64_t& handle)
+{
+    uint32_t first = FindPoolClass(size);
+    if (first >= m_pPool->ClassCount) {
+        return false;
+    }
+
+    // A recycled block of the right size first, then fresh space, a larger free block last
+    if (PopPoolBlock(first, handle)) {
+        return true;
+    }
+
+    PoolSizeClass& sizeClass = m_pPool->Classes[first];
+    uint64_t top = m_pPool->ArenaTop.load(std::memory_order_relaxed);
+    while (top + sizeClass.BlockSize <= m_pPool->ArenaSize) {
+        if (m_pPool->ArenaTop.compare_exchange_weak(top, top + sizeClass.BlockSize, std::memory_order_relaxed)) {
+            sizeClass.TotalBlocks.fetch_add(1, std::memory_order_relaxed);
+            handle = top | first;
+            return true;
+        }
+    }
+
+    for (uint32_t classIndex = first + 1; classIndex < m_pPool->ClassCount; ++classIndex) {
+        if (PopPoolBlock(classIndex, handle)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ShareMemoryManager::PopPoolBlock(uint32_t classIndex, uint64_t& handle)
+{
+    PoolSizeClass& sizeClass = m_pPool->Classes[classIndex];
+    uint64_t head = sizeClass.FreeHead.load(std::memory_order_acquire);
+    while (FreeHeadLink(head) != 0) {
+        uint64_t offset = static_cast<uint64_t>(FreeHeadLink(head) - 1) * kCacheLineSize;
+        // The block may be popped and refilled under us, the counter in the head then fails the exchange
+        uint32_t next = reinterpret_cast<std::atomic<uint32_t>*>(m_pData + offset)->load(std::memory_order_relaxed);
+        if (sizeClass.FreeHead.compare_exchange_weak(head, PackFreeHead(head, next),
+                                                     std::memory_order_acquire, std::memory_order_acquire)) {
+            sizeClass.FreeBlocks.fetch_sub(1, std::memory_order_relaxed);
+            handle = offset | classIndex;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ShareMemoryManager::FreePoolBlock(uint64_t handle)
+{
+    uint64_t offset = handle & ~kPoolClassMask;
+    PoolSizeClass& sizeClass = m_pPool->Classes[handle & kPoolClassMask];
+    std::atomic<uint32_t>* link = reinterpret_cast<std::atomic<uint32_t>*>(m_pData + offset);
+    uint32_t self = static_cast<uint32_t>(offset / kCacheLineSize + 1);
+
+    uint64_t head = sizeClass.FreeHead.load(std::memory_order_relaxed);
+    do {
+        link->store(FreeHeadLink(head), std::memory_order_relaxed);
+    } while (!sizeClass.FreeHead.compare_exchange_weak(head, PackFreeHead(head, self),
+                                                       std::memory_order_release, std::memory_order_relaxed));
+    sizeClass.FreeBlocks.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool ShareMemoryManager::PoolHasSpace(size_t size) const
+{
+    uint32_t first = FindPoolClass(size);
+    if (first >= m_pPool->ClassCount) {
+        return false;
+    }
+    if (m_pPool->ArenaTop.load(std::memory_order_relaxed) + m_pPool->Classes[first].BlockSize <= m_pPool->ArenaSize) {
+        return true;
+    }
+    for (uint32_t classIndex = first; classIndex < m_pPool->ClassCount; ++classIndex) {
+        if (FreeHeadLink(m_pPool->Classes[classIndex].FreeHead.load(std::memory_order_acquire)) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ShareMemoryManager::AllocateSlotBlock(uint32_t slotIndex, size_t size)
+{
+    uint64_t handle = 0;
+    if (!AllocatePoolBlock(size, handle)) {
+        return false;
+    }
+    // Published to readers together with the descriptor when the slot turns Ready
+    m_pPoolBlocks[slotIndex].store(handle, std::memory_order_relaxed);
+    return true;
+}
+
+void ShareMemoryManager::FreeSlotBlock(uint32_t slotIndex)
+{
+    // Whoever takes the handle out returns the block, so it is never freed twice
+    uint64_t handle = m_pPoolBlocks[slotIndex].exchange(kPoolNoBlock, std::memory_order_acq_rel);
+    if (handle != kPoolNoBlock) {
+        FreePoolBlock(handle);
+    }
+}
+
+FramePoolUsage ShareMemoryManager::GetPoolUsage() const
+{
+    FramePoolUsage usage;
+    if (!m_pPool) {
+        return usage;
+    }
+    usage.arenaBytes = m_pPool->ArenaSize;
+    usage.carvedBytes = m_pPool->ArenaTop.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < m_pPool->ClassCount; ++i) {
+        const PoolSizeClass& sizeClass = m_pPool->Classes[i];
+        uint32_t total = sizeClass.TotalBlocks.load(std::memory_order_relaxed);
+        // The two counters are updated separately, a snapshot may see one moved before the other
+        uint32_t idle = std::min(sizeClass.FreeBlocks.load(std::memory_order_relaxed), total);
+        usage.freeBlocks += idle;
+        usage.liveBlocks += total - idle;
+        usage.liveBytes += static_cast<uint64_t>(total - idle) * sizeClass.BlockSize;
+    }
+    return usage;
+}
+
+bool ShareMemoryManager::RegisterReader()
+{
+    if (!m_pBroadcast) {
+        return false;
+    }
+
+    if (m_readerIndex >= 0) {
+        if (m_pBroadcast->Epoch.load(std::memory_order_acquire) == m_readerEpoch) {
+            if (m_pReaders[m_readerIndex].Generation.load(std::memory_order_acquire) == m_readerGeneration) {
+                return true;
+            }
+            Log("Broadcast reader entry was reclaimed after missing heartbeats, registering again", LogLevel::Warning);
+        }
+        // The reader table was reset under us, our entry may already belong to someone else
+        m_readerIndex = -1;
+    }
+
+    for (uint32_t i = 0; i < m_config.maxReaders; ++i) {
+        ReaderEntry& reader = m_pReaders[i];
+        uint32_t expected = kReaderFree;
+        if (!reader.State.compare_exchange_strong(expected, kReaderClaiming, std::memory_order_acquire)) {
+            continue;
+        }
+
+        // The event is named after the entry, so re-registering may need a different one
+        if (!m_readerEvent.Open(m_name + "_reader" + std::to_string(i))) {
+            reader.State.store(kReaderFree, std::memory_order_release);
+            Log("Failed to create reader event", LogLevel::Error);
+            return false;
+        }
+
+        reader.Policy = static_cast<uint32_t>(m_config.readerPolicy);
+        reader.ProcessId = m_processId;
+        reader.Pinned.store(0, std::memory_order_relaxed);
+        reader.Waiting.store(0, std::memory_order_relaxed);
+        reader.HeartbeatNs.store(NowNs(), std::memory_order_relaxed);
+        reader.Cursor.store(m_pBroadcast->PublishedFrameId.load(std::memory_order_acquire) + 1,
+                            std::memory_order_relaxed);
+        m_readerGeneration = reader.Generation.fetch_add(1, std::memory_order_relaxed) + 1;
+        reader.State.store(kReaderActive, std::memory_order_seq_cst);
+
+        m_readerIndex = static_cast<int32_t>(i);
+        m_readerEpoch = m_pBroadcast->Epoch.load(std::memory_order_acquire);
+
+        std::stringstream ss;
+        ss << "Registered broadcast reader " << i
+           << (m_config.readerPolicy == ReaderPolicy::LatestOnly ? " (latest only)" : " (reliable)");
+        Log(ss.str());
+        return true;
+    }
+
+    // Entries of crashed readers are only freed lazily, try again once they are gone
+    if (ReclaimDeadReaders()) {
+        return RegisterReader();
+    }
+
+    Log("Broadcast reader table full", LogLevel::Error);
+    return false;
+}
+
+void ShareMemoryManager::UnregisterReader()
+{
+    if (m_readerIndex < 0 || !m_pBroadcast) {
+        return;
+    }
+
+    ReaderEntry& reader = m_pReaders[m_readerIndex];
+    if (m_pBroadcast->Epoch.load(std::memory_order_acquire) == m_readerEpoch &&
+        reader.Generation.load(std::memory_order_acquire) == m_readerGeneration) {
+        reader.Pinned.store(0, std::memory_order_relaxed);
+        reader.State.store(kReaderFree, std::memory_order_release);
+        std::stringstream ss;
+        ss << "Unregistered broadcast reader " << m_readerIndex;
+        Log(ss.str());
+    }
+    m_readerIndex = -1;
+}
+
+bool ShareMemoryManager::IsFrameReleased(uint64_t frameId)
+{
+    for (uint32_t i = 0; i < m_config.maxReaders; ++i) {
+        ReaderEntry& reader = m_pReaders[i];
+        if (reader.State.load(std::memory_order_seq_cst) != kReaderActive) {
+            continue;
+        }
+        if (reader.Policy == static_cast<uint32_t>(ReaderPolicy::Reliable) &&
+            !FrameIdBefore(frameId, reader.Cursor.load(std::memory_order_seq_cst))) {
+            return false;
+        }
+        if (reader.Pinned.load(std::memory_order_seq_cst) == frameId) {
+            return false;
+        }
+    }
+    return true;
+}
+
+NamedEvent* ShareMemoryManager::GetReaderEvent(uint32_t readerIndex)
+{
+    std::unique_ptr<NamedEvent>& readerEvent = m_readerEvents[readerIndex];
+    if (!readerEvent) {
+        // Opening by name finds the event the reader created when it registered
+        readerEvent.reset(new NamedEvent());
+        if (!readerEvent->Open(m_name + "_reader" + std::to_string(readerIndex))) {
+            readerEvent.reset();
+        }
+    }
+    return readerEvent.get();
+}
+
+bool ShareMemoryManager::HasPendingFrame()
+{
+    if (IsBroadcastMode()) {
+        if (m_readerIndex < 0) {
+            return false;
+        }
+        uint64_t cursor = m_pReaders[m_readerIndex].Cursor.load(std::memory_order_relaxed);
+        return !FrameIdBefore(m_pBroadcast->PublishedFrameId.load(std::memory_order_acquire), cursor);
+    }
+    if (IsTripleBufferMode()) {
+        return (m_pTriple->Middle.load(std::memory_order_acquire) & kTripleBufferFresh) != 0;
+    }
+
+    uint32_t slotIndex = IsRingMode() ? m_pRing->ReadIndex.load(std::memory_order_relaxed) : 0;
+    return GetSlot(slotIndex)->Status.load(std::memory_order_acquire)
+        == static_cast<uint32_t>(MemoryStatus::Ready);
+}
+
+void ShareMemoryManager::NotifyConsumer()
+{
+    TraceScope trace(TraceStage::Notify, m_traceChannel);
+
+    // Pairs with the Waiters increment in WaitForFrame: either the consumer sees
+    // the Ready status before blocking, or we see it waiting and signal it.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (IsBroadcastMode()) {
+        // An auto-reset event wakes a single waiter, so every reader has its own
+        for (uint32_t i = 0; i < m_config.maxReaders; ++i) {
+            ReaderEntry& reader = m_pReaders[i];
+            if (reader.State.load(std::memory_order_relaxed) == kReaderActive &&
+                reader.Waiting.load(std::memory_order_relaxed) != 0) {
+                NamedEvent* readerEvent = GetReaderEvent(i);
+                if (readerEvent) {
+                    readerEvent->Signal();
+                }
+            }
+        }
+        return;
+    }
+    if (m_pHeader->Waiters.load(std::memory_order_relaxed) != 0) {
+        m_event->Signal();
+    }
+}
+
+bool ShareMemoryManager::WaitForData(uint32_t timeoutMs)
+{
+    if (!m_pHeader) {
+        return false;
+    }
+    WaitForFrame(timeoutMs, nullptr);
+    return HasPendingFrame();
+}
+
+void ShareMemoryManager::WaitForFrame(uint32_t timeoutMs, const std::atomic<bool>* running)
+{
+    if (!m_pHeader) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+        return;
+    }
+
+    TraceScope trace(TraceStage::FrameWait, m_traceChannel);
+
+    // An idle consumer is still alive, keep its slots from being reclaimed
+    Heartbeat(false);
+
+    if (m_config.spinMicroseconds > 0) {
+        auto deadline = std::chrono::steady_clock::now()
+                      + std::chrono::microseconds(m_config.spinMicroseconds);
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (HasPendingFrame() || (running && !*running)) {
+                return;
+            }
+            CpuRelax();
+        }
+    }
+
+    NamedEvent* frameEvent = BeginWait();
+    if (!HasPendingFrame() && (!running || *running)) {
+        frameEvent->Wait(timeoutMs);
+    }
+    EndWait();
+}
+
+NamedEvent* ShareMemoryManager::BeginWait()
+{
+    if (IsBroadcastMode() && m_readerIndex >= 0) {
+        m_pReaders[m_readerIndex].Waiting.fetch_add(1);
+        return &m_readerEvent;
+    }
+    m_pHeader->Waiters.fetch_add(1);
+    return m_event.get();
+}
+
+void ShareMemoryManager::EndWait()
+{
+    if (IsBroadcastMode() && m_readerIndex >= 0) {
+        m_pReaders[m_readerIndex].Waiting.fetch_sub(1);
+        return;
+    }
+    m_pHeader->Waiters.fetch_sub(1);
+}
+
+bool ShareMemoryManager::LockHeader()
+{
+    if (IsLockFree()) {
+        return true;
+    }
+
+    TraceScope trace(TraceStage::Lock, m_traceChannel);
+    LockResult lockResult = m_mutex->Lock(m_config.lockTimeoutMs);
+    if (lockResult == LockResult::Abandoned) {
+        // The owner died inside its critical section; we hold the mutex now and must
+        // release it as usual, otherwise every later caller times out
+        m_pStats->AbandonedLocks.fetch_add(1, std::memory_order_relaxed);
+        Log("Previous mutex owner terminated, recovering shared memory state", LogLevel::Warning);
+        RecoverStuckSlots();
+        return true;
+    }
+    if (lockResult != LockResult::Acquired) {
+        m_pStats->MutexTimeouts.fetch_add(1, std::memory_order_relaxed);
+        Log("Failed to acquire mutex", LogLevel::Warning);
+        return false;
+    }
+    return true;
+}
+
+void ShareMemoryManager::UnlockHeader()
+{
+    if (!IsLockFree()) {
+        m_mutex->Unlock();
+    }
+}
+
+void ShareMemoryManager::Heartbeat(bool producer)
+{
+    uint64_t now = NowNs();
+    if (!producer && IsBroadcastMode()) {
+        if (m_readerIndex >= 0) {
+            m_pReaders[m_readerIndex].HeartbeatNs.store(now, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    std::atomic<uint32_t>& pid = producer ? m_pHeader->ProducerPid : m_pHeader->ConsumerPid;
+    std::atomic<uint64_t>& heartbeat = producer ? m_pHeader->ProducerHeartbeatNs : m_pHeader->ConsumerHeartbeatNs;
+    if (pid.load(std::memory_order_relaxed) != m_processId) {
+        pid.store(m_processId, std::memory_order_relaxed);
+    }
+    heartbeat.store(now, std::memory_order_relaxed);
+}
+
+bool ShareMemoryManager::IsPeerAlive(uint32_t processId, uint64_t heartbeatNs) const
+{
+    if (processId == m_processId) {
+        return true;  // Another instance in this process, it cannot have crashed without us
+    }
+
+    uint64_t now = NowNs();
+    uint64_t age = now > heartbeatNs ? now - heartbeatNs : 0;
+    if (age < kHeartbeatGraceNs) {
+        return true;
+    }
+    // A dead process is detected right away, a hung one only after peerTimeoutMs
+    if (processId != 0 && ProcessExited(processId)) {
+        return false;
+    }
+    return m_config.peerTimeoutMs == 0 || age < static_cast<uint64_t>(m_config.peerTimeoutMs) * 1000 * 1000;
+}
+
+bool ShareMemoryManager::ReclaimStuckSlot(uint32_t slotIndex, MemoryStatus stuck)
+{
+    SlotDescriptor* slot = GetSlot(slotIndex);
+    if (slot->Status.load(std::memory_order_acquire) != static_cast<uint32_t>(stuck)) {
+        return false;
+    }
+
+    bool writing = stuck == MemoryStatus::Writing;
+    uint32_t owner = writing ? m_pHeader->ProducerPid.load(std::memory_order_relaxed)
+                             : m_pHeader->ConsumerPid.load(std::memory_order_relaxed);
+    uint64_t heartbeat = writing ? m_pHeader->ProducerHeartbeatNs.load(std::memory_order_relaxed)
+                                 : m_pHeader->ConsumerHeartbeatNs.load(std::memory_order_relaxed);
+    if (IsPeerAlive(owner, heartbeat)) {
+        return false;
+    }
+
+    // In Pool mode the slot is held in Writing until its block is back, a producer claims only Empty slots
+    uint32_t expected = static_cast<uint32_t>(stuck);
+    MemoryStatus reclaimed = IsPoolMode() ? MemoryStatus::Writing : MemoryStatus::Empty;
+    if (!slot->Status.compare_exchange_strong(expected, static_cast<uint32_t>(reclaimed),
+                                              std::memory_order_acq_rel)) {
+        return false;
+    }
+    if (IsPoolMode()) {
+        FreeSlotBlock(slotIndex);
+        slot->Status.store(static_cast<uint32_t>(MemoryStatus::Empty), std::memory_order_release);
+    }
+    // A slot stuck in Reading was already counted as pending and skipped by the read index
+    if (!writing && IsRingMode()) {
+        m_pRing->FrameCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+    m_pStats->SlotsReclaimed.fetch_add(1, std::memory_order_relaxed);
+
+    std::stringstream ss;
+    ss << "Reclaimed slot " << slotIndex << " stuck in " << (writing ? "Writing" : "Reading")
+       << ", " << (writing ? "producer" : "consumer") << " pid " << owner << " is gone";
+    Log(ss.str(), LogLevel::Warning);
+    return true;
+}
+
+bool ShareMemoryManager::ReclaimDeadReaders()
+{
+    if (!m_pBroadcast) {
+        return false;
+    }
+
+    bool reclaimed = false;
+    for (uint32_t i = 0; i < m_config.maxReaders; ++i) {
+        ReaderEntry& reader = m_pReaders[i];
+        if (reader.State.load(std::memory_order_acquire) != kReaderActive ||
+            IsPeerAlive(reader.ProcessId, reader.HeartbeatNs.load(std::memory_order_relaxed))) {
+            continue;
+        }
+
+        // Bumping the generation tells a reader that was only hung to register again
+        uint32_t expected = kReaderActive;
+        if (!reader.State.compare_exchange_strong(expected, kReaderClaiming, std::memory_order_acquire)) {
+            continue;
+        }
+        uint32_t processId = reader.ProcessId;
+        reader.Generation.fetch_add(1, std::memory_order_relaxed);
+        reader.Pinned.store(0, std::memory_order_relaxed);
+        reader.State.store(kReaderFree, std::memory_order_release);
+        m_pStats->SlotsReclaimed.fetch_add(1, std::memory_order_relaxed);
+        reclaimed = true;
+
+        std::stringstream ss;
+        ss << "Reclaimed broadcast reader " << i << ", pid " << processId << " is gone";
+        Log(ss.str(), LogLevel::Warning);
+    }
+    return reclaimed;
+}
+
+bool ShareMemoryManager::ReclaimHeldBlocks()
+{
+    // Frames a dead consumer still had views on sit behind the write index, the ring alone would never reach them
+    bool reclaimed = false;
+    for (uint32_t i = 0; i < m_config.slotCount; ++i) {
+        if (ReclaimStuckSlot(i, MemoryStatus::Reading)) {
+            reclaimed = true;
+        }
+    }
+    return reclaimed;
+}
+
+void ShareMemoryManager::RecoverStuckSlots()
+{
+    if (IsTripleBufferMode()) {
+        return;  // Neither side ever waits on the other's slot
+    }
+    if (IsBroadcastMode()) {
+        ReclaimDeadReaders();
+    }
+
+    uint32_t slotCount = m_pSlots ? m_config.slotCount : 1;
+    for (uint32_t i = 0; i < slotCount; ++i) {
+        if (!ReclaimStuckSlot(i, MemoryStatus::Writing) && !IsBroadcastMode()) {
+            ReclaimStuckSlot(i, MemoryStatus::Reading);
+        }
+    }
+}
+
+bool ShareMemoryManager::WriteData(const uint8_t* data, size_t size, const DataInfo& info)
+{
+    return WriteData(data, size, info, DefaultWriteTimeout());
+}
+
+bool ShareMemoryManager::WriteData(const uint8_t* data, size_t size, const DataInfo& info, uint32_t timeoutMs)
+{
+    TraceScope trace(TraceStage::Write, m_traceChannel);
+
+    // Compress before taking the header lock, only the compressed bytes are copied into the slot
+    thread_local std::vector<uint8_t> stored;
+    bool written = false;
+    if (CompressFrame(data, size, info, stored)) {
+        DataInfo storedInfo = info;
+        storedInfo.dataType = static_cast<uint32_t>(FrameType::COMPRESSED);
+        written = WriteStoredData(stored.data(), stored.size(), storedInfo, timeoutMs);
+    }
+    else {
+        written = WriteStoredData(data, size, info, timeoutMs);
+    }
+    if (written) {
+        trace.SetFrame(m_frameId);
+    }
+    return written;
+}
+
+bool ShareMemoryManager::TryWriteData(const uint8_t* data, size_t size, const DataInfo& info)
+{
+    return WriteData(data, size, info, 0);
+}
+
+bool ShareMemoryManager::WaitForWritable(uint32_t timeoutMs)
+{
+    if (!m_pHeader) {
+        return false;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!HasFreeSlot(0)) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) {
+            return false;
+        }
+        WaitForFreeSlot(static_cast<uint32_t>(remaining), 0);
+    }
+    return true;
+}
+
+bool ShareMemoryManager::CompressFrame(const uint8_t* data, size_t size, const DataInfo& info,
+                                       std::vector<uint8_t>& stored)
+{
+    // Images are left alone, they rarely compress well enough to pay for the time
+    bool compressible = info.dataType == static_cast<uint32_t>(FrameType::POINTCLOUD) ||
+                        info.dataType == static_cast<uint32_t>(FrameType::HEIGHTMAP);
+    if (m_config.codec == CompressionCodec::None || !compressible || !m_pBuffer || !data ||
+        size <= sizeof(CompressedHeader)) {
+        return false;
+    }
+
+    // Worth storing only when smaller than the raw frame and within the slot
+    size_t limit = std::min(size, m_capacity);
+    if (limit <= sizeof(CompressedHeader)) {
+        return false;
+    }
+    stored.resize(limit);
+    size_t compressed = CodecCompress(m_config.codec, data, size, sizeof(float),
+                                      stored.data() + sizeof(CompressedHeader), limit - sizeof(CompressedHeader));
+    if (compressed == 0) {
+        if (size > m_capacity) {
+            Log("Compressed frame still exceeds buffer capacity", LogLevel::Warning);
+        }
+        return false;
+    }
+
+    CompressedHeader* header = reinterpret_cast<CompressedHeader*>(stored.data());
+    memset(header, 0, sizeof(CompressedHeader));
+    header->Magic = kCompressedMagic;
+    header->Codec = static_cast<uint32_t>(m_config.codec);
+    header->RawSize = size;
+    header->StoredSize = compressed;
+    header->ElementSize = sizeof(float);
+    header->info = info;
+    stored.resize(sizeof(CompressedHeader) + compressed);
+    return true;
+}
+
+bool ShareMemoryManager::WriteStoredData(const uint8_t* data, size_t size, const DataInfo& info,
+                                         uint32_t timeoutMs)
+{
+    if (!m_pBuffer || size > m_capacity) {
+        Log("Data size exceeds buffer capacity");
+        return false;
+    }
+
+    if (m_writePending) {
+        Log("Zero-copy write in progress, commit or abort it first");
+        return false;
+    }
+
+    uint32_t slotIndex = 0;
+    if (!LockWriteSlot(slotIndex, size, timeoutMs)) {
+        return false;
+    }
+
+    bool success = false;
+    try {
+        // Copy data, hashing each chunk while it is still in cache
+        uint32_t checksum = 0;
+        {
+            TraceScope copyTrace(TraceStage::Copy, m_traceChannel);
+            checksum = CopyWithChecksum(GetSlotData(slotIndex), data, size, m_config.checksumMode, GetCopyOptions());
+        }
+
+        PublishSlot(slotIndex, size, info, checksum);
+        success = true;
+    }
+    catch (const std::exception& e) {
+        Log(std::string("Exception during write: ") + e.what());
+        success = false;
+    }
+
+    UnlockHeader();
+
+    if (success) {
+        NotifyConsumer();
+    }
+    return success;
+}
+
+bool ShareMemoryManager::WriteBundle(const std::vector<BundleFrame>& frames)
+{
+    if (frames.empty() || frames.size() > kMaxBundleFrames) {
+        Log("A bundle must hold 1 to " + std::to_string(kMaxBundleFrames) + " frames");
+        return false;
+    }
+
+    // Directory first, then every frame on its own cache line
+    size_t tableSize = sizeof(BundleHeader) + sizeof(BundleEntry) * frames.size();
+    size_t totalSize = tableSize;
+    for (const BundleFrame& frame : frames) {
+        if (frame.size > m_capacity) {
+            Log("Data size exceeds buffer capacity");
+            return false;
+        }
+        totalSize = AlignUp(totalSize, kCacheLineSize) + frame.size;
+    }
+
+    if (!m_pBuffer || totalSize > m_capacity) {
+        Log("Bundle size exceeds buffer capacity");
+        return false;
+    }
+
+    if (m_writePending) {
+        Log("Zero-copy write in progress, commit or abort it first");
+        return false;
+    }
+
+    TraceScope trace(TraceStage::Write, m_traceChannel);
+    uint32_t slotIndex = 0;
+    if (!LockWriteSlot(slotIndex, totalSize, DefaultWriteTimeout())) {
+        return false;
+    }
+
+    bool success = false;
+    try {
+        uint8_t* buffer = GetSlotData(slotIndex);
+        BundleHeader* header = reinterpret_cast<BundleHeader*>(buffer);
+        BundleEntry* entries = reinterpret_cast<BundleEntry*>(header + 1);
+        memset(buffer, 0, tableSize);
+        header->Magic = kBundleMagic;
+        header->FrameCount = static_cast<uint32_t>(frames.size());
+
+        size_t offset = tableSize;
+        for (size_t i = 0; i < frames.size(); ++i) {
+            size_t aligned = AlignUp(offset, kCacheLineSize);
+            memset(buffer + offset, 0, aligned - offset);
+            entries[i].info = frames[i].info;
+            entries[i].Offset = aligned;
+            entries[i].Size = frames[i].size;
+            offset = aligned + frames[i].size;
+        }
+
+        // One checksum over the whole slot, exactly as the consumer verifies it
+        Checksum checksum(m_config.checksumMode);
+        checksum.Update(buffer, tableSize);
+        offset = tableSize;
+        for (size_t i = 0; i < frames.size(); ++i) {
+            size_t aligned = static_cast<size_t>(entries[i].Offset);
+            checksum.Update(buffer + offset, aligned - offset);
+            CopyWithChecksum(buffer + aligned, frames[i].data, frames[i].size, checksum, GetCopyOptions());
+            offset = aligned + frames[i].size;
+        }
+
+        DataInfo info = {};
+        info.width = static_cast<uint32_t>(frames.size());
+        info.dataType = static_cast<uint32_t>(FrameType::BUNDLE);
+        info.timestamp = frames[0].info.timestamp;
+        PublishSlot(slotIndex, totalSize, info, checksum.Finalize());
+        trace.SetFrame(m_frameId);
+        success = true;
+    }
+    catch (const std::exception& e) {
+        Log(std::string("Exception during bundle write: ") + e.what());
+        success = false;
+    }
+
+    UnlockHeader();
+
+    if (success) {
+        NotifyConsumer();
+    }
+    return success;
+}
+
+bool ShareMemoryManager::NeedsKeyframe(size_t size, const DataInfo& info)
+{
+    // Always consume a pending request, a keyframe sent for another reason answers it as well
+    bool requested = m_pHeader->KeyframeRequest.exchange(0, std::memory_order_acq_rel) != 0;
+
+    // Anything published since the base frame became the readers' base instead
+    return requested || m_deltaBaseId == 0 || m_deltaBaseId != m_frameId || size != m_deltaSize ||
+           info.dataType != m_deltaInfo.dataType || info.width != m_deltaInfo.width ||
+           info.height != m_deltaInfo.height ||
+           (m_config.deltaKeyframeInterval > 0 && m_deltasSinceKeyframe + 1 >= m_config.deltaKeyframeInterval);
+}
+
+bool ShareMemoryManager::WriteDelta(const uint8_t* data, size_t size, const DataInfo& info,
+                                    const std::vector<DirtyRect>& regions)
+{
+    uint64_t pixels = static_cast<uint64_t>(info.width) * info.height;
+    if (!data || pixels == 0 || size % pixels != 0 || info.dataType == static_cast<uint32_t>(FrameType::BUNDLE) ||
+        info.dataType == static_cast<uint32_t>(FrameType::DELTA)) {
+        Log("Delta frames need an image or height map of width x height whole pixels");
+        return false;
+    }
+    if (regions.size() > kMaxDeltaRegions) {
+        Log("A delta frame holds at most " + std::to_string(kMaxDeltaRegions) + " regions");
+        return false;
+    }
+    if (!m_pBuffer) {
+        Log("Shared memory not initialized");
+        return false;
+    }
+
+    // Resolve full width rows and check every region against the frame
+    size_t bytesPerPixel = static_cast<size_t>(size / pixels);
+    std::vector<DirtyRect> rects(regions);
+    size_t tableSize = sizeof(DeltaHeader) + sizeof(DeltaRegion) * rects.size();
+    size_t totalSize = tableSize;
+    for (DirtyRect& rect : rects) {
+        if (rect.width == 0 && rect.x < info.width) {
+            rect.width = info.width - rect.x;
+        }
+        if (static_cast<uint64_t>(rect.x) + rect.width > info.width ||
+            static_cast<uint64_t>(rect.y) + rect.height > info.height) {
+            Log("Dirty region lies outside the frame");
+            return false;
+        }
+        totalSize = AlignUp(totalSize, kCacheLineSize) + static_cast<size_t>(rect.width) * rect.height * bytesPerPixel;
+    }
+
+    if (NeedsKeyframe(size, info) || totalSize >= size) {
+        if (!WriteData(data, size, info)) {
+            return false;
+        }
+        m_deltaBaseId = m_frameId;
+        m_deltaSize = size;
+        m_deltaInfo = info;
+        m_deltasSinceKeyframe = 0;
+        return true;
+    }
+
+    if (totalSize > m_capacity) {
+        Log("Delta size exceeds buffer capacity");
+        return false;
+    }
+
+    if (m_writePending) {
+        Log("Zero-copy write in progress, commit or abort it first");
+        return false;
+    }
+
+    TraceScope trace(TraceStage::Write, m_traceChannel);
+    uint32_t slotIndex = 0;
+    if (!LockWriteSlot(slotIndex, totalSize, DefaultWriteTimeout())) {
+        return false;
+    }
+
+    bool success = false;
+    try {
+        uint8_t* buffer = GetSlotData(slotIndex);
+        DeltaHeader* header = reinterpret_cast<DeltaHeader*>(buffer);
+        DeltaRegion* entries = reinterpret_cast<DeltaRegion*>(header + 1);
+        memset(buffer, 0, tableSize);
+        header->Magic = kDeltaMagic;
+        header->RegionCount = static_cast<uint32_t>(rects.size());
+        header->BaseFrameId = m_deltaBaseId;
+        header->FullSize = size;
+        header->BytesPerPixel = static_cast<uint32_t>(bytesPerPixel);
+        header->info = info;
+
+        size_t offset = tableSize;
+        for (size_t i = 0; i < rects.size(); ++i) {
+            size_t aligned = AlignUp(offset, kCacheLineSize);
+            memset(buffer + offset, 0, aligned - offset);
+            entries[i].X = rects[i].x;
+            entries[i].Y = rects[i].y;
+            entries[i].Width = rects[i].width;
+            entries[i].Height = rects[i].height;
+            entries[i].Offset = aligned;
+            offset = aligned + static_cast<size_t>(rects[i].width) * rects[i].height * bytesPerPixel;
+        }
+
+        // Only the directory and the dirty rows are copied and hashed
+        size_t pitch = static_cast<size_t>(info.width) * bytesPerPixel;
+        Checksum checksum(m_config.checksumMode);
+        checksum.Update(buffer, tableSize);
+        offset = tableSize;
+        for (size_t i = 0; i < rects.size(); ++i) {
+            size_t aligned = static_cast<size_t>(entries[i].Offset);
+            checksum.Update(buffer + offset, aligned - offset);
+            size_t rowBytes = static_cast<size_t>(rects[i].width) * bytesPerPixel;
+            const uint8_t* src = data + rects[i].y * pitch + static_cast<size_t>(rects[i].x) * bytesPerPixel;
+            if (rowBytes == pitch) {
+                CopyWithChecksum(buffer + aligned, src, rowBytes * rects[i].height, checksum, GetCopyOptions());
+            }
+            else {
+                for (uint32_t row = 0; row < rects[i].height; ++row) {
+                    CopyWithChecksum(buffer + aligned + row * rowBytes, src + row * pitch, rowBytes, checksum,
+                                     GetCopyOptions());
+                }
+            }
+            offset = aligned + rowBytes * rects[i].height;
+        }
+
+        DataInfo deltaInfo = info;
+        deltaInfo.dataType = static_cast<uint32_t>(FrameType::DELTA);
+        PublishSlot(slotIndex, totalSize, deltaInfo, checksum.Finalize());
+        trace.SetFrame(m_frameId);
+        m_deltaBaseId = m_frameId;
+        ++m_deltasSinceKeyframe;
+        success = true;
+    }
+    catch (const std::exception& e) {
+        Log(std::string("Exception during delta write: ") + e.what());
+        success = false;
+    }
+
+    UnlockHeader();
+
+    if (success) {
+        NotifyConsumer();
+    }
+    return success;
+}
+
+bool ShareMemoryManager::WritePointCloud(const PointCloudLayout& layout, uint32_t pointCount,
+                                         const std::vector<const void*>& fields, uint64_t timestamp)
+{
+    if (layout.FieldCount() == 0 || fields.size() != layout.FieldCount()) {
+        Log("A point cloud needs one array for each field of its layout");
+        return false;
+    }
+    for (const void* field : fields) {
+        if (!field && pointCount > 0) {
+            Log("Point cloud field array is null");
+            return false;
+        }
+    }
+
+    size_t totalSize = layout.FrameSize(pointCount);
+    if (!m_pBuffer || totalSize > m_capacity) {
+        Log("Point cloud size exceeds buffer capacity");
+        return false;
+    }
+
+    if (m_writePending) {
+        Log("Zero-copy write in progress, commit or abort it first");
+        return false;
+    }
+
+    TraceScope trace(TraceStage::Write, m_traceChannel);
+    uint32_t slotIndex = 0;
+    if (!LockWriteSlot(slotIndex, totalSize, DefaultWriteTimeout())) {
+        return false;
+    }
+
+    bool success = false;
+    try {
+        uint8_t* buffer = GetSlotData(slotIndex);
+        layout.WriteDirectory(buffer, pointCount);
+
+        // Each source array lands as is, the directory and padding are hashed in between
+        size_t tableSize = sizeof(PointCloudHeader) + sizeof(PointField) * layout.FieldCount();
+        Checksum checksum(m_config.checksumMode);
+        checksum.Update(buffer, tableSize);
+        size_t offset = tableSize;
+        for (uint32_t i = 0; i < layout.FieldCount(); ++i) {
+            size_t aligned = layout.FieldOffset(i, pointCount);
+            size_t bytes = static_cast<size_t>(pointCount) * layout.Field(i).Stride;
+            checksum.Update(buffer + offset, aligned - offset);
+            CopyWithChecksum(buffer + aligned, static_cast<const uint8_t*>(fields[i]), bytes, checksum,
+                             GetCopyOptions());
+            offset = aligned + bytes;
+        }
+
+        PublishSlot(slotIndex, totalSize, PointCloudInfo(layout, pointCount, timestamp), checksum.Finalize());
+        trace.SetFrame(m_frameId);
+        success = true;
+    }
+    catch (const std::exception& e) {
+        Log(std::string("Exception during point cloud write: ") + e.what());
+        success = false;
+    }
+
+    UnlockHeader();
+
+    if (success) {
+        NotifyConsumer();
+    }
+    return success;
+}
+
+bool ShareMemoryManager::BeginPointCloud(const PointCloudLayout& layout, uint32_t pointCount,
+                                         std::vector<uint8_t*>& fields)
+{
+    fields.clear();
+    if (layout.FieldCount() == 0) {
+        Log("A point cloud layout needs at least one field");
+        return false;
+    }
+
+    uint8_t* buffer = BeginWrite(layout.FrameSize(pointCount));
+    if (!buffer) {
+        return false;
+    }
+
+    layout.WriteDirectory(buffer, pointCount);
+    for (uint32_t i = 0; i < layout.FieldCount(); ++i) {
+        fields.push_back(buffer + layout.FieldOffset(i, pointCount));
+    }
+    return true;
+}
+
+bool ShareMemoryManager::CommitPointCloud(const PointCloudLayout& layout, uint32_t pointCount, uint64_t timestamp)
+{
+    if (m_writePending && m_pendingSize != layout.FrameSize(pointCount)) {
+        Log("CommitPointCloud layout or point count differs from BeginPointCloud");
+        return false;
+    }
+    return CommitWrite(PointCloudInfo(layout, pointCount, timestamp));
+}
+
+uint8_t* ShareMemoryManager::BeginWrite(size_t size)
+{
+    if (!m_pBuffer || size > m_capacity) {
+        Log("Data size exceeds buffer capacity");
+        return nullptr;
+    }
+
+    if (m_writePending) {
+        Log("Zero-copy write already in progress");
+        return nullptr;
+    }
+
+    uint32_t slotIndex = 0;
+    if (!LockWriteSlot(slotIndex, size, DefaultWriteTimeout())) {
+        return nullptr;
+    }
+
+    m_writePending = true;
+    m_pendingSlot = slotIndex;
+    m_pendingSize = size;
+    uint8_t* buffer = GetSlotData(slotIndex);
+
+    UnlockHeader();
+    return buffer;
+}
+
+bool ShareMemoryManager::CommitWrite(const DataInfo& info)
+{
+    if (!m_writePending) {
+        Log("CommitWrite called without BeginWrite");
+        return false;
+    }
+
+    TraceScope trace(TraceStage::Write, m_traceChannel);
+    if (!LockHeader()) {
+        return false;
+    }
+
+    bool success = false;
+    try {
+        uint32_t checksum = 0;
+        {
+            TraceScope checksumTrace(TraceStage::Checksum, m_traceChannel);
+            checksum = Checksum::Compute(m_config.checksumMode, GetSlotData(m_pendingSlot), m_pendingSize);
+        }
+        PublishSlot(m_pendingSlot, m_pendingSize, info, checksum);
+        trace.SetFrame(m_frameId);
+        m_writePending = false;
+        success = true;
+    }
+    catch (const std::exception& e) {
+        Log(std::string("Exception during commit: ") + e.what());
+        success = false;
+    }
+
+    UnlockHeader();
+
+    if (success) {
+        NotifyConsumer();
+    }
+    return success;
+}
+
+void ShareMemoryManager::AbortWrite()
+{
+    if (m_writePending) {
+        // The write index was not advanced, so the slot is simply reused next time
+        SlotDescriptor* slot = GetSlot(m_pendingSlot);
+        if (IsBroadcastMode()) {
+            // The caller may have written part of its payload over the previous frame,
+            // which every reader had already released, so it must not be handed out again
+            slot->FrameId.store(0, std::memory_order_relaxed);
+            slot->DataSize = 0;
+        }
+        if (IsPoolMode()) {
+            FreeSlotBlock(m_pendingSlot);
+        }
+        slot->Status.store(static_cast<uint32_t>(MemoryStatus::Empty), std::memory_order_release);
+        m_writePending = false;
+        Log("Zero-copy write aborted");
+    }
+}
+
+bool ShareMemoryManager::ClaimWriteSlot(uint32_t& slotIndex, size_t size, bool overwrite)
+{
+    Heartbeat(true);
+
+    if (IsTripleBufferMode()) {
+        // The back buffer belongs to the writer alone, so this never fails
+        slotIndex = m_pTriple->BackIndex;
+        GetSlot(slotIndex)->Status.store(static_cast<uint32_t>(MemoryStatus::Writing), std::memory_order_relaxed);
+        return true;
+    }
+
+    if (IsBroadcastMode()) {
+        // Continue from the shared counter so several producers agree on the slot
+        m_frameId = m_pBroadcast->PublishedFrameId.load(std::memory_order_relaxed);
+        slotIndex = static_cast<uint32_t>(m_frameId % m_config.slotCount);
+        SlotDescriptor* slot = GetSlot(slotIndex);
+        uint64_t previous = slot->FrameId.load(std::memory_order_relaxed);
+
+        // A crashed reliable reader would otherwise hold the ring forever
+        // Reliable readers are never overwritten, OverwriteOldest waits for them like Wait
+        if (previous != 0 && !IsFrameReleased(previous) && !(ReclaimDeadReaders() && IsFrameReleased(previous))) {
+            Log("Broadcast ring full, a reader is lagging behind", LogLevel::Debug);
+            return false;
+        }
+
+        // Mark the slot before checking again: a reader that pinned the old frame
+        // concurrently either sees Writing or is seen by the second check
+        slot->Status.store(static_cast<uint32_t>(MemoryStatus::Writing), std::memory_order_seq_cst);
+        if (previous != 0 && !IsFrameReleased(previous)) {
+            slot->Status.store(static_cast<uint32_t>(MemoryStatus::Ready), std::memory_order_release);
+            Log("Broadcast ring full, a reader is lagging behind", LogLevel::Debug);
+            return false;
+        }
+        return true;
+    }
+
+    slotIndex = IsRingMode() ? m_pRing->WriteIndex.load(std::memory_order_relaxed) : 0;
+    SlotDescriptor* slot = GetSlot(slotIndex);
+
+    // Claim the slot: Empty -> Writing
+    uint32_t expected = static_cast<uint32_t>(MemoryStatus::Empty);
+    bool claimed = slot->Status.compare_exchange_strong(expected, static_cast<uint32_t>(MemoryStatus::Writing),
+                                                        std::memory_order_acquire);
+    if (!claimed && expected == static_cast<uint32_t>(MemoryStatus::Reading) &&
+        ReclaimStuckSlot(slotIndex, MemoryStatus::Reading)) {
+        // The consumer died holding this slot
+        expected = static_cast<uint32_t>(MemoryStatus::Empty);
+        claimed = slot->Status.compare_exchange_strong(expected, static_cast<uint32_t>(MemoryStatus::Writing),
+                                                       std::memory_order_acquire);
+    }
+    if (!claimed && overwrite && expected == static_cast<uint32_t>(MemoryStatus::Ready)) {
+        // Take back the oldest unread frame: Ready -> Writing, so a consumer can no longer claim it
+        claimed = slot->Status.compare_exchange_strong(expected, static_cast<uint32_t>(MemoryStatus::Writing),
+                                                       std::memory_order_acquire);
+        if (claimed) {
+            if (IsRingMode()) {
+                // The consumer would look for the dropped frame here next, move it on to the following one
+                uint32_t readIndex = slotIndex;
+                m_pRing->ReadIndex.compare_exchange_strong(readIndex, (slotIndex + 1) % m_config.slotCount,
+                                                           std::memory_order_acq_rel);
+                m_pRing->FrameCount.fetch_sub(1, std::memory_order_relaxed);
+            }
+            m_pStats->FramesDropped.fetch_add(1, std::memory_order_relaxed);
+            Log("Overwriting the oldest unread frame", LogLevel::Debug);
+        }
+    }
+    if (!claimed) {
+        Log(IsRingMode() ? "Ring buffer full, consumer is lagging behind"
+                         : "Memory not empty, previous data not consumed", LogLevel::Debug);
+        return false;
+    }
+
+    if (IsPoolMode()) {
+        // An overwritten frame still holds its block, it is the first candidate for the new one
+        FreeSlotBlock(slotIndex);
+        if (!AllocateSlotBlock(slotIndex, size) && !(ReclaimHeldBlocks() && AllocateSlotBlock(slotIndex, size))) {
+            // The write index stays put, the slot is claimed again once the pool has room
+            slot->Status.store(static_cast<uint32_t>(MemoryStatus::Empty), std::memory_order_release);
+            Log("Frame pool exhausted, consumer is holding too many frames", LogLevel::Debug);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ShareMemoryManager::LockWriteSlot(uint32_t& slotIndex, size_t size, uint32_t timeoutMs)
+{
+    bool overwrite = m_config.writePolicy == WritePolicy::OverwriteOldest;
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::milliseconds(timeoutMs);
+    bool waited = false;
+
+    for (;;) {
+        if (!LockHeader()) {
+            return false;
+        }
+        bool claimed = false;
+        try {
+            claimed = ClaimWriteSlot(slotIndex, size, overwrite);
+        }
+        catch (const std::exception& e) {
+            Log(std::string("Exception during write: ") + e.what());
+        }
+        if (!claimed) {
+            UnlockHeader();
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (waited) {
+            m_pStats->ThrottledNs.fetch_add(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count()), std::memory_order_relaxed);
+            start = now;
+        }
+        if (claimed) {
+            return true;
+        }
+
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+        if (remaining <= 0) {
+            m_pStats->WriteRejections.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        // One throttled write however many wait slices it takes
+        if (!waited) {
+            m_pStats->ThrottledWrites.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Wait outside the lock so the consumer can release the slot meanwhile
+        WaitForFreeSlot(static_cast<uint32_t>(std::min<long long>(remaining, m_config.waitTimeoutMs)), size);
+        waited = true;
+    }
+}
+
+uint32_t ShareMemoryManager::DefaultWriteTimeout() const
+{
+    return m_config.writePolicy == WritePolicy::Drop ? 0 : m_config.writeTimeoutMs;
+}
+
+bool ShareMemoryManager::HasFreeSlot(size_t size)
+{
+    if (IsTripleBufferMode()) {
+        return true;
+    }
+    if (IsBroadcastMode()) {
+        uint64_t frameId = m_pBroadcast->PublishedFrameId.load(std::memory_order_acquire);
+        uint64_t previous = GetSlot(static_cast<uint32_t>(frameId % m_config.slotCount))
+                                ->FrameId.load(std::memory_order_relaxed);
+        return previous == 0 || IsFrameReleased(previous);
+    }
+
+    uint32_t slotIndex = IsRingMode() ? m_pRing->WriteIndex.load(std::memory_order_relaxed) : 0;
+    uint32_t status = GetSlot(slotIndex)->Status.load(std::memory_order_acquire);
+    if (status == static_cast<uint32_t>(MemoryStatus::Ready) && m_config.writePolicy == WritePolicy::OverwriteOldest) {
+        return true;  // Overwriting hands the old frame's block to the new one
+    }
+    return status == static_cast<uint32_t>(MemoryStatus::Empty) && (!IsPoolMode() || PoolHasSpace(size));
+}
+
+void ShareMemoryManager::WaitForFreeSlot(uint32_t timeoutMs, size_t size)
+{
+    NamedEvent* freedEvent = GetFreedEvent();
+    if (!freedEvent) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return;
+    }
+
+    TraceScope trace(TraceStage::SlotWait, m_traceChannel);
+
+    // Same handshake as WaitForFrame: register first, then check, then block
+    m_pHeader->WriteWaiters.fetch_add(1);
+    if (!HasFreeSlot(size)) {
+        freedEvent->Wait(timeoutMs);
+    }
+    m_pHeader->WriteWaiters.fetch_sub(1);
+}
+
+void ShareMemoryManager::NotifyProducer()
+{
+    // Pairs with the WriteWaiters increment in WaitForFreeSlot
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_pHeader->WriteWaiters.load(std::memory_order_relaxed) != 0) {
+        NamedEvent* freedEvent = GetFreedEvent();
+        if (freedEvent) {
+            freedEvent->Signal();
+        }
+    }
+}
+
+NamedEvent* ShareMemoryManager::GetFreedEvent()
+{
+    // Released slots notify from worker threads and the monitor thread, only one may open the event
+    std::lock_guard<std::mutex> lock(m_freedMutex);
+    if (!m_freedEvent) {
+        // Whichever side needs it first creates it, the other opens the same object
+        m_freedEvent.reset(new NamedEvent());
+        if (!m_freedEvent->Open(m_name + "_freed")) {
+            m_freedEvent.reset();
+        }
+    }
+    return m_freedEvent.get();
+}
+
+void ShareMemoryManager::PublishSlot(uint32_t slotIndex, size_t size, const DataInfo& info, uint32_t checksum)
+{
+    SlotDescriptor* slot = GetSlot(slotIndex);
+
+    slot->DataSize = size;
+    slot->FrameId.store(++m_frameId, std::memory_order_relaxed);
+
+    // Copy data info
+    slot->info = info;
+
+    slot->Checksum = checksum;
+    slot->PublishTimeNs = NowNs();
+
+    // Publish: everything written above becomes visible with Ready
+    slot->Status.store(static_cast<uint32_t>(MemoryStatus::Ready), std::memory_order_release);
+
+    m_pStats->FramesWritten.fetch_add(1, std::memory_order_relaxed);
+    m_pStats->BytesWritten.fetch_add(size, std::memory_order_relaxed);
+
+    if (IsRingMode()) {
+        m_pRing->WriteIndex.store((slotIndex + 1) % m_config.slotCount, std::memory_order_relaxed);
+        m_pRing->FrameCount.fetch_add(1, std::memory_order_relaxed);
+        m_pRing->LastFrameId.store(m_frameId, std::memory_order_relaxed);
+    }
+    else if (IsBroadcastMode()) {
+        m_pBroadcast->PublishedFrameId.store(m_frameId, std::memory_order_release);
+    }
+    else if (IsTripleBufferMode()) {
+        // Swap the finished back buffer into the middle and take the old middle as the next back buffer
+        uint32_t previous = m_pTriple->Middle.exchange(slotIndex | kTripleBufferFresh, std::memory_order_acq_rel);
+        m_pTriple->BackIndex = previous & kTripleBufferIndexMask;
+        m_pTriple->LastFrameId.store(m_frameId, std::memory_order_relaxed);
+        if (previous & kTripleBufferFresh) {
+            m_pTriple->DroppedFrames.fetch_add(1, std::memory_order_relaxed);
+            m_pStats->FramesDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (!ShouldLogFrame()) {
+        return;
+    }
+
+    std::stringstream ss;
+    ss << "Data written successfully - Size: " << size 
+       << " bytes, Frame ID: " << m_frameId;
+    if (m_pSlots) {
+        ss << ", Slot: " << slotIndex;
+    }
+    ss << ", Type: ";
+    
+    switch (static_cast<FrameType>(info.dataType)) {
+        case FrameType::IMAGE:
+            ss << "Image"
+               << ", Width: " << info.width
+               << ", Height: " << info.height
+               << ", Channels: " << info.channels;
+            break;
+        case FrameType::POINTCLOUD:
+            ss << "PointCloud"
+               << ", Points: " << info.width
+               << ", Dimensions: " << info.height;
+            break;
+        case FrameType::HEIGHTMAP:
+            ss << "HeightMap"
+               << ", Width: " << info.width
+               << ", Height: " << info.height
+               << ", Spacing: [" << info.xSpacing << ", " << info.ySpacing << "]";
+            break;
+        case FrameType::BUNDLE:
+            ss << "Bundle"
+               << ", Frames: " << info.width;
+            break;
+        case FrameType::DELTA:
+            ss << "Delta"
+               << ", Width: " << info.width
+               << ", Height: " << info.height;
+            break;
+        case FrameType::COMPRESSED:
+            ss << "Compressed"
+               << ", Width: " << info.width
+               << ", Height: " << info.height;
+            break;
+        case FrameType::POINTFIELDS:
+            ss << "PointFields"
+               << ", Points: " << info.width
+               << ", Fields: " << info.height;
+            break;
+    }
+
+    Log(ss.str(), LogLevel::Debug);
+}
+
+bool ShareMemoryManager::ReadData(std::vector<uint8_t>& buffer, DataInfo& info)
+{
+    if (!ReadStoredData(buffer, info)) {
+        return false;
+    }
+    if (info.dataType != static_cast<uint32_t>(FrameType::COMPRESSED)) {
+        return true;
+    }
+
+    // The checksum covered the compressed bytes, decompress them only now
+    thread_local std::vector<uint8_t> raw;
+    raw.resize(DecompressedSize(buffer.data(), buffer.size()));
+    if (raw.empty() || !DecompressFrame(buffer.data(), buffer.size(), raw.data(), raw.size(), &info)) {
+        Log("Failed to decompress frame", LogLevel::Error);
+        return false;
+    }
+    buffer.swap(raw);
+    return true;
+}
+
+bool ShareMemoryManager::ReadStoredData(std::vector<uint8_t>& buffer, DataInfo& info)
+{
+    if (!m_pBuffer) {
+        Log("Shared memory not initialized");
+        return false;
+    }
+
+    if (IsBroadcastMode()) {
+        return ReadBroadcastData(buffer, info);
+    }
+    if (IsTripleBufferMode()) {
+        return ReadLatestData(buffer, info);
+    }
+
+    TraceScope trace(TraceStage::Read, m_traceChannel, true);
+    if (!LockHeader()) {
+        return false;
+    }
+
+    bool success = false;
+    try {
+        uint32_t slotIndex = 0;
+        if (!ClaimReadySlot(slotIndex)) {
+            success = false;
+        }
+        else {
+            SlotDescriptor* slot = GetSlot(slotIndex);
+
+            // Get data size
+            size_t dataSize = static_cast<size_t>(slot->DataSize);
+
+            // Resize buffer
+            buffer.resize(dataSize);
+
+            // Copy data and verify checksum in the same pass
+            ChecksumMode mode = GetChecksumMode();
+            uint32_t checksum = 0;
+            {
+                TraceScope copyTrace(TraceStage::Copy, m_traceChannel);
+                checksum = CopyWithChecksum(buffer.data(), GetSlotData(slotIndex), dataSize, mode, GetCopyOptions());
+            }
+            if (mode != ChecksumMode::None && checksum != slot->Checksum) {
+                Log("Checksum verification failed", LogLevel::Error);
+                m_pStats->ChecksumFailures.fetch_add(1, std::memory_order_relaxed);
+                DropCorruptSlot(slotIndex);
+                success = false;
+            }
+            else {
+                // Copy data info
+                info = slot->info;
+                uint64_t frameId = slot->FrameId.load(std::memory_order_relaxed);
+                trace.SetFrame(frameId);
+                RecordRead(*slot);
+
+                // Hand the slot back to the producer
+                ConsumeSlot(slotIndex);
+                ReleaseSlot(slotIndex);
+
+                if (ShouldLogFrame()) {
+                    std::stringstream ss;
+                    ss << "Data read successfully - Size: " << dataSize 
+                       << " bytes, Frame ID: " << frameId;
+                    if (IsRingMode()) {
+                        ss << ", Slot: " << slotIndex;
+                    }
+                    Log(ss.str(), LogLevel::Debug);
+                }
+                success = true;
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        Log(std::string("Exception during read: ") + e.what());
+        success = false;
+    }
+
+    UnlockHeader();
+    return success;
+}
+
+void ShareMemoryManager::RequestKeyframe()
+{
+    if (m_pHeader) {
+        m_pHeader->KeyframeRequest.store(1, std::memory_order_release);
+    }
+}
+
+bool ShareMemoryManager::AcquireFrame(FrameView& view)
+{
+    view.Release();
+
+    if (!m_pBuffer) {
+        Log("Shared memory not initialized");
+        return false;
+    }
+
+    if (IsBroadcastMode()) {
+        return AcquireBroadcastFrame(view);
+    }
+    if (IsTripleBufferMode()) {
+        return AcquireLatestFrame(view);
+    }
+
+    TraceScope trace(TraceStage::Acquire, m_traceChannel, true);
+    if (!LockHeader()) {
+        return false;
+    }
+
+    bool success = false;
+    try {
+        uint32_t slotIndex = 0;
+        if (!ClaimReadySlot(slotIndex)) {
+            success = false;
+        }
+        else {
+            SlotDescriptor* slot = GetSlot(slotIndex);
+            const uint8_t* data = GetSlotData(slotIndex);
+            size_t dataSize = static_cast<size_t>(slot->DataSize);
+
+            // Verify checksum in place
+            ChecksumMode mode = GetChecksumMode();
+            bool corrupted = false;
+            {
+                TraceScope checksumTrace(TraceStage::Checksum, m_traceChannel);
+                corrupted = mode != ChecksumMode::None && Checksum::Compute(mode, data, dataSize) != slot->Checksum;
+            }
+            if (corrupted) {
+                Log("Checksum verification failed", LogLevel::Error);
+                m_pStats->ChecksumFailures.fetch_add(1, std::memory_order_relaxed);
+                DropCorruptSlot(slotIndex);
+                success = false;
+            }
+            else {
+                // The slot stays Reading until the view is released
+                ConsumeSlot(slotIndex);
+
+                view.m_owner = this;
+                view.m_data = data;
+                view.m_size = dataSize;
+                view.m_info = slot->info;
+                view.m_frameId = slot->FrameId.load(std::memory_order_relaxed);
+                view.m_slotIndex = slotIndex;
+                trace.SetFrame(view.m_frameId);
+                RecordRead(*slot);
+
+                if (ShouldLogFrame()) {
+                    std::stringstream ss;
+                    ss << "Frame acquired - Size: " << dataSize
+                       << " bytes, Frame ID: " << view.m_frameId;
+                    if (IsRingMode()) {
+                        ss << ", Slot: " << slotIndex;
+                    }
+                    Log(ss.str(), LogLevel::Debug);
+                }
+                success = true;
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        Log(std::string("Exception during acquire: ") + e.what());
+        success = false;
+    }
+
+    UnlockHeader();
+    return success;
+}
+
+bool ShareMemoryManager::PinBroadcastFrame(uint32_t& slotIndex, uint64_t& frameId)
 {
-    StopMonitoring();
-    Log("Cleaning up resources");
-    if (m_pBuffer) {
-        UnmapViewOfFile(m_pBuffer);
+    if (!RegisterReader()) {
+        return false;
     }
-    if (m_hMapFile) {
-        CloseHandle(m_hMapFile);
+    Heartbeat(false);
+
+    ReaderEntry& reader = m_pReaders[m_readerIndex];
+    if (reader.Pinned.load(std::memory_order_relaxed) != 0) {
+        Log("Previous broadcast frame still held, release it first", LogLevel::Debug);
+        return false;
     }
-    if (m_hMutex) {
-        CloseHandle(m_hMutex);
+
+    for (int attempt = 0; attempt < kBroadcastPinRetries; ++attempt) {
+        uint64_t published = m_pBroadcast->PublishedFrameId.load(std::memory_order_acquire);
+        uint64_t cursor = reader.Cursor.load(std::memory_order_relaxed);
+        if (FrameIdBefore(published, cursor)) {
+            return false;  // Nothing new since our last frame
+        }
+
+        uint64_t target = cursor;
+        if (m_config.readerPolicy == ReaderPolicy::LatestOnly) {
+            target = published;
+        }
+        else if (published - cursor >= m_config.slotCount) {
+            // Only happens when frames were published before our cursor was visible
+            target = published - m_config.slotCount + 1;
+            std::stringstream ss;
+            m_pStats->FramesDropped.fetch_add(target - cursor, std::memory_order_relaxed);
+            ss << "Broadcast reader skipped " << (target - cursor) << " overwritten frames";
+            Log(ss.str(), LogLevel::Warning);
+        }
+
+        // Pin first, then confirm the slot still holds the frame (see ReaderEntry)
+        reader.Pinned.store(target, std::memory_order_seq_cst);
+        slotIndex = static_cast<uint32_t>((target - 1) % m_config.slotCount);
+        SlotDescriptor* slot = GetSlot(slotIndex);
+        if (slot->Status.load(std::memory_order_seq_cst) == static_cast<uint32_t>(MemoryStatus::Ready) &&
+            slot->FrameId.load(std::memory_order_acquire) == target) {
+            frameId = target;
+            return true;
+        }
+
+        // The producer got to the slot first or aborted a write over it, try again with a newer frame
+        reader.Pinned.store(0, std::memory_order_release);
+        reader.Cursor.store(target + 1, std::memory_order_relaxed);
+        if (m_config.readerPolicy == ReaderPolicy::Reliable) {
+            // The frame is gone for good, account for it like any other skipped frame
+            m_pStats->FramesDropped.fetch_add(1, std::memory_order_relaxed);
+            std::stringstream ss;
+            ss << "Broadcast reader lost frame " << target << " to an overwrite while pinning it";
+            Log(ss.str(), LogLevel::Warning);
+        }
     }
-    Log("ShareMemoryManager destroyed");
+    return false;
 }
 
-bool ShareMemoryManager::Initialize()
+void ShareMemoryManager::UnpinBroadcastFrame(uint64_t frameId, bool advance)
 {
-    Log("Initializing shared memory manager");
+    if (m_readerIndex < 0) {
+        return;
+    }
 
-    // Create mutex
-    m_hMutex = CreateMutexA(NULL, FALSE, (m_name + "_mutex").c_str());
-    if (m_hMutex == NULL) {
-        SetError(ErrorCode::NoError, "Failed to create mutex");
+    ReaderEntry& reader = m_pReaders[m_readerIndex];
+    if (advance) {
+        reader.Cursor.store(frameId + 1, std::memory_order_release);
+    }
+    reader.Pinned.store(0, std::memory_order_release);
+    NotifyProducer();
+}
+
+bool ShareMemoryManager::ReadBroadcastData(std::vector<uint8_t>& buffer, DataInfo& info)
+{
+    TraceScope trace(TraceStage::Read, m_traceChannel, true);
+    uint32_t slotIndex = 0;
+    uint64_t frameId = 0;
+    if (!PinBroadcastFrame(slotIndex, frameId)) {
         return false;
     }
 
-    // Create shared memory
-    m_hMapFile = CreateFileMappingA(
-        INVALID_HANDLE_VALUE,
-        NULL,
-        PAGE_READWRITE,
-        0,
-        static_cast<DWORD>(m_size),
-        m_name.c_str()
-    );
+    bool success = false;
+    bool dropped = false;
+    try {
+        SlotDescriptor* slot = GetSlot(slotIndex);
+        size_t dataSize = static_cast<size_t>(slot->DataSize);
+        buffer.resize(dataSize);
+
+        // Copy data and verify checksum in the same pass
+        ChecksumMode mode = GetChecksumMode();
+        uint32_t checksum = 0;
+        {
+            TraceScope copyTrace(TraceStage::Copy, m_traceChannel);
+            checksum = CopyWithChecksum(buffer.data(), GetSlotData(slotIndex), dataSize, mode, GetCopyOptions());
+        }
+        if (mode != ChecksumMode::None && checksum != slot->Checksum) {
+            Log("Checksum verification failed", LogLevel::Error);
+            m_pStats->ChecksumFailures.fetch_add(1, std::memory_order_relaxed);
+            m_pStats->FramesDropped.fetch_add(1, std::memory_order_relaxed);
+            dropped = true;
+        }
+        else {
+            info = slot->info;
+            trace.SetFrame(frameId);
+            RecordRead(*slot);
+            success = true;
+
+            if (ShouldLogFrame()) {
+                std::stringstream ss;
+                ss << "Data read successfully - Size: " << dataSize
+                   << " bytes, Frame ID: " << frameId
+                   << ", Slot: " << slotIndex
+                   << ", Reader: " << m_readerIndex;
+                Log(ss.str(), LogLevel::Debug);
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        Log(std::string("Exception during read: ") + e.what());
+        success = false;
+    }
+
+    // A corrupted frame is skipped like a read one, otherwise the cursor would stay on it
+    UnpinBroadcastFrame(frameId, success || dropped);
+    return success;
+}
 
-    if (m_hMapFile == NULL) {
-        SetError(ErrorCode::NoError, "Failed to create file mapping object");
+bool ShareMemoryManager::AcquireBroadcastFrame(FrameView& view)
+{
+    TraceScope trace(TraceStage::Acquire, m_traceChannel, true);
+    uint32_t slotIndex = 0;
+    uint64_t frameId = 0;
+    if (!PinBroadcastFrame(slotIndex, frameId)) {
         return false;
     }
 
-    // Map memory view
-    m_pBuffer = static_cast<uint8_t*>(
-        MapViewOfFile(m_hMapFile,
-            FILE_MAP_ALL_ACCESS,
-            0,
-            0,
-            m_size)
-    );
+    SlotDescriptor* slot = GetSlot(slotIndex);
+    const uint8_t* data = GetSlotData(slotIndex);
+    size_t dataSize = static_cast<size_t>(slot->DataSize);
 
-    if (m_pBuffer == nullptr) {
-        SetError(ErrorCode::NoError, "Failed to map view of file");
+    // Verify checksum in place
+    ChecksumMode mode = GetChecksumMode();
+    bool corrupted = false;
+    {
+        TraceScope checksumTrace(TraceStage::Checksum, m_traceChannel);
+        corrupted = mode != ChecksumMode::None && Checksum::Compute(mode, data, dataSize) != slot->Checksum;
+    }
+    if (corrupted) {
+        Log("Checksum verification failed", LogLevel::Error);
+        m_pStats->ChecksumFailures.fetch_add(1, std::memory_order_relaxed);
+        m_pStats->FramesDropped.fetch_add(1, std::memory_order_relaxed);
+        UnpinBroadcastFrame(frameId, true);
         return false;
     }
 
-    // Setup header and data pointers
-    m_pHeader = reinterpret_cast<SharedMemoryHeader*>(m_pBuffer);
-    m_pData = m_pBuffer + sizeof(SharedMemoryHeader);
+    // The frame stays pinned until the view is released
+    view.m_owner = this;
+    view.m_data = data;
+    view.m_size = dataSize;
+    view.m_info = slot->info;
+    view.m_frameId = frameId;
+    view.m_slotIndex = slotIndex;
+    trace.SetFrame(view.m_frameId);
+    RecordRead(*slot);
 
-    // Initialize header
-    m_pHeader->Magic = 0x12345678;
-    m_pHeader->Status = static_cast<uint32_t>(MemoryStatus::Empty);
-    m_pHeader->DataSize = 0;
-    m_pHeader->Checksum = 0;
-    m_pHeader->FrameId = 0;
-    
-    // Initialize data info
-    m_pHeader->info = {};  // Initialize all fields to 0 using default constructor
-    
-    // Clear error message
-    memset(m_pHeader->ErrorMsg, 0, sizeof(m_pHeader->ErrorMsg));
+    if (ShouldLogFrame()) {
+        std::stringstream ss;
+        ss << "Frame acquired - Size: " << dataSize
+           << " bytes, Frame ID: " << frameId
+           << ", Slot: " << slotIndex
+           << ", Reader: " << m_readerIndex;
+        Log(ss.str(), LogLevel::Debug);
+    }
+    return true;
+}
+
+bool ShareMemoryManager::SwapFrontSlot(uint32_t& slotIndex)
+{
+    Heartbeat(false);
+    if ((m_pTriple->Middle.load(std::memory_order_relaxed) & kTripleBufferFresh) == 0) {
+        return false;  // Nothing newer than the frame we already have
+    }
 
-    Log("Shared memory initialized successfully");
+    // Hand our front buffer back as the middle one and take the newest frame
+    uint32_t previous = m_pTriple->Middle.exchange(m_pTriple->FrontIndex, std::memory_order_acq_rel);
+    slotIndex = previous & kTripleBufferIndexMask;
+    m_pTriple->FrontIndex = slotIndex;
     return true;
 }
 
-bool ShareMemoryManager::WriteData(const uint8_t* data, size_t size, const DataInfo& info)
+bool ShareMemoryManager::ReadLatestData(std::vector<uint8_t>& buffer, DataInfo& info)
 {
-    if (!m_pBuffer || size > (m_size - sizeof(SharedMemoryHeader))) {
-        Log("Data size exceeds buffer capacity");
+    TraceScope trace(TraceStage::Read, m_traceChannel, true);
+    if (m_frontHeld) {
+        Log("Front buffer still held by a frame view, release it first", LogLevel::Debug);
         return false;
     }
 
-    // Wait for mutex
-    DWORD waitResult = WaitForSingleObject(m_hMutex, 5000);
-    if (waitResult != WAIT_OBJECT_0) {
-        Log("Failed to acquire mutex");
+    uint32_t slotIndex = 0;
+    if (!SwapFrontSlot(slotIndex)) {
         return false;
     }
 
     bool success = false;
     try {
-        // Check if memory is empty
-        if (m_pHeader->Status != static_cast<uint32_t>(MemoryStatus::Empty)) {
-            Log("Memory not empty, previous data not consumed");
-            success = false;
+        SlotDescriptor* slot = GetSlot(slotIndex);
+        size_t dataSize = static_cast<size_t>(slot->DataSize);
+        buffer.resize(dataSize);
+
+        // Copy data and verify checksum in the same pass
+        ChecksumMode mode = GetChecksumMode();
+        uint32_t checksum = 0;
+        {
+            TraceScope copyTrace(TraceStage::Copy, m_traceChannel);
+            checksum = CopyWithChecksum(buffer.data(), GetSlotData(slotIndex), dataSize, mode, GetCopyOptions());
+        }
+        if (mode != ChecksumMode::None && checksum != slot->Checksum) {
+            Log("Checksum verification failed", LogLevel::Error);
+            m_pStats->ChecksumFailures.fetch_add(1, std::memory_order_relaxed);
         }
         else {
-            // Set status to writing
-            m_pHeader->Status = static_cast<uint32_t>(MemoryStatus::Writing);
-            m_pHeader->DataSize = static_cast<uint32_t>(size);
-            m_pHeader->FrameId = ++m_frameId;
-
-            // Copy data info
-            m_pHeader->info = info;
-
-            // Copy data
-            memcpy(m_pData, data, size);
-
-            // Calculate and set checksum
-            m_pHeader->Checksum = CalculateChecksum(data, size);
-
-            // Set status to ready
-            m_pHeader->Status = static_cast<uint32_t>(MemoryStatus::Ready);
+            info = slot->info;
+            trace.SetFrame(slot->FrameId.load(std::memory_order_relaxed));
+            RecordRead(*slot);
+            success = true;
 
-            std::stringstream ss;
-            ss << "Data written successfully - Size: " << size 
-               << " bytes, Frame ID: " << m_frameId
-               << ", Type: ";
-            
-            switch (static_cast<FrameType>(info.dataType)) {
-                case FrameType::IMAGE:
-                    ss << "Image"
-                       << ", Width: " << info.width
-                       << ", Height: " << info.height
-                       << ", Channels: " << info.channels;
-                    break;
-                case FrameType::POINTCLOUD:
-                    ss << "PointCloud"
-                       << ", Points: " << info.width
-                       << ", Dimensions: " << info.height;
-                    break;
-                case FrameType::HEIGHTMAP:
-                    ss << "HeightMap"
-                       << ", Width: " << info.width
-                       << ", Height: " << info.height
-                       << ", Spacing: [" << info.xSpacing << ", " << info.ySpacing << "]";
-                    break;
+            if (ShouldLogFrame()) {
+                std::stringstream ss;
+                ss << "Data read successfully - Size: " << dataSize
+                   << " bytes, Frame ID: " << slot->FrameId.load(std::memory_order_relaxed)
+                   << ", Slot: " << slotIndex;
+                Log(ss.str(), LogLevel::Debug);
             }
-
-            Log(ss.str());
-            success = true;
         }
     }
     catch (const std::exception& e) {
-        Log(std::string("Exception during write: ") + e.what());
+        Log(std::string("Exception during read: ") + e.what());
         success = false;
     }
-
-    ReleaseMutex(m_hMutex);
     return success;
 }
 
-bool ShareMemoryManager::ReadData(std::vector<uint8_t>& buffer, DataInfo& info)
+bool ShareMemoryManager::AcquireLatestFrame(FrameView& view)
 {
-    if (!m_pBuffer) {
-        Log("Shared memory not initialized");
+    TraceScope trace(TraceStage::Acquire, m_traceChannel, true);
+    // Swapping would hand the viewed buffer back to the writer
+    if (m_frontHeld) {
+        Log("Front buffer still held by a frame view, release it first", LogLevel::Debug);
         return false;
     }
 
-    // Wait for mutex
-    DWORD waitResult = WaitForSingleObject(m_hMutex, 5000);
-    if (waitResult != WAIT_OBJECT_0) {
-        Log("Failed to acquire mutex");
+    uint32_t slotIndex = 0;
+    if (!SwapFrontSlot(slotIndex)) {
         return false;
     }
 
-    bool success = false;
-    try {
-        // Check if data is ready
-        if (m_pHeader->Status != static_cast<uint32_t>(MemoryStatus::Ready)) {
-            // Only log if status is not Empty (to reduce noise)
-            if (m_pHeader->Status != static_cast<uint32_t>(MemoryStatus::Empty)) {
-                Log("Data not ready");
-            }
-            success = false;
-        }
-        else {
-            // Get data size
-            size_t dataSize = m_pHeader->DataSize;
+    SlotDescriptor* slot = GetSlot(slotIndex);
+    const uint8_t* data = GetSlotData(slotIndex);
+    size_t dataSize = static_cast<size_t>(slot->DataSize);
 
-            // Resize buffer
-            buffer.resize(dataSize);
+    // Verify checksum in place
+    ChecksumMode mode = GetChecksumMode();
+    bool corrupted = false;
+    {
+        TraceScope checksumTrace(TraceStage::Checksum, m_traceChannel);
+        corrupted = mode != ChecksumMode::None && Checksum::Compute(mode, data, dataSize) != slot->Checksum;
+    }
+    if (corrupted) {
+        Log("Checksum verification failed", LogLevel::Error);
+        m_pStats->ChecksumFailures.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
 
-            // Copy data
-            memcpy(buffer.data(), m_pData, dataSize);
+    // The front buffer is ours until the next swap, no shared state changes on release
+    m_frontHeld = true;
+    view.m_owner = this;
+    view.m_data = data;
+    view.m_size = dataSize;
+    view.m_info = slot->info;
+    view.m_frameId = slot->FrameId.load(std::memory_order_relaxed);
+    view.m_slotIndex = slotIndex;
+    trace.SetFrame(view.m_frameId);
+    RecordRead(*slot);
 
-            // Verify checksum
-            uint32_t checksum = CalculateChecksum(buffer.data(), dataSize);
-            if (checksum != m_pHeader->Checksum) {
-                Log("Checksum verification failed");
-                success = false;
-            }
-            else {
-                // Copy data info
-                info = m_pHeader->info;
+    if (ShouldLogFrame()) {
+        std::stringstream ss;
+        ss << "Frame acquired - Size: " << dataSize
+           << " bytes, Frame ID: " << view.m_frameId
+           << ", Slot: " << slotIndex;
+        Log(ss.str(), LogLevel::Debug);
+    }
+    return true;
+}
 
-                // Set status to empty
-                m_pHeader->Status = static_cast<uint32_t>(MemoryStatus::Empty);
+bool ShareMemoryManager::ClaimReadySlot(uint32_t& slotIndex)
+{
+    Heartbeat(false);
 
-                std::stringstream ss;
-                ss << "Data read successfully - Size: " << dataSize 
-                   << " bytes, Frame ID: " << m_pHeader->FrameId;
-                Log(ss.str());
-                success = true;
-            }
+    slotIndex = IsRingMode() ? m_pRing->ReadIndex.load(std::memory_order_relaxed) : 0;
+    SlotDescriptor* slot = GetSlot(slotIndex);
+
+    // Claim the frame: Ready -> Reading
+    uint32_t status = static_cast<uint32_t>(MemoryStatus::Ready);
+    if (!slot->Status.compare_exchange_strong(status, static_cast<uint32_t>(MemoryStatus::Reading),
+                                              std::memory_order_acquire)) {
+        // A producer that died mid-write leaves the slot in Writing, free it for its successor
+        if (status == static_cast<uint32_t>(MemoryStatus::Writing)) {
+            ReclaimStuckSlot(slotIndex, MemoryStatus::Writing);
+            return false;
         }
+        // Only log unexpected states (to reduce noise)
+        if (status != static_cast<uint32_t>(MemoryStatus::Empty) &&
+            status != static_cast<uint32_t>(MemoryStatus::Reading)) {
+            Log("Data not ready", LogLevel::Debug);
+        }
+        return false;
     }
-    catch (const std::exception& e) {
-        Log(std::string("Exception during read: ") + e.what());
-        success = false;
+    if (IsRingMode() && m_pRing->ReadIndex.load(std::memory_order_acquire) != slotIndex) {
+        // The index we loaded was stale: an overwriting producer moved it on and refilled this slot
+        // with its newest frame, taking it now would deliver frames out of order
+        slot->Status.store(static_cast<uint32_t>(MemoryStatus::Ready), std::memory_order_release);
+        return false;
     }
+    return true;
+}
 
-    ReleaseMutex(m_hMutex);
-    return success;
+void ShareMemoryManager::ConsumeSlot(uint32_t slotIndex)
+{
+    if (IsRingMode()) {
+        // A producer overwriting under OverwriteOldest may have moved the index past us already
+        uint32_t readIndex = slotIndex;
+        m_pRing->ReadIndex.compare_exchange_strong(readIndex, (slotIndex + 1) % m_config.slotCount,
+                                                   std::memory_order_acq_rel);
+    }
+}
+
+void ShareMemoryManager::ReleaseSlot(uint32_t slotIndex)
+{
+    if (IsPoolMode()) {
+        // The block goes back before the slot, a producer claiming it allocates a fresh one
+        FreeSlotBlock(slotIndex);
+    }
+    GetSlot(slotIndex)->Status.store(static_cast<uint32_t>(MemoryStatus::Empty), std::memory_order_release);
+    if (IsRingMode()) {
+        m_pRing->FrameCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+    NotifyProducer();
+}
+
+void ShareMemoryManager::DropCorruptSlot(uint32_t slotIndex)
+{
+    m_pStats->FramesDropped.fetch_add(1, std::memory_order_relaxed);
+    ConsumeSlot(slotIndex);
+    ReleaseSlot(slotIndex);
+}
+
+void ShareMemoryManager::ReleaseView(const FrameView& view)
+{
+    if (IsBroadcastMode()) {
+        UnpinBroadcastFrame(view.m_frameId, true);
+    }
+    else if (IsTripleBufferMode()) {
+        m_frontHeld = false;
+    }
+    else {
+        ReleaseSlot(view.m_slotIndex);
+    }
+}
+
+ChecksumMode ShareMemoryManager::GetChecksumMode() const
+{
+    // Verify with the algorithm the producer recorded, not our own configuration
+    return static_cast<ChecksumMode>(m_pHeader->ChecksumType);
+}
+
+MappingOptions ShareMemoryManager::GetMappingOptions() const
+{
+    MappingOptions options;
+    options.largePages = m_config.largePages;
+    options.prefault = m_config.prefault;
+    options.lockPages = m_config.lockPages;
+    options.numaNode = m_config.numaNode;
+    return options;
+}
+
+CopyOptions ShareMemoryManager::GetCopyOptions() const
+{
+    CopyOptions options;
+    options.mode = m_config.copyMode;
+    options.streamingThreshold = m_config.streamingCopyThreshold;
+    options.threads = m_config.copyThreads;
+    return options;
+}
+
+void ShareMemoryManager::RecordRead(const SlotDescriptor& slot)
+{
+    m_pStats->FramesRead.fetch_add(1, std::memory_order_relaxed);
+    m_pStats->BytesRead.fetch_add(slot.DataSize, std::memory_order_relaxed);
+    m_readFrameId = slot.FrameId.load(std::memory_order_relaxed);
+
+    uint64_t published = slot.PublishTimeNs;
+    uint64_t now = NowNs();
+    if (published != 0 && now >= published) {
+        uint64_t latency = now - published;
+        m_pStats->LatencySumNs.fetch_add(latency, std::memory_order_relaxed);
+        m_pStats->LatencyHistogram[LatencyBucket(latency)].fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+ShareMemoryStatistics ShareMemoryManager::GetStatistics() const
+{
+    ShareMemoryStatistics stats;
+    if (!m_pStats) {
+        return stats;
+    }
+
+    stats.framesWritten = m_pStats->FramesWritten.load(std::memory_order_relaxed);
+    stats.framesRead = m_pStats->FramesRead.load(std::memory_order_relaxed);
+    stats.writeRejections = m_pStats->WriteRejections.load(std::memory_order_relaxed);
+    stats.checksumFailures = m_pStats->ChecksumFailures.load(std::memory_order_relaxed);
+    stats.mutexTimeouts = m_pStats->MutexTimeouts.load(std::memory_order_relaxed);
+    stats.bytesWritten = m_pStats->BytesWritten.load(std::memory_order_relaxed);
+    stats.bytesRead = m_pStats->BytesRead.load(std::memory_order_relaxed);
+    stats.framesDropped = m_pStats->FramesDropped.load(std::memory_order_relaxed);
+    stats.abandonedLocks = m_pStats->AbandonedLocks.load(std::memory_order_relaxed);
+    stats.slotsReclaimed = m_pStats->SlotsReclaimed.load(std::memory_order_relaxed);
+    stats.latencySumNs = m_pStats->LatencySumNs.load(std::memory_order_relaxed);
+    stats.throttledWrites = m_pStats->ThrottledWrites.load(std::memory_order_relaxed);
+    stats.throttledNs = m_pStats->ThrottledNs.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < kLatencyBucketCount; ++i) {
+        stats.latencyHistogram[i] = m_pStats->LatencyHistogram[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void ShareMemoryManager::ResetStatistics()
+{
+    if (!m_pStats) {
+        return;
+    }
+
+    m_pStats->Magic = kStatsMagic;
+    m_pStats->BucketCount = kLatencyBucketCount;
+    m_pStats->FramesWritten.store(0);
+    m_pStats->FramesRead.store(0);
+    m_pStats->WriteRejections.store(0);
+    m_pStats->ChecksumFailures.store(0);
+    m_pStats->MutexTimeouts.store(0);
+    m_pStats->BytesWritten.store(0);
+    m_pStats->BytesRead.store(0);
+    m_pStats->FramesDropped.store(0);
+    m_pStats->AbandonedLocks.store(0);
+    m_pStats->SlotsReclaimed.store(0);
+    m_pStats->LatencySumNs.store(0);
+    m_pStats->ThrottledWrites.store(0);
+    m_pStats->ThrottledNs.store(0);
+    for (uint32_t i = 0; i < kLatencyBucketCount; ++i) {
+        m_pStats->LatencyHistogram[i].store(0);
+    }
 }
 
-uint32_t ShareMemoryManager::CalculateChecksum(const uint8_t* data, size_t size)
+double ShareMemoryStatistics::LatencyPercentileUs(double percentile) const
 {
-    uint32_t checksum = 0;
-    for (size_t i = 0; i < size; i++) {
-        checksum = ((checksum << 5) + checksum) + data[i];
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < kLatencyBucketCount; ++i) {
+        total += latencyHistogram[i];
+    }
+    if (total == 0) {
+        return 0.0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(percentile * total + 0.5);
+    if (rank == 0) {
+        rank = 1;
     }
-    return checksum;
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < kLatencyBucketCount; ++i) {
+        seen += latencyHistogram[i];
+        if (seen >= rank) {
+            // Upper bound of bucket i is 2^i microseconds
+            return static_cast<double>(1ull << i);
+        }
+    }
+    return static_cast<double>(1ull << (kLatencyBucketCount - 1));
+}
+
+double ShareMemoryStatistics::RejectionRate() const
+{
+    uint64_t attempts = framesWritten + writeRejections;
+    return attempts > 0 ? static_cast<double>(writeRejections) / attempts : 0.0;
 }
 
 void ShareMemoryManager::SetError(ErrorCode code, const std::string& message)
 {
     m_lastError = message;
     if (m_pHeader) {
-        m_pHeader->Status = static_cast<uint32_t>(MemoryStatus::Error);
-        strncpy_s(m_pHeader->ErrorMsg, message.c_str(), sizeof(m_pHeader->ErrorMsg) - 1);
+        m_pHeader->Slot.Status.store(static_cast<uint32_t>(MemoryStatus::Error));
+        size_t length = message.copy(m_pHeader->ErrorMsg, sizeof(m_pHeader->ErrorMsg) - 1);
+        m_pHeader->ErrorMsg[length] = '\0';
     }
-    Log("ERROR: " + message);
+    Log("ERROR: " + message, LogLevel::Error);
 }
 
 void ShareMemoryManager::LogStatus(const std::string& operation)
 {
     if (!m_pHeader) return;
 
+    ShareMemoryStatistics stats = GetStatistics();
+    std::stringstream statsLine;
+    statsLine << operation << " - Written: " << stats.framesWritten
+             << ", Read: " << stats.framesRead
+             << ", Rejected: " << stats.writeRejections
+             << ", Dropped: " << stats.framesDropped
+             << ", Checksum failures: " << stats.checksumFailures
+             << ", Mutex timeouts: " << stats.mutexTimeouts
+             << ", Abandoned locks: " << stats.abandonedLocks
+             << ", Reclaimed: " << stats.slotsReclaimed
+             << ", Throttled: " << stats.throttledWrites << " (" << stats.throttledNs / 1000000 << " ms)"
+             << ", p99 latency: <" << stats.LatencyPercentileUs(0.99) << " us";
+    Log(statsLine.str());
+
     std::stringstream ss;
-    ss << operation << " - Status: ";
-    switch (static_cast<MemoryStatus>(m_pHeader->Status)) {
+    ss << operation;
+    if (IsRingMode()) {
+        ss << " - Write index: " << m_pRing->WriteIndex.load()
+           << ", Read index: " << m_pRing->ReadIndex.load()
+           << ", Pending frames: " << m_pRing->FrameCount.load() << "/" << m_pRing->MaxFrames
+           << ", Last frame: " << m_pRing->LastFrameId.load();
+        if (IsPoolMode()) {
+            FramePoolUsage pool = GetPoolUsage();
+            ss << ", Pool: " << pool.liveBytes << "/" << pool.arenaBytes << " bytes in use by "
+               << pool.liveBlocks << " blocks, " << pool.carvedBytes << " carved, "
+               << pool.freeBlocks << " free blocks";
+        }
+        Log(ss.str());
+        return;
+    }
+    if (IsTripleBufferMode()) {
+        uint32_t middle = m_pTriple->Middle.load();
+        ss << " - Back: " << m_pTriple->BackIndex
+           << ", Middle: " << (middle & kTripleBufferIndexMask)
+           << ((middle & kTripleBufferFresh) ? " (new frame)" : "")
+           << ", Front: " << m_pTriple->FrontIndex
+           << ", Last frame: " << m_pTriple->LastFrameId.load()
+           << ", Dropped: " << m_pTriple->DroppedFrames.load();
+        Log(ss.str());
+        return;
+    }
+    if (IsBroadcastMode()) {
+        ss << " - Published frame: " << m_pBroadcast->PublishedFrameId.load()
+           << ", Readers:";
+        for (uint32_t i = 0; i < m_config.maxReaders; ++i) {
+            ReaderEntry& reader = m_pReaders[i];
+            if (reader.State.load() == kReaderActive) {
+                ss << " [" << i << "] pid " << reader.ProcessId
+                   << " cursor " << reader.Cursor.load()
+                   << (reader.Policy == static_cast<uint32_t>(ReaderPolicy::LatestOnly) ? " latest" : "");
+            }
+        }
+        Log(ss.str());
+        return;
+    }
+
+    ss << " - Status: ";
+    switch (static_cast<MemoryStatus>(m_pHeader->Slot.Status.load())) {
         case MemoryStatus::Empty: ss << "Empty"; break;
         case MemoryStatus::Writing: ss << "Writing"; break;
         case MemoryStatus::Ready: ss << "Ready"; break;
+        case MemoryStatus::Reading: ss << "Reading"; break;
         case MemoryStatus::Error: ss << "Error"; break;
         default: ss << "Unknown"; break;
     }
-    ss << ", Frame: " << m_pHeader->FrameId
-       << ", Size: " << m_pHeader->DataSize;
+    ss << ", Frame: " << m_pHeader->Slot.FrameId.load()
+       << ", Size: " << m_pHeader->Slot.DataSize;
     Log(ss.str());
 }
 
-void ShareMemoryManager::Log(const std::string& message)
+void ShareMemoryManager::Log(const std::string& message, LogLevel level)
 {
-    // Get current time
-    auto now = std::chrono::system_clock::now();
-    auto now_c = std::chrono::system_clock::to_time_t(now);
-    
-    // Use localtime_s instead of localtime
-    struct tm timeinfo;
-    localtime_s(&timeinfo, &now_c);
-    
-    std::stringstream ss;
-    ss << std::put_time(&timeinfo, "%Y-%m-%d %H:%M:%S");
-
-    // Format log message
-    std::string logMessage = ss.str() + " [Producer] " + message;
-
-    // Output to console
-    std::cout << logMessage << std::endl;
+    if (level < m_config.logLevel || !m_logger) {
+        return;
+    }
+    m_logger->Write(level, message);
+}
 
-    // Write to log file
-    std::ofstream logFile("producer_log.txt", std::ios::app);
-    if (logFile.is_open()) {
-        logFile << logMessage << std::endl;
-        logFile.close();
+bool ShareMemoryManager::ShouldLogFrame()
+{
+#if SHM_LOG_MIN_LEVEL > 1
+    // Per-frame messages are compiled out
+    return false;
+#else
+    if (m_config.logLevel > LogLevel::Debug) {
+        return false;
     }
+    uint32_t interval = m_config.frameLogInterval > 0 ? m_config.frameLogInterval : 1;
+    return m_frameLogCounter.fetch_add(1, std::memory_order_relaxed) % interval == 0;
+#endif
 }
 
 bool ShareMemoryManager::ClearMemory()
@@ -321,30 +3014,32 @@ bool ShareMemoryManager::ClearMemory()
         return false;
     }
 
-    // Wait for mutex
-    DWORD waitResult = WaitForSingleObject(m_hMutex, 5000);
-    if (waitResult != WAIT_OBJECT_0) {
+    // Clearing is rare, so it takes the named mutex in every sync mode.
+    // An abandoned mutex needs no recovery here, everything is reset anyway.
+    LockResult lockResult = m_mutex->Lock(m_config.lockTimeoutMs);
+    if (lockResult == LockResult::Abandoned) {
+        m_pStats->AbandonedLocks.fetch_add(1, std::memory_order_relaxed);
+        Log("Previous mutex owner terminated", LogLevel::Warning);
+    }
+    else if (lockResult != LockResult::Acquired) {
+        m_pStats->MutexTimeouts.fetch_add(1, std::memory_order_relaxed);
         Log("Failed to acquire mutex");
         return false;
     }
 
     bool success = false;
     try {
-        // Reset header to initial state
-        m_pHeader->Magic = 0x12345678;
-        m_pHeader->Status = static_cast<uint32_t>(MemoryStatus::Empty);
-        m_pHeader->DataSize = 0;
-        m_pHeader->Checksum = 0;
-        m_pHeader->FrameId = 0;
-        
-        // Reset data info
-        m_pHeader->info = {};  // Initialize all fields to 0
+        // Reset header and all slots to initial state
+        m_pHeader->Magic = kHeaderMagic;
+        m_pHeader->Version = kHeaderVersion;
+        ResetSlots();
         
         // Clear error message
         memset(m_pHeader->ErrorMsg, 0, sizeof(m_pHeader->ErrorMsg));
 
-        // Reset frame ID counter
+        // Reset frame ID counter, the next delta has no base any more
         m_frameId = 0;
+        m_deltaBaseId = 0;
 
         Log("Shared memory cleared successfully");
         success = true;
@@ -354,7 +3049,7 @@ bool ShareMemoryManager::ClearMemory()
         success = false;
     }
 
-    ReleaseMutex(m_hMutex);
+    m_mutex->Unlock();
     return success;
 }
 
@@ -364,9 +3059,28 @@ void ShareMemoryManager::SetDataReceivedCallback(DataReceivedCallback callback)
     m_dataCallback = callback;
 }
 
+void ShareMemoryManager::SetDataReceivedCallback(FrameReceivedCallback callback)
+{
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    m_frameCallback = callback;
+}
+
+void ShareMemoryManager::SetBundleReceivedCallback(BundleReceivedCallback callback)
+{
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    m_bundleCallback = callback;
+}
+
 void ShareMemoryManager::StartMonitoring()
 {
     if (!m_isMonitoring) {
+        if (m_config.callbackThreads > 0) {
+            if (!m_workerPool) {
+                m_workerPool.reset(new FrameWorkerPool());
+            }
+            m_workerPool->Start(m_config.callbackThreads, m_config.callbackQueueDepth, m_config.overflowPolicy,
+                                m_config.callbackCpus, [this](const FrameView& view) { DispatchView(view); });
+        }
         m_isMonitoring = true;
         m_monitorThread = std::thread(&ShareMemoryManager::MonitorThreadProc, this);
     }
@@ -376,26 +3090,157 @@ void ShareMemoryManager::StopMonitoring()
 {
     if (m_isMonitoring) {
         m_isMonitoring = false;
+        // Wake the monitor thread if it is blocked on the frame event
+        if (m_event) {
+            m_event->Signal();
+        }
+        if (m_readerEvent.IsOpen()) {
+            m_readerEvent.Signal();
+        }
         if (m_monitorThread.joinable()) {
             m_monitorThread.join();
         }
+        // Frames already queued are still delivered
+        if (m_workerPool) {
+            m_workerPool->Stop();
+        }
+    }
+}
+
+bool ShareMemoryManager::SubmitToWorkers(FrameView& view)
+{
+    // A broadcast reader pins one frame and the triple buffer has one front slot,
+    // so only one view can be out at a time: wait for the workers instead of spinning
+    bool singleView = IsBroadcastMode() || IsTripleBufferMode();
+    if (singleView && m_workerPool->InFlight() > 0) {
+        m_workerPool->WaitIdle(m_config.waitTimeoutMs);
+        return false;
+    }
+
+    while (m_isMonitoring && AcquireFrame(view)) {
+        uint32_t dropped = m_workerPool->Submit(std::move(view));
+        if (dropped > 0) {
+            m_pStats->FramesDropped.fetch_add(dropped, std::memory_order_relaxed);
+            Log("Callback queue full, frame dropped", LogLevel::Debug);
+        }
+        if (singleView) {
+            break;
+        }
+    }
+    return true;
+}
+
+void ShareMemoryManager::DispatchView(const FrameView& view)
+{
+    // Copy the callbacks so several workers can run them at the same time
+    DataReceivedCallback dataCallback;
+    FrameReceivedCallback frameCallback;
+    BundleReceivedCallback bundleCallback;
+    {
+        std::lock_guard<std::mutex> lock(m_callbackMutex);
+        dataCallback = m_dataCallback;
+        frameCallback = m_frameCallback;
+        bundleCallback = m_bundleCallback;
+    }
+
+    TraceScope trace(TraceStage::Callback, m_traceChannel);
+    trace.SetFrame(view.FrameId());
+    const DataInfo& info = view.Info();
+    if (bundleCallback && info.dataType == static_cast<uint32_t>(FrameType::BUNDLE)) {
+        FrameBundle bundle;
+        if (bundle.Parse(view.Data(), view.Size(), view.FrameId())) {
+            bundleCallback(bundle);
+        }
+        else {
+            Log("Malformed bundle frame dropped", LogLevel::Warning);
+        }
     }
+    else if (frameCallback) {
+        frameCallback(view);
+    }
+    else if (dataCallback) {
+        InvokeDataCallback(dataCallback, view);
+    }
+}
+
+void ShareMemoryManager::InvokeDataCallback(const DataReceivedCallback& callback, const FrameView& view)
+{
+    const DataInfo& info = view.Info();
+    if (!view.IsCompressed()) {
+        callback(view.Data(), view.Size(), info.dataType, info.width, info.height);
+        return;
+    }
+
+    thread_local std::vector<uint8_t> raw;
+    DataInfo rawInfo;
+    raw.resize(view.RawSize());
+    if (raw.empty() || !view.Decompress(raw.data(), raw.size(), &rawInfo)) {
+        Log("Failed to decompress frame", LogLevel::Error);
+        return;
+    }
+    callback(raw.data(), raw.size(), rawInfo.dataType, rawInfo.width, rawInfo.height);
 }
 
 void ShareMemoryManager::MonitorThreadProc()
 {
     std::vector<uint8_t> buffer;
     DataInfo info;
-    const int readInterval = 50; // Increase interval to 50ms to reduce CPU usage
+    FrameView view;
+    FrameBundle bundle;
+    FrameTrace::SetThreadName("ShareMemory monitor " + m_name);
 
     while (m_isMonitoring) {
-        if (ReadData(buffer, info)) {
+        // Workers run the callbacks, this thread only keeps reading
+        if (m_workerPool && m_workerPool->IsRunning()) {
+            if (SubmitToWorkers(view)) {
+                WaitForFrame(m_config.waitTimeoutMs, &m_isMonitoring);
+            }
+            continue;
+        }
+
+        bool useViews = false;
+        {
             std::lock_guard<std::mutex> lock(m_callbackMutex);
-            if (m_dataCallback) {
-                m_dataCallback(buffer.data(), buffer.size(), info.dataType, info.width, info.height);
+            useViews = m_frameCallback || m_bundleCallback;
+        }
+
+        // Drain every ready frame so a ring buffer does not fill up between polls
+        if (useViews) {
+            while (m_isMonitoring && AcquireFrame(view)) {
+                {
+                    std::lock_guard<std::mutex> lock(m_callbackMutex);
+                    TraceScope trace(TraceStage::Callback, m_traceChannel);
+                    trace.SetFrame(view.FrameId());
+                    const DataInfo& viewInfo = view.Info();
+                    if (m_bundleCallback && viewInfo.dataType == static_cast<uint32_t>(FrameType::BUNDLE)) {
+                        if (bundle.Parse(view.Data(), view.Size(), view.FrameId())) {
+                            m_bundleCallback(bundle);
+                        }
+                        else {
+                            Log("Malformed bundle frame dropped", LogLevel::Warning);
+                        }
+                    }
+                    else if (m_frameCallback) {
+                        m_frameCallback(view);
+                    }
+                    else if (m_dataCallback) {
+                        InvokeDataCallback(m_dataCallback, view);
+                    }
+                }
+                view.Release();
+            }
+        }
+        else {
+            while (m_isMonitoring && ReadData(buffer, info)) {
+                std::lock_guard<std::mutex> lock(m_callbackMutex);
+                TraceScope trace(TraceStage::Callback, m_traceChannel);
+                trace.SetFrame(m_readFrameId);
+                if (m_dataCallback) {
+                    m_dataCallback(buffer.data(), buffer.size(), info.dataType, info.width, info.height);
+                }
             }
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(readInterval));
+        WaitForFrame(m_config.waitTimeoutMs, &m_isMonitoring);
     }
 }
 
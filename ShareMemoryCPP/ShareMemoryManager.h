@@ -7,19 +7,21 @@
 
 #pragma once
 
-#define NOMINMAX  // 防止Windows.h定义min和max宏
-// 确保Windows.h包含正确
-#ifndef WIN32_LEAN_AND_MEAN
-#define WIN32_LEAN_AND_MEAN
-#endif
-#include <windows.h> // 注意使用小写的windows.h而不是Windows.h
-
 #include <string>
 #include <vector>
 #include <mutex>
 #include <memory>
 #include <functional>
 #include <thread>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#include "Checksum.h"
+#include "FrameCodec.h"
+#include "Logger.h"
+#include "Platform.h"
+#include "PointCloudLayout.h"
 
 namespace SharedMemory {
 
@@ -28,7 +30,8 @@ namespace SharedMemory {
         Empty = 0,
         Writing = 1,
         Ready = 2,
-        Error = 3
+        Error = 3,
+        Reading = 4      ///< 消费者正在读取（无锁模式下防止多个读者同时取走同一帧）
     };
 
     // Error codes
@@ -45,9 +48,116 @@ namespace SharedMemory {
     enum class FrameType {
         IMAGE = 0,       ///< 图像数据
         POINTCLOUD = 1,  ///< 点云数据
-        HEIGHTMAP = 2    ///< 高度图数据
+        HEIGHTMAP = 2,   ///< 高度图数据
+        BUNDLE = 3,      ///< 同一次采集的多帧捆绑，数据格式见 BundleHeader
+        DELTA = 4,       ///< 相对上一帧的脏区域更新，数据格式见 DeltaHeader
+        COMPRESSED = 5,  ///< 压缩后的点云或高度图，数据格式见 CompressedHeader
+        POINTFIELDS = 6  ///< 按字段描述布局的点云（SoA数组、附加属性、量化坐标），数据格式见 PointCloudHeader
+    };
+
+    /**
+     * @brief 共享内存缓冲区布局模式
+     */
+    enum class BufferMode {
+        SingleSlot = 0,  ///< 单槽模式：一个Empty/Ready状态位，消费者取走前生产者无法写入
+        Ring = 1,        ///< 环形缓冲区模式：N个固定大小的帧槽，生产者可领先消费者最多N帧
+        Broadcast = 2,   ///< 广播模式：一写多读，每个读者在读者表中登记游标，所有读者都读过后帧槽才被复用
+        TripleBuffer = 3, ///< 三缓冲模式：写入永不阻塞，读者总是取得最近完成的一帧，旧帧被直接丢弃
+        Pool = 4         ///< 帧池模式：帧描述符按环形队列排列，每帧的数据按实际大小从共享帧池分配，读者释放帧时归还
+    };
+
+    /**
+     * @brief 广播模式下读者的取帧策略
+     */
+    enum class ReaderPolicy : uint32_t {
+        Reliable = 0,    ///< 可靠读者：不丢帧，生产者在该读者读过之前不会覆盖帧槽
+        LatestOnly = 1   ///< 最新帧读者：每次只取最新一帧，不会阻塞生产者
+    };
+
+    /**
+     * @brief 回调工作线程队列已满时的处理策略
+     */
+    enum class OverflowPolicy {
+        Block = 0,       ///< 监听线程等待队列空出，背压传递给生产者
+        DropOldest = 1,  ///< 丢弃队列中最早的帧，保留最新的帧
+        DropNewest = 2   ///< 丢弃刚读到的帧，保留已排队的帧
+    };
+
+    /**
+     * @brief 生产者没有空闲帧槽（上一帧尚未被消费）时的处理策略
+     */
+    enum class WritePolicy {
+        Drop = 0,            ///< 立即返回 false，丢弃本帧
+        Wait = 1,            ///< 阻塞在帧槽释放事件上等待消费者，最长 writeTimeoutMs
+        OverwriteOldest = 2  ///< 覆盖最早一个未读的帧（单槽/Ring模式），该帧正被读取时按 Wait 等待
+    };
+
+    /**
+     * @brief 本实例在共享内存上的角色
+     */
+    enum class Role {
+        Auto = 0,        ///< 共享内存不存在时创建并初始化，已存在时直接附加，不重置头部
+        Producer = 1,    ///< 创建或打开共享内存，并总是重新初始化头部和所有帧槽
+        Consumer = 2     ///< 只打开已存在的共享内存（OpenFileMapping），校验布局后附加，从不写入头部
     };
 
+    /**
+     * @brief 读写同步方式
+     */
+    enum class SyncMode {
+        Mutex = 0,       ///< 每次读写都获取命名互斥锁，适用于多生产者
+        LockFree = 1     ///< 单生产者单消费者，仅通过原子状态位同步，快速路径无系统调用
+    };
+
+    /**
+     * @brief 共享内存管理器配置，生产者和消费者必须使用相同的配置
+     */
+    struct ShareMemoryConfig {
+        Role role = Role::Auto;                          ///< 创建还是附加到已存在的共享内存
+        BufferMode bufferMode = BufferMode::SingleSlot;  ///< 缓冲区布局模式
+        uint32_t slotCount = 4;                          ///< 帧槽数量（Ring/Broadcast模式有效），Pool模式下为同时在途的最大帧数
+        size_t poolBytes = 0;                            ///< Pool模式的帧池大小（字节），0表示 slotCount 个最大帧；不小于一个最大帧
+        uint32_t maxReaders = 8;                         ///< 读者表容量（仅Broadcast模式有效）
+        ReaderPolicy readerPolicy = ReaderPolicy::Reliable; ///< 本实例作为广播读者时的取帧策略
+        SyncMode syncMode = SyncMode::Mutex;             ///< 读写同步方式
+        uint32_t waitTimeoutMs = 50;                     ///< 监听线程等待新帧事件的超时（毫秒），超时后重新检查状态
+        uint32_t spinMicroseconds = 0;                   ///< 监听线程阻塞前自旋检查新帧的时长（微秒），0表示不自旋
+        ChecksumMode checksumMode = ChecksumMode::Crc32c; ///< 帧数据校验算法，None表示不校验
+        CopyMode copyMode = CopyMode::Auto;              ///< 帧数据拷贝方式，Auto表示大帧使用绕过缓存的非临时存储
+        size_t streamingCopyThreshold = 4 * 1024 * 1024; ///< Auto模式下使用非临时存储的最小帧大小（字节）
+        uint32_t copyThreads = 1;                        ///< 拷贝一帧最多使用的线程数，大于1时超大帧拆分并行拷贝（仅checksumMode为None时）
+        CompressionCodec codec = CompressionCodec::None; ///< WriteData 写入点云和高度图时使用的压缩算法，读取时自动解压
+        uint32_t deltaKeyframeInterval = 30;             ///< WriteDelta 每N帧至少发送一次完整帧，使丢帧的读者恢复；0表示只在需要时发送
+
+        WritePolicy writePolicy = WritePolicy::Drop;     ///< 没有空闲帧槽时写入的处理策略
+        uint32_t writeTimeoutMs = 100;                   ///< Wait/OverwriteOldest 策略下等待帧槽释放的最长时间（毫秒）
+
+        uint32_t lockTimeoutMs = 5000;                   ///< 等待命名互斥锁的超时（毫秒）
+        uint32_t peerTimeoutMs = 2000;                   ///< 对端心跳停止超过该时长（毫秒）即视为挂起，回收其卡住的帧槽；0表示只在对端进程退出时回收
+
+        uint32_t callbackThreads = 0;                    ///< 回调工作线程数，0表示在监听线程上直接执行回调
+        uint32_t callbackQueueDepth = 2;                 ///< 等待工作线程处理的最大帧数
+        OverflowPolicy overflowPolicy = OverflowPolicy::Block; ///< 工作线程队列已满时的处理策略
+        std::vector<uint32_t> callbackCpus;              ///< 工作线程i绑定到 callbackCpus[i % size] 号CPU，为空时不绑定
+
+        std::string logFilePath = "producer_log.txt";    ///< 日志文件路径，为空时不写文件
+        LogLevel logLevel = LogLevel::Info;              ///< 运行时日志级别，Debug及以下会输出每帧日志
+        uint32_t frameLogInterval = 1;                   ///< 每帧日志的采样间隔，每N帧记录一次
+        bool logToConsole = true;                        ///< 是否同时输出到控制台
+
+        bool largePages = false;                         ///< 使用大页（SEC_LARGE_PAGES）映射，需要 SeLockMemoryPrivilege，失败时退回普通页
+        bool prefault = false;                           ///< 初始化时提交并访问映射的每一页，首帧不再承担缺页
+        bool lockPages = false;                          ///< 用 VirtualLock/mlock 把映射锁定在物理内存中，同时预取所有页
+        int32_t numaNode = -1;                           ///< 映射物理页所在的NUMA节点，-1由系统决定，kNumaCurrentNode为调用 Initialize 的线程所在节点
+    };
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                  "atomic status fields must keep the shared memory layout");
+    static_assert(ATOMIC_INT_LOCK_FREE == 2,
+                  "atomic status fields must be lock-free to work across processes");
+    static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t),
+                  "atomic statistics counters must keep the shared memory layout");
+
     /**
      * @brief 统一的数据信息结构
      */
@@ -63,26 +173,616 @@ namespace SharedMemory {
     };
     #pragma pack(pop)
 
+    const size_t kCacheLineSize = 64;          ///< 共享区域的对齐粒度，读写双方频繁修改的字段各占独立的缓存行
+    const size_t kPayloadAlignment = 4096;     ///< 帧数据区起始地址按页对齐
+
+    static_assert(kPointFieldAlignment == kCacheLineSize, "point field arrays are aligned like bundle frames");
+
     /**
-     * @brief 共享内存头部结构
+     * @brief 帧槽描述符，记录一个帧槽的状态和帧信息
+     *
+     * Status 是唯一的同步点：生产者以 release 语义写入 Ready，消费者以 acquire
+     * 语义取得 Ready 后再访问其余字段和帧数据。描述符恰好占一个缓存行，
+     * 数组中相邻的槽不会共享缓存行。
+     */
+    #pragma pack(push, 1)
+    struct SlotDescriptor {
+        std::atomic<uint32_t> Status;   ///< 槽状态，来自 MemoryStatus 枚举
+        uint32_t Checksum;              ///< 数据校验和
+        uint64_t DataSize;              ///< 数据大小（字节）
+        std::atomic<uint64_t> FrameId;  ///< 递增的帧ID
+        DataInfo info;                  ///< 统一的数据信息
+        uint64_t PublishTimeNs;         ///< 发布时刻（steady_clock纳秒），用于统计写入到读取的延迟
+    };
+    #pragma pack(pop)
+
+    static_assert(sizeof(DataInfo) % 8 == 0, "DataInfo must keep the following 64-bit fields aligned");
+    static_assert(sizeof(SlotDescriptor) == kCacheLineSize, "a slot descriptor must fill exactly one cache line");
+
+    const uint32_t kHeaderMagic = 0x324D4853;  ///< 头部魔数 ('SHM2')，与旧版 0x12345678 区分
+    const uint32_t kHeaderVersion = 4;         ///< 当前布局版本，v3 起各区域按缓存行对齐，v4 增加进程ID和心跳
+
+    /**
+     * @brief 共享内存头部结构（v4）
+     *
+     * 头部按缓存行划分：第0行是初始化后只读的布局描述，第1行是单槽模式的帧描述符，
+     * 第2行是生产者的进程ID、WriteWaiters 和心跳，第3行是消费者修改的 Waiters、进程ID、心跳和关键帧请求，
+     * 错误信息单独占最后两行。Version 紧跟在 Magic 之后，新旧版本的对端可以据此识别彼此，
+     * 拒绝不兼容的布局。
+     *
+     * 心跳为 steady_clock 纳秒，每次读写时更新。对端进程已退出，或心跳停止超过
+     * peerTimeoutMs 时，卡在 Writing/Reading 的帧槽会被回收。
      */
     #pragma pack(push, 1)
     struct SharedMemoryHeader {
-        uint32_t Magic;          ///< 用于验证的魔数 (0x12345678)
-        uint32_t Status;         ///< 内存状态，来自 MemoryStatus 枚举
-        uint32_t DataSize;       ///< 数据大小（字节）
-        uint32_t Checksum;       ///< 数据校验和
-        uint32_t FrameId;        ///< 递增的帧ID
-        DataInfo info;           ///< 统一的数据信息
-        char ErrorMsg[128];      ///< 错误信息
+        // 只读布局描述，由创建者在 Initialize 中写入
+        uint32_t Magic;          ///< 用于验证的魔数 (kHeaderMagic)
+        uint32_t Version;        ///< 布局版本 (kHeaderVersion)
+        uint32_t ChecksumType;   ///< 生产者使用的校验算法，来自 ChecksumMode 枚举
+        uint32_t BufferMode;     ///< 缓冲区布局模式，来自 BufferMode 枚举
+        uint64_t SlotCapacity;   ///< 每个帧槽的数据容量（字节）
+        uint32_t SlotCount;      ///< 帧槽数量
+        uint32_t HeaderSize;     ///< sizeof(SharedMemoryHeader)
+        uint64_t DataOffset;     ///< 帧数据区相对映射起始处的偏移
+        uint64_t MappingSize;    ///< 映射总大小
+        uint32_t Codec;          ///< 创建者配置的压缩算法，来自 CompressionCodec 枚举；每个压缩帧另有自己的 CompressedHeader
+        uint8_t Reserved0[kCacheLineSize - 52];
+
+        SlotDescriptor Slot;     ///< 单槽模式的帧描述符
+
+        // 生产者修改的字段
+        std::atomic<uint32_t> ProducerPid;          ///< 最近写入的生产者进程ID，0表示尚无
+        std::atomic<uint32_t> WriteWaiters;         ///< 正在等待帧槽释放的生产者数量，为0时消费者不触发 <name>_freed 事件
+        std::atomic<uint64_t> ProducerHeartbeatNs;  ///< 生产者最近一次写入的时刻
+        uint8_t Reserved2[kCacheLineSize - 16];
+
+        // 消费者修改的字段
+        std::atomic<uint32_t> Waiters;  ///< 正在阻塞等待新帧事件的消费者数量，为0时生产者不触发事件
+        std::atomic<uint32_t> ConsumerPid;          ///< 最近读取的消费者进程ID，0表示尚无（广播读者记录在读者表中）
+        std::atomic<uint64_t> ConsumerHeartbeatNs;  ///< 消费者最近一次读取或等待的时刻
+        std::atomic<uint32_t> KeyframeRequest;      ///< 非0表示有读者无法应用增量帧，WriteDelta 下一帧发送完整帧并清零
+        uint8_t Reserved3[kCacheLineSize - 20];
+
+        char ErrorMsg[128];      ///< 错误信息，仅在出错时写入
+    };
+    #pragma pack(pop)
+
+    static_assert(sizeof(SharedMemoryHeader) % kCacheLineSize == 0, "header must end on a cache line");
+
+    const uint32_t kLatencyBucketCount = 32;   ///< 延迟直方图桶数
+    const uint32_t kStatsMagic = 0x53544154;   ///< 统计区魔数 ('STAT')
+
+    /**
+     * @brief 运行统计区，紧跟在 SharedMemoryHeader 之后，所有模式都存在
+     *
+     * 所有字段都是原子计数器，外部监控工具或C#端可以直接映射共享内存读取，不需要获取互斥锁。
+     * 生产者和消费者更新的计数器分别位于不同的缓存行。
+     * 延迟直方图按2的幂分桶：第0桶为小于1微秒，第i桶为 [2^(i-1), 2^i) 微秒，最后一桶包含所有更大的值。
+     */
+    #pragma pack(push, 1)
+    struct SharedMemoryStats {
+        // 生产者更新的计数器
+        uint32_t Magic;                              ///< 统计区魔数 (kStatsMagic)
+        uint32_t BucketCount;                        ///< 直方图桶数 (kLatencyBucketCount)
+        std::atomic<uint64_t> FramesWritten;         ///< 成功发布的帧数
+        std::atomic<uint64_t> BytesWritten;          ///< 已发布的数据字节数
+        std::atomic<uint64_t> WriteRejections;       ///< 因帧槽未被消费而拒绝的写入次数 (MemoryNotEmpty)
+        std::atomic<uint64_t> MutexTimeouts;         ///< 等待命名互斥锁超时的次数
+        std::atomic<uint64_t> FramesDropped;         ///< 未被读取就被覆盖或跳过的帧数
+        std::atomic<uint64_t> AbandonedLocks;        ///< 互斥锁持有者异常退出后被接管的次数
+        std::atomic<uint64_t> SlotsReclaimed;        ///< 从退出或挂起的对端回收的帧槽和广播读者数
+
+        // 消费者更新的计数器
+        std::atomic<uint64_t> FramesRead;            ///< 成功读取的帧数（广播模式下每个读者各计一次）
+        std::atomic<uint64_t> BytesRead;             ///< 已读取的数据字节数
+        std::atomic<uint64_t> ChecksumFailures;      ///< 读取时校验失败的次数
+        std::atomic<uint64_t> LatencySumNs;          ///< 所有延迟样本之和，用于计算平均值
+
+        // 生产者只在等待帧槽之后更新，不影响写入的快速路径
+        std::atomic<uint64_t> ThrottledWrites;       ///< 等待过帧槽释放的写入次数
+        std::atomic<uint64_t> ThrottledNs;           ///< 生产者等待帧槽释放的总时长（纳秒）
+        uint8_t Reserved1[kCacheLineSize - 48];
+        std::atomic<uint64_t> LatencyHistogram[kLatencyBucketCount];  ///< 写入到读取的延迟分布
+    };
+    #pragma pack(pop)
+
+    static_assert(sizeof(SharedMemoryStats) % kCacheLineSize == 0, "statistics must end on a cache line");
+
+    /**
+     * @brief 统计区某一时刻的快照
+     */
+    struct ShareMemoryStatistics {
+        uint64_t framesWritten = 0;
+        uint64_t framesRead = 0;
+        uint64_t writeRejections = 0;
+        uint64_t checksumFailures = 0;
+        uint64_t mutexTimeouts = 0;
+        uint64_t bytesWritten = 0;
+        uint64_t bytesRead = 0;
+        uint64_t framesDropped = 0;
+        uint64_t abandonedLocks = 0;
+        uint64_t slotsReclaimed = 0;
+        uint64_t latencySumNs = 0;
+        uint64_t throttledWrites = 0;
+        uint64_t throttledNs = 0;
+        uint64_t latencyHistogram[kLatencyBucketCount] = {};
+
+        /**
+         * @brief 根据直方图估算延迟百分位，返回所在桶的上界（微秒）
+         * @param percentile 0到1之间的百分位，例如0.99
+         */
+        double LatencyPercentileUs(double percentile) const;
+
+        /**
+         * @brief 被拒绝的写入占全部写入尝试的比例
+         */
+        double RejectionRate() const;
+    };
+
+    /**
+     * @brief 环形缓冲区控制块，Ring/Pool模式下紧跟在统计区之后
+     *
+     * 控制块之后依次是 MaxFrames 个 SlotDescriptor 和 MaxFrames 个帧数据槽，
+     * Pool模式下帧数据槽换成 PoolControlBlock 和帧池。
+     * 写指针和读指针分别位于生产者和消费者各自的缓存行。
+     *
+     * OverwriteOldest 策略下生产者收回最早的未读帧时，把 ReadIndex 从该槽推进到下一个槽，
+     * 因此双方都以期望的旧值CAS推进读指针，失败说明对方已经移动过，不能用普通存储覆盖。
+     * 消费者占用帧槽后还要确认 ReadIndex 仍指向该槽，否则该槽已被覆盖为更新的帧。
+     */
+    #pragma pack(push, 1)
+    struct RingControlBlock {
+        // 生产者修改的字段
+        uint64_t BufferSize;                ///< 每个帧槽的数据容量（字节）
+        uint32_t MaxFrames;                 ///< 帧槽数量
+        std::atomic<uint32_t> WriteIndex;   ///< 下一个写入的槽索引，仅生产者修改
+        std::atomic<uint64_t> LastFrameId;  ///< 最后写入的帧ID
+        std::atomic<uint32_t> FrameCount;   ///< 已写入但尚未被读取的帧数量
+        uint8_t Reserved0[kCacheLineSize - 28];
+
+        // 消费者修改的字段
+        std::atomic<uint32_t> ReadIndex;    ///< 下一个读取的槽索引，由消费者推进，OverwriteOldest 下生产者也会推进，只能用CAS修改
+        uint8_t Reserved1[kCacheLineSize - 4];
+    };
+    #pragma pack(pop)
+
+    /**
+     * @brief 广播模式控制块，紧跟在统计区之后
+     *
+     * 控制块之后依次是 MaxReaders 个 ReaderEntry、MaxFrames 个 SlotDescriptor 和
+     * MaxFrames 个帧数据槽。帧ID从1开始，第k帧固定写入槽 (k - 1) % MaxFrames。
+     */
+    #pragma pack(push, 1)
+    struct BroadcastControlBlock {
+        uint64_t BufferSize;                     ///< 每个帧槽的数据容量（字节）
+        uint32_t MaxFrames;                      ///< 帧槽数量
+        uint32_t MaxReaders;                     ///< 读者表容量
+        std::atomic<uint64_t> PublishedFrameId;  ///< 最新发布的帧ID，0表示尚未发布
+        std::atomic<uint32_t> Epoch;             ///< 每次重置读者表时递增，读者据此判断是否需要重新登记
+        uint8_t Reserved[kCacheLineSize - 28];
+    };
+    #pragma pack(pop)
+
+    /**
+     * @brief 读者表项，每个广播读者占用一项（一个缓存行）
+     *
+     * 生产者覆盖第k帧之前检查所有已登记的读者：可靠读者的 Cursor 必须已越过k，
+     * 且没有读者的 Pinned 等于k。读者先写 Pinned 再复查帧槽，生产者先把帧槽
+     * 标记为 Writing 再检查 Pinned，两者至少有一方能看到对方。
+     * 读者进程退出或心跳停止超过 peerTimeoutMs 后，生产者把表项收回，不再等待该读者。
+     */
+    #pragma pack(push, 1)
+    struct ReaderEntry {
+        std::atomic<uint32_t> State;    ///< 0 空闲，1 正在登记，2 已登记
+        uint32_t Policy;                ///< 取帧策略，来自 ReaderPolicy 枚举
+        uint32_t ProcessId;             ///< 读者进程ID
+        std::atomic<uint32_t> Waiting;  ///< 读者是否正阻塞在自己的新帧事件上
+        std::atomic<uint64_t> Cursor;   ///< 下一个要读取的帧ID
+        std::atomic<uint64_t> Pinned;   ///< 正在读取的帧ID，0表示没有
+        std::atomic<uint64_t> HeartbeatNs;  ///< 读者最近一次读取或等待的时刻
+        std::atomic<uint32_t> Generation;   ///< 每次登记时递增，读者据此发现表项已被收回
+        uint8_t Reserved[kCacheLineSize - 44];
+    };
+    #pragma pack(pop)
+
+    /**
+     * @brief 三缓冲控制块，TripleBuffer模式下紧跟在统计区之后
+     *
+     * 控制块之后是3个 SlotDescriptor 和3个帧数据槽。写者独占 BackIndex 指向的槽，
+     * 读者独占 FrontIndex 指向的槽，Middle 保存第三个槽的索引，发布和读取都通过
+     * 原子交换 Middle 完成，双方都不会等待对方。三组字段各占一个缓存行。
+     */
+    #pragma pack(push, 1)
+    struct TripleBufferControlBlock {
+        // 生产者修改的字段
+        uint64_t BufferSize;                ///< 每个帧槽的数据容量（字节）
+        std::atomic<uint64_t> LastFrameId;  ///< 最后发布的帧ID
+        uint32_t BackIndex;                 ///< 写者正在写入的槽索引，仅生产者修改
+        std::atomic<uint32_t> DroppedFrames;  ///< 读者读取之前就被新帧替换掉的帧数
+        uint8_t Reserved0[kCacheLineSize - 24];
+
+        // 双方交换的字段
+        std::atomic<uint32_t> Middle;       ///< 中间槽索引，kTripleBufferFresh 位表示其中有未读的新帧
+        uint8_t Reserved1[kCacheLineSize - 4];
+
+        // 消费者修改的字段
+        uint32_t FrontIndex;                ///< 读者最近取得的槽索引，仅消费者修改
+        uint8_t Reserved2[kCacheLineSize - 4];
+    };
+    #pragma pack(pop)
+
+    const uint32_t kTripleBufferFresh = 0x4;   ///< Middle 中的新帧标志位
+    const uint32_t kTripleBufferIndexMask = 0x3;
+
+    const uint32_t kPoolMaxClasses = 64;          ///< 帧池的尺寸级别数上限，句柄的低6位是级别
+    const size_t kPoolMinBlockSize = 256;         ///< 最小尺寸级别（字节）
+    const uint64_t kPoolClassMask = kCacheLineSize - 1;
+    const uint64_t kPoolNoBlock = ~0ull;          ///< 帧槽没有持有帧池块
+    const uint64_t kPoolMaxBytes = 0xFFFFFFFFull * kCacheLineSize;  ///< 空闲链表按缓存行编号，编号为32位
+
+    /**
+     * @brief 帧池的一个尺寸级别，每个级别占一个缓存行
+     *
+     * 空闲链表是无锁栈：FreeHead 高32位是每次修改递增的标签，低32位是栈顶块的缓存行编号加1，
+     * 0表示空；每个空闲块的前4字节保存下一个空闲块的编号。标签使一个块被弹出又压回后，
+     * 持有旧栈顶的一方无法用过期的链接完成交换。
+     */
+    #pragma pack(push, 1)
+    struct PoolSizeClass {
+        uint64_t BlockSize;                 ///< 本级别每块的字节数，为缓存行的整数倍
+        std::atomic<uint64_t> FreeHead;     ///< 空闲链表栈顶（标签 | 编号）
+        std::atomic<uint32_t> FreeBlocks;   ///< 空闲链表中的块数，仅用于统计
+        std::atomic<uint32_t> TotalBlocks;  ///< 已从帧池切出的本级别块数
+        uint8_t Reserved[kCacheLineSize - 24];
+    };
+    #pragma pack(pop)
+
+    /**
+     * @brief 帧池控制块，Pool模式下紧跟在 SlotDescriptor 数组之后
+     *
+     * 控制块之后是 MaxFrames 个块句柄（与帧槽一一对应），然后是按页对齐的帧池。
+     * 句柄是块在帧池中的偏移（缓存行对齐）与尺寸级别的按位或。生产者领取帧槽后按帧大小
+     * 分配块：先复用同级别的空闲块，再从 ArenaTop 切出新块，最后借用更大级别的空闲块；
+     * 块一旦切出就固定属于它的级别。读者释放帧槽前把块压回所属级别的空闲链表，
+     * 回收卡住的帧槽时同样归还。
+     */
+    #pragma pack(push, 1)
+    struct PoolControlBlock {
+        uint64_t ArenaSize;                 ///< 帧池字节数
+        uint32_t ClassCount;                ///< 尺寸级别数
+        uint32_t Reserved0;
+        std::atomic<uint64_t> ArenaTop;     ///< 已切分成块的字节数
+        uint8_t Reserved1[kCacheLineSize - 24];
+        PoolSizeClass Classes[kPoolMaxClasses];
+    };
+    #pragma pack(pop)
+
+    /**
+     * @brief 帧池某一时刻的使用情况
+     */
+    struct FramePoolUsage {
+        uint64_t arenaBytes = 0;     ///< 帧池总字节数
+        uint64_t carvedBytes = 0;    ///< 已切分成块的字节数
+        uint64_t liveBytes = 0;      ///< 在途帧占用的块字节数（按块大小计）
+        uint32_t liveBlocks = 0;     ///< 在途帧占用的块数
+        uint32_t freeBlocks = 0;     ///< 各级别空闲链表中的块数之和
+    };
+
+    // Layout contract: ShareMemoryCS/SharedMemoryLayout.cs maps these offsets directly.
+    // Changing any of them requires a new kHeaderVersion and the same change on the C# side.
+    static_assert(sizeof(DataInfo) == 32, "layout contract: DataInfo");
+    static_assert(offsetof(SlotDescriptor, info) == 24, "layout contract: SlotDescriptor");
+    static_assert(sizeof(SharedMemoryHeader) == 384, "layout contract: SharedMemoryHeader");
+    static_assert(offsetof(SharedMemoryHeader, Slot) == 64 && offsetof(SharedMemoryHeader, ProducerPid) == 128 &&
+                  offsetof(SharedMemoryHeader, Waiters) == 192 && offsetof(SharedMemoryHeader, KeyframeRequest) == 208 &&
+                  offsetof(SharedMemoryHeader, ErrorMsg) == 256, "layout contract: SharedMemoryHeader fields");
+    static_assert(sizeof(SharedMemoryStats) == 384 && offsetof(SharedMemoryStats, FramesRead) == 64,
+                  "layout contract: SharedMemoryStats");
+    static_assert(sizeof(RingControlBlock) == 128 && offsetof(RingControlBlock, ReadIndex) == 64,
+                  "layout contract: RingControlBlock");
+    static_assert(sizeof(TripleBufferControlBlock) == 192 && offsetof(TripleBufferControlBlock, Middle) == 64 &&
+                  offsetof(TripleBufferControlBlock, FrontIndex) == 128, "layout contract: TripleBufferControlBlock");
+    static_assert(sizeof(PoolSizeClass) == 64 && offsetof(PoolSizeClass, FreeHead) == 8,
+                  "layout contract: PoolSizeClass");
+    static_assert(sizeof(PoolControlBlock) == 64 + 64 * kPoolMaxClasses && offsetof(PoolControlBlock, Classes) == 64,
+                  "layout contract: PoolControlBlock");
+
+    class ShareMemoryManager;
+    class FrameView;
+
+    const uint32_t kBundleMagic = 0x4C444E42;  ///< 'BNDL'
+    const uint32_t kMaxBundleFrames = 16;      ///< 一个捆绑中的最大帧数
+
+    /**
+     * @brief 捆绑帧的数据格式：BundleHeader | BundleEntry x FrameCount | 各帧数据（每帧按缓存行对齐）
+     *
+     * 整个捆绑作为一帧发布：一个帧ID、一次状态切换、一个覆盖全部数据的校验和。
+     */
+    #pragma pack(push, 1)
+    struct BundleHeader {
+        uint32_t Magic;                 ///< kBundleMagic
+        uint32_t FrameCount;            ///< 捆绑中的帧数
+        uint8_t Reserved[kCacheLineSize - 8];
+    };
+
+    struct BundleEntry {
+        DataInfo info;                  ///< 该帧的数据信息
+        uint64_t Offset;                ///< 该帧数据相对捆绑起始处的偏移
+        uint64_t Size;                  ///< 该帧数据大小（字节）
+        uint8_t Reserved[kCacheLineSize - sizeof(DataInfo) - 16];
     };
     #pragma pack(pop)
 
+    static_assert(sizeof(BundleHeader) == kCacheLineSize, "bundle entries must start on a cache line");
+    static_assert(sizeof(BundleEntry) == kCacheLineSize, "each bundle entry must own one cache line");
+
+    /**
+     * @brief WriteBundle 的一帧输入
+     */
+    struct BundleFrame {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        DataInfo info = {};
+    };
+
+    /**
+     * @brief 捆绑帧的只读解析结果，不拷贝数据，有效期与被解析的缓冲区相同
+     */
+    class FrameBundle {
+    public:
+        FrameBundle() : m_data(nullptr), m_count(0), m_frameId(0) {}
+
+        /**
+         * @brief 解析并校验捆绑数据，所有偏移和大小都必须落在 size 范围内
+         * @return 数据不是合法的捆绑时返回 false
+         */
+        bool Parse(const uint8_t* data, size_t size, uint64_t frameId = 0);
+
+        uint32_t Count() const { return m_count; }
+        uint64_t FrameId() const { return m_frameId; }
+        const DataInfo& Info(uint32_t index) const { return Entries()[index].info; }
+        const uint8_t* Data(uint32_t index) const { return m_data + Entries()[index].Offset; }
+        size_t Size(uint32_t index) const { return static_cast<size_t>(Entries()[index].Size); }
+
+    private:
+        const uint8_t* m_data;
+        uint32_t m_count;
+        uint64_t m_frameId;
+
+        const BundleEntry* Entries() const { return reinterpret_cast<const BundleEntry*>(m_data + sizeof(BundleHeader)); }
+    };
+
+    const uint32_t kDeltaMagic = 0x41544C44;   ///< 'DLTA'
+    const uint32_t kMaxDeltaRegions = 1024;    ///< 一个增量帧中的最大脏区域数
+
+    /**
+     * @brief 增量帧的数据格式：DeltaHeader | DeltaRegion x RegionCount | 各区域数据（每个区域按缓存行对齐）
+     *
+     * 区域数据按行紧密排列，共 Height 行、每行 Width * BytesPerPixel 字节。
+     * 目录和区域数据作为一帧校验，完整帧中未变化的部分既不拷贝也不计算校验和。
+     */
+    #pragma pack(push, 1)
+    struct DeltaHeader {
+        uint32_t Magic;                 ///< kDeltaMagic
+        uint32_t RegionCount;           ///< 脏区域数量
+        uint64_t BaseFrameId;           ///< 本增量帧所基于的帧ID，读者持有的必须正是这一帧
+        uint64_t FullSize;              ///< 完整帧的大小（字节），等于 width * height * BytesPerPixel
+        uint32_t BytesPerPixel;         ///< 每个像素（高度图为每个采样点）的字节数
+        uint32_t Reserved0;
+        DataInfo info;                  ///< 完整帧的数据信息，dataType 为原始帧类型
+    };
+
+    struct DeltaRegion {
+        uint32_t X;                     ///< 区域左上角所在列
+        uint32_t Y;                     ///< 区域左上角所在行
+        uint32_t Width;                 ///< 区域宽度（像素）
+        uint32_t Height;                ///< 区域高度（行）
+        uint64_t Offset;                ///< 区域数据相对增量帧起始处的偏移
+        uint64_t Reserved;
+    };
+    #pragma pack(pop)
+
+    static_assert(sizeof(DeltaHeader) == kCacheLineSize, "delta regions must follow the header on a cache line");
+    static_assert(sizeof(DeltaRegion) == 32, "two delta regions share one cache line");
+
+    /**
+     * @brief WriteDelta 的一个脏区域，单位为像素和行
+     * @note width 为0表示从 x 到行尾，{0, y, 0, n} 即从第y行开始的n整行
+     */
+    struct DirtyRect {
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    const uint32_t kCompressedMagic = 0x435A4C46;  ///< 'FLZC'
+
+    /**
+     * @brief 压缩帧的数据格式：CompressedHeader | 压缩数据
+     *
+     * 帧槽描述符中的 DataSize 和校验和对应压缩后的数据，原始帧的大小和数据信息记录在这里。
+     */
+    #pragma pack(push, 1)
+    struct CompressedHeader {
+        uint32_t Magic;                 ///< kCompressedMagic
+        uint32_t Codec;                 ///< 压缩算法，来自 CompressionCodec 枚举
+        uint64_t RawSize;               ///< 解压后的大小（字节）
+        uint64_t StoredSize;            ///< 紧跟在头部之后的压缩数据大小（字节）
+        uint32_t ElementSize;           ///< ShuffleLz4 的元素大小（字节）
+        uint32_t Reserved0;
+        DataInfo info;                  ///< 原始帧的数据信息
+    };
+    #pragma pack(pop)
+
+    static_assert(sizeof(CompressedHeader) == kCacheLineSize, "compressed data must start on a cache line");
+
+    /**
+     * @brief 压缩帧解压后的大小
+     * @return data 不是合法的压缩帧时返回0
+     */
+    size_t DecompressedSize(const uint8_t* data, size_t size);
+
+    /**
+     * @brief 把压缩帧解压到调用方提供的缓冲区
+     * @param capacity dst 的容量，不能小于 DecompressedSize
+     * @param info 不为空时输出原始帧的数据信息
+     * @return 数据不是合法的压缩帧或容量不足时返回 false
+     */
+    bool DecompressFrame(const uint8_t* data, size_t size, uint8_t* dst, size_t capacity, DataInfo* info = nullptr);
+
+    /**
+     * @brief 增量帧的只读解析结果，不拷贝数据，有效期与被解析的缓冲区相同
+     */
+    class DeltaFrame {
+    public:
+        DeltaFrame() : m_data(nullptr), m_frameId(0) {}
+
+        /**
+         * @brief 解析并校验增量帧，所有区域必须落在完整帧内，区域数据必须落在 size 范围内
+         * @return 数据不是合法的增量帧时返回 false
+         */
+        bool Parse(const uint8_t* data, size_t size, uint64_t frameId = 0);
+
+        uint64_t FrameId() const { return m_frameId; }
+        uint64_t BaseFrameId() const { return Header().BaseFrameId; }
+        size_t FullSize() const { return static_cast<size_t>(Header().FullSize); }
+        uint32_t BytesPerPixel() const { return Header().BytesPerPixel; }
+        const DataInfo& Info() const { return Header().info; }
+        uint32_t Count() const { return Header().RegionCount; }
+        const DeltaRegion& Region(uint32_t index) const { return Regions()[index]; }
+        const uint8_t* Data(uint32_t index) const { return m_data + Regions()[index].Offset; }
+
+        /**
+         * @brief 把所有脏区域写入完整帧缓冲区 target（至少 FullSize 字节）
+         */
+        void ApplyTo(uint8_t* target) const;
+
+    private:
+        const uint8_t* m_data;
+        uint64_t m_frameId;
+
+        const DeltaHeader& Header() const { return *reinterpret_cast<const DeltaHeader*>(m_data); }
+        const DeltaRegion* Regions() const { return reinterpret_cast<const DeltaRegion*>(m_data + sizeof(DeltaHeader)); }
+    };
+
+    /**
+     * @brief PersistentFrame::Apply 的结果
+     */
+    enum class DeltaResult {
+        Keyframe = 0,    ///< 完整帧，整个缓冲区被替换
+        Applied = 1,     ///< 增量帧，只更新了脏区域
+        OutOfSync = 2,   ///< 增量帧的基准帧不是本缓冲区当前的帧（中间丢过帧），缓冲区未改变
+        Ignored = 3      ///< 捆绑帧或格式错误的增量帧，缓冲区未改变
+    };
+
+    /**
+     * @brief 读者侧的持久帧缓冲区：完整帧整体替换，增量帧按脏区域原地更新
+     *
+     * 只有当增量帧的 BaseFrameId 等于缓冲区当前的帧ID时才会应用，返回 OutOfSync 后
+     * 应调用 ShareMemoryManager::RequestKeyframe，并继续丢弃增量帧直到收到下一个完整帧。
+     */
+    class PersistentFrame {
+    public:
+        PersistentFrame() : m_info(), m_frameId(0) {}
+
+        DeltaResult Apply(const uint8_t* data, size_t size, const DataInfo& info, uint64_t frameId);
+        DeltaResult Apply(const FrameView& view);
+
+        /**
+         * @brief 丢弃缓冲区内容，之后只接受完整帧
+         */
+        void Reset();
+
+        bool IsValid() const { return m_frameId != 0; }
+        const std::vector<uint8_t>& Data() const { return m_data; }
+        const DataInfo& Info() const { return m_info; }
+        uint64_t FrameId() const { return m_frameId; }
+
+        /**
+         * @brief 最近一次 Apply 更新的区域，完整帧为覆盖整帧的一个区域，可用于增量地更新下游数据
+         */
+        const std::vector<DirtyRect>& DirtyRegions() const { return m_dirty; }
+
+    private:
+        std::vector<uint8_t> m_data;
+        DataInfo m_info;
+        uint64_t m_frameId;
+        std::vector<DirtyRect> m_dirty;
+    };
+
+    /**
+     * @brief 共享内存中一帧数据的只读视图，直接指向映射区域，不发生拷贝
+     *
+     * 视图持有期间对应帧槽保持 Reading 状态（广播模式下帧ID被读者固定），生产者不会覆盖它；
+     * 析构或调用 Release() 时帧槽被归还。视图不能比创建它的管理器存活更久。
+     */
+    class FrameView {
+    public:
+        FrameView();
+        ~FrameView();
+
+        FrameView(FrameView&& other) noexcept;
+        FrameView& operator=(FrameView&& other) noexcept;
+        FrameView(const FrameView&) = delete;
+        FrameView& operator=(const FrameView&) = delete;
+
+        bool IsValid() const { return m_owner != nullptr; }
+        const uint8_t* Data() const { return m_data; }
+        size_t Size() const { return m_size; }
+        const DataInfo& Info() const { return m_info; }
+        uint64_t FrameId() const { return m_frameId; }
+
+        /**
+         * @brief 是否为压缩帧（dataType 为 COMPRESSED），Data() 指向的是压缩数据
+         */
+        bool IsCompressed() const { return m_info.dataType == static_cast<uint32_t>(FrameType::COMPRESSED); }
+
+        /**
+         * @brief 解压后的大小，未压缩的帧为 Size()
+         */
+        size_t RawSize() const;
+
+        /**
+         * @brief 把帧数据解压（未压缩的帧直接拷贝）到调用方提供的缓冲区，只在需要时调用
+         * @param info 不为空时输出原始帧的数据信息
+         */
+        bool Decompress(uint8_t* dst, size_t capacity, DataInfo* info = nullptr) const;
+
+        /**
+         * @brief 归还帧槽，之后视图不再有效
+         */
+        void Release();
+
+    private:
+        friend class ShareMemoryManager;
+
+        ShareMemoryManager* m_owner;
+        const uint8_t* m_data;
+        size_t m_size;
+        DataInfo m_info;
+        uint64_t m_frameId;
+        uint32_t m_slotIndex;
+    };
+
+    class ChannelSegment;
+    class FrameWorkerPool;
+
     /**
      * @brief 数据接收回调函数类型
      */
     using DataReceivedCallback = std::function<void(const uint8_t*, size_t, uint32_t, uint32_t, uint32_t)>;
 
+    /**
+     * @brief 零拷贝数据接收回调函数类型，视图在回调返回后自动释放
+     */
+    using FrameReceivedCallback = std::function<void(const FrameView&)>;
+
+    /**
+     * @brief 捆绑帧接收回调函数类型，一个捆绑只回调一次
+     */
+    using BundleReceivedCallback = std::function<void(const FrameBundle&)>;
+
     /**
      * @brief 共享内存管理器类，负责创建和管理共享内存区域
      */
@@ -91,9 +791,11 @@ namespace SharedMemory {
         /**
          * @brief 构造函数，创建或打开共享内存
          * @param name 共享内存名称
-         * @param size 共享内存大小（字节）
+         * @param size 单帧数据的最大大小（字节），Ring模式下为每个帧槽的容量
+         * @param config 缓冲区配置
          */
-        ShareMemoryManager(const std::string& name, size_t size);
+        ShareMemoryManager(const std::string& name, size_t size,
+                           const ShareMemoryConfig& config = ShareMemoryConfig());
         
         /**
          * @brief 析构函数，释放共享内存资源
@@ -101,6 +803,13 @@ namespace SharedMemory {
         ~ShareMemoryManager();
 
         bool Initialize();
+
+        /**
+         * @brief 删除 name 对应的共享内存、互斥锁和事件对象
+         * @note POSIX 下这些对象在进程退出后仍然保留，所有进程停止后调用；Windows 下不做任何事
+         */
+        static void RemoveNamedObjects(const std::string& name);
+
         /**
          * @brief 统一的数据写入接口
          * @param data 数据指针
@@ -109,21 +818,142 @@ namespace SharedMemory {
          * @return 是否成功写入
          */
         bool WriteData(const uint8_t* data, size_t size, const DataInfo& info);
+
+        /**
+         * @brief 带超时的写入：没有空闲帧槽时阻塞在帧槽释放事件上，不受 writePolicy 的 Drop 影响
+         * @param timeoutMs 最长等待时间（毫秒），0表示不等待
+         * @return 超时仍没有空闲帧槽时返回 false
+         */
+        bool WriteData(const uint8_t* data, size_t size, const DataInfo& info, uint32_t timeoutMs);
+
+        /**
+         * @brief 非阻塞写入：没有空闲帧槽时立即返回 false（OverwriteOldest 策略仍会覆盖未读的帧）
+         */
+        bool TryWriteData(const uint8_t* data, size_t size, const DataInfo& info);
+
+        /**
+         * @brief 阻塞等待下一个帧槽可写，用于按消费者的实际速率推进生产循环
+         * @param timeoutMs 最长等待时间（毫秒）
+         * @return 返回时帧槽是否可写，Pool模式下还要求帧池至少能分配一个最小的块
+         */
+        bool WaitForWritable(uint32_t timeoutMs);
+
+        /**
+         * @brief 零拷贝写入：占用一个空闲帧槽并返回其在共享内存中的可写地址
+         * @param size 即将写入的数据大小
+         * @return 可写缓冲区地址（至少 size 字节），帧槽不可用时返回 nullptr
+         * @note 必须随后调用 CommitWrite 发布或 AbortWrite 放弃，期间不能再次写入
+         */
+        uint8_t* BeginWrite(size_t size);
+
+        /**
+         * @brief 发布 BeginWrite 返回的缓冲区中已填充的数据
+         * @param info 数据信息
+         * @return 是否成功发布
+         */
+        bool CommitWrite(const DataInfo& info);
+
+        /**
+         * @brief 放弃 BeginWrite 占用的帧槽，不发布任何数据；广播模式下帧槽中原有的帧也随之作废
+         */
+        void AbortWrite();
+
+        /**
+         * @brief 把同一次采集的多帧作为一个捆绑原子地发布，只占用一个帧槽和一个帧ID
+         * @param frames 1 到 kMaxBundleFrames 帧，捆绑的时间戳取第一帧的时间戳
+         * @return 是否成功写入，总大小（含目录和对齐）不能超过单帧容量
+         */
+        bool WriteBundle(const std::vector<BundleFrame>& frames);
+
+        /**
+         * @brief 增量发布图像或高度图：只拷贝并校验 regions 标记的脏区域，作为 FrameType::DELTA 帧发布
+         * @param data 完整的当前帧，width * height 个像素
+         * @param regions 自上一次 WriteDelta 以来变化的区域，可以重叠
+         * @return 是否成功写入
+         * @note 首帧、尺寸或类型变化、距上一个完整帧满 deltaKeyframeInterval 帧、有读者请求关键帧、
+         *       本实例在两次 WriteDelta 之间发布过其他帧，或脏区域不比完整帧小时，自动改为发送完整帧
+         */
+        bool WriteDelta(const uint8_t* data, size_t size, const DataInfo& info,
+                        const std::vector<DirtyRect>& regions);
+
+        /**
+         * @brief 按字段布局发布一帧点云（FrameType::POINTFIELDS），每个字段的数组直接拷贝到帧槽中，不做转置
+         * @param fields 每个字段一个数组，第 i 个数组为 pointCount * Components 个该字段类型的值
+         * @return 是否成功写入，总大小（含目录和对齐）不能超过单帧容量
+         */
+        bool WritePointCloud(const PointCloudLayout& layout, uint32_t pointCount,
+                             const std::vector<const void*>& fields, uint64_t timestamp);
+
+        /**
+         * @brief 零拷贝写入结构化点云：占用帧槽并写好头部和字段目录
+         * @param fields 输出每个字段数组在共享内存中的可写地址，按缓存行对齐
+         * @return 帧槽不可用时返回 false
+         * @note 必须随后以相同的布局和点数调用 CommitPointCloud，或调用 AbortWrite 放弃
+         */
+        bool BeginPointCloud(const PointCloudLayout& layout, uint32_t pointCount, std::vector<uint8_t*>& fields);
+
+        /**
+         * @brief 发布 BeginPointCloud 填充的点云
+         */
+        bool CommitPointCloud(const PointCloudLayout& layout, uint32_t pointCount, uint64_t timestamp);
         
         /**
-         * @brief 统一的数据读取接口
+         * @brief 统一的数据读取接口，压缩帧在读取时解压
          * @param buffer 输出缓冲区
-         * @param info 输出数据信息
+         * @param info 输出数据信息，压缩帧为原始帧的数据信息
          * @return 是否成功读取
          */
         bool ReadData(std::vector<uint8_t>& buffer, DataInfo& info);
 
+        /**
+         * @brief 零拷贝读取接口，获取指向共享内存中下一帧的视图
+         * @param view 输出视图，释放前帧槽不会被生产者覆盖
+         * @return 是否成功获取
+         */
+        bool AcquireFrame(FrameView& view);
+
+        /**
+         * @brief 请求生产者的下一次 WriteDelta 发送完整帧，PersistentFrame 返回 OutOfSync 后调用
+         */
+        void RequestKeyframe();
+
+        /**
+         * @brief 不使用监听线程时阻塞等待新帧，先自旋 spinMicroseconds 再等待新帧事件
+         * @param timeoutMs 最长等待时间（毫秒）
+         * @return 返回时是否有帧可读
+         */
+        bool WaitForData(uint32_t timeoutMs);
+
+        /**
+         * @brief 在广播读者表中登记本实例，首次读取时会自动调用
+         * @return 是否登记成功，读者表已满时返回 false
+         * @note 可靠读者从登记之后发布的下一帧开始读取
+         */
+        bool RegisterReader();
+
+        /**
+         * @brief 从广播读者表中注销，之后生产者不再为本实例保留帧槽
+         */
+        void UnregisterReader();
+
         /**
          * @brief 设置数据接收回调函数
          * @param callback 回调函数
          */
         void SetDataReceivedCallback(DataReceivedCallback callback);
 
+        /**
+         * @brief 设置零拷贝数据接收回调函数，设置后监听线程优先使用该回调
+         * @param callback 回调函数
+         */
+        void SetDataReceivedCallback(FrameReceivedCallback callback);
+
+        /**
+         * @brief 设置捆绑帧接收回调函数，捆绑帧不再交给其他回调
+         * @param callback 回调函数
+         */
+        void SetBundleReceivedCallback(BundleReceivedCallback callback);
+
         /**
          * @brief 启动监听线程
          */
@@ -135,8 +965,30 @@ namespace SharedMemory {
         void StopMonitoring();
 
         std::string GetLastError() const { return m_lastError; }
+
+        /**
+         * @brief 本实例最近一次发布的帧ID，尚未写入时为附加时共享内存中的最新帧ID
+         */
+        uint64_t GetLastFrameId() const { return m_frameId; }
         void LogStatus(const std::string& operation);
 
+        /**
+         * @brief 读取共享内存中的运行统计，不获取互斥锁
+         * @return 未初始化时返回全0的快照
+         */
+        ShareMemoryStatistics GetStatistics() const;
+
+        /**
+         * @brief 读取帧池的使用情况，不获取互斥锁
+         * @return 非Pool模式或未初始化时返回全0
+         */
+        FramePoolUsage GetPoolUsage() const;
+
+        /**
+         * @brief 将统计区所有计数器清零
+         */
+        void ResetStatistics();
+
         /**
          * @brief 清空共享内存，将状态重置为Empty
          * @return 是否成功清空
@@ -145,24 +997,376 @@ namespace SharedMemory {
 
     private:
         std::string m_name;
-        size_t m_size;
-        HANDLE m_hMapFile;
+        ShareMemoryConfig m_config;
+        std::shared_ptr<AsyncLogger> m_logger;
+        std::atomic<uint32_t> m_frameLogCounter;   ///< 每帧日志采样计数
+        size_t m_capacity;           ///< 单帧数据容量
+        size_t m_slotStride;         ///< 相邻帧槽数据之间的字节间隔
+        size_t m_dataOffset;         ///< 帧数据区相对映射起始处的偏移
+        size_t m_size;               ///< 映射总大小
+        SharedMapping m_mapping;
+        bool m_ownsMapping;          ///< 映射和同步对象由本实例创建，作为 ChannelSegment 的通道时由段持有
         uint8_t* m_pBuffer;
         SharedMemoryHeader* m_pHeader;
+        SharedMemoryStats* m_pStats; ///< 运行统计区
+        RingControlBlock* m_pRing;   ///< 环形缓冲区控制块（仅Ring模式）
+        SlotDescriptor* m_pSlots;    ///< 帧槽描述符数组（Ring/Broadcast模式）
+        BroadcastControlBlock* m_pBroadcast;  ///< 广播控制块（仅Broadcast模式）
+        ReaderEntry* m_pReaders;     ///< 读者表（仅Broadcast模式）
+        TripleBufferControlBlock* m_pTriple;  ///< 三缓冲控制块（仅TripleBuffer模式）
+        PoolControlBlock* m_pPool;   ///< 帧池控制块（仅Pool模式）
+        std::atomic<uint64_t>* m_pPoolBlocks;  ///< 每个帧槽持有的帧池块句柄（仅Pool模式）
+        std::atomic<bool> m_frontHeld;  ///< 三缓冲模式下是否有视图正在引用前台槽，工作线程释放视图时写入
         uint8_t* m_pData;
-        HANDLE m_hMutex;
+        std::shared_ptr<NamedMutex> m_mutex;  ///< 头部互斥锁，名称为 <name>_mutex，作为通道时与段共享
+        std::shared_ptr<NamedEvent> m_event;  ///< 新帧事件（自动重置），名称为 <name>_event
+        std::unique_ptr<NamedEvent> m_freedEvent;  ///< 帧槽释放事件（自动重置），名称为 <name>_freed，首次需要时打开
+        std::mutex m_freedMutex;     ///< 保护 m_freedEvent 的打开，工作线程和监听线程都可能释放帧槽
         std::string m_lastError;
-        uint32_t m_frameId;
+        uint64_t m_frameId;
+        uint64_t m_readFrameId;      ///< 本实例最近一次读到的帧ID，拷贝路径的回调追踪用它关联帧
+        uint32_t m_processId;        ///< 本进程ID，写入头部和读者表的心跳字段
+        uint32_t m_traceChannel;     ///< 追踪事件中的通道ID，见 FrameTrace::RegisterChannel
+
+        // 广播读者状态
+        int32_t m_readerIndex;       ///< 本实例在读者表中的位置，-1表示未登记
+        uint32_t m_readerEpoch;      ///< 登记时的 BroadcastControlBlock::Epoch
+        uint32_t m_readerGeneration; ///< 登记时的 ReaderEntry::Generation
+        NamedEvent m_readerEvent;    ///< 本读者的新帧事件，名称为 <name>_reader<index>
+        std::vector<std::unique_ptr<NamedEvent>> m_readerEvents;  ///< 生产者缓存的各读者事件
+
+        // 增量发布状态
+        uint64_t m_deltaBaseId;      ///< WriteDelta 最近发布的帧ID，0表示还没有可作为基准的帧
+        size_t m_deltaSize;          ///< 基准帧的大小
+        DataInfo m_deltaInfo;        ///< 基准帧的数据信息
+        uint32_t m_deltasSinceKeyframe;
+
+        // 零拷贝写入状态
+        bool m_writePending;
+        uint32_t m_pendingSlot;
+        size_t m_pendingSize;
 
         // 新增成员变量
-        bool m_isMonitoring;
+        std::atomic<bool> m_isMonitoring;
         std::thread m_monitorThread;
         DataReceivedCallback m_dataCallback;
+        FrameReceivedCallback m_frameCallback;
+        BundleReceivedCallback m_bundleCallback;
         std::mutex m_callbackMutex;
+        std::unique_ptr<FrameWorkerPool> m_workerPool;  ///< callbackThreads > 0 时执行回调的工作线程
+
+        friend class FrameView;
+        friend class ChannelSegment;
+
+        // Pool mode keeps its descriptors in the same queue as Ring mode, only the payload differs
+        bool IsRingMode() const { return m_config.bufferMode == BufferMode::Ring || IsPoolMode(); }
+        bool IsPoolMode() const { return m_config.bufferMode == BufferMode::Pool; }
+        bool IsBroadcastMode() const { return m_config.bufferMode == BufferMode::Broadcast; }
+        bool IsTripleBufferMode() const { return m_config.bufferMode == BufferMode::TripleBuffer; }
+        bool IsLockFree() const { return m_config.syncMode == SyncMode::LockFree; }
+        SlotDescriptor* GetSlot(uint32_t index);
+        uint8_t* GetSlotData(uint32_t index);
+        void ResetSlot(SlotDescriptor& slot);
+        void ResetSlots();
+
+        /**
+         * @brief 将下一个待写入的槽从 Empty 切换为 Writing
+         * @param slotIndex 输出被占用的槽索引
+         * @param size 要写入的字节数，Pool模式下据此分配帧池块
+         * @param overwrite 槽中是未读的帧时是否把它收回覆盖（单槽/Ring/Pool模式）
+         */
+        bool ClaimWriteSlot(uint32_t& slotIndex, size_t size, bool overwrite);
+
+        /**
+         * @brief 获取头部访问权并占用一个帧槽，没有空闲帧槽时在锁外等待最多 timeoutMs 后重试
+         * @return 成功时仍持有头部访问权，调用方写完后调用 UnlockHeader
+         */
+        bool LockWriteSlot(uint32_t& slotIndex, size_t size, uint32_t timeoutMs);
+
+        /**
+         * @brief writePolicy 对应的默认等待时间，Drop 为0
+         */
+        uint32_t DefaultWriteTimeout() const;
 
-        uint32_t CalculateChecksum(const uint8_t* data, size_t size);
+        /**
+         * @brief 下一个待写入的槽是否可以占用，不获取互斥锁
+         * @param size Pool模式下还要求帧池能分配出这么大的块
+         */
+        bool HasFreeSlot(size_t size);
+
+        /**
+         * @brief 登记为 WriteWaiters 并等待帧槽释放事件，最长 timeoutMs
+         */
+        void WaitForFreeSlot(uint32_t timeoutMs, size_t size);
+
+        /**
+         * @brief 按 m_capacity 划分尺寸级别并清空帧池，所有帧槽都不持有块
+         */
+        void ResetPool();
+
+        /**
+         * @brief 能容纳 size 字节的最小尺寸级别，超出最大级别时返回 ClassCount
+         */
+        uint32_t FindPoolClass(size_t size) const;
+
+        /**
+         * @brief 从帧池分配一个至少 size 字节的块
+         * @param handle 输出块句柄
+         */
+        bool AllocatePoolBlock(size_t size, uint64_t& handle);
+        bool PopPoolBlock(uint32_t classIndex, uint64_t& handle);
+        void FreePoolBlock(uint64_t handle);
+
+        /**
+         * @brief 帧池当前能否分配 size 字节，不修改帧池
+         */
+        bool PoolHasSpace(size_t size) const;
+
+        /**
+         * @brief 为刚占用的帧槽分配帧池块（仅Pool模式）
+         */
+        bool AllocateSlotBlock(uint32_t slotIndex, size_t size);
+
+        /**
+         * @brief 把帧槽持有的帧池块归还帧池，槽不持有块时什么也不做（仅Pool模式）
+         */
+        void FreeSlotBlock(uint32_t slotIndex);
+
+        /**
+         * @brief 归还帧槽或推进广播游标后唤醒等待中的生产者
+         */
+        void NotifyProducer();
+
+        /**
+         * @brief 获取（必要时打开）帧槽释放事件
+         */
+        NamedEvent* GetFreedEvent();
+
+        /**
+         * @brief 填写帧描述符和校验和，将槽切换为 Ready 并推进写指针
+         */
+        void PublishSlot(uint32_t slotIndex, size_t size, const DataInfo& info, uint32_t checksum);
+
+        /**
+         * @brief 将下一个待读取的槽从 Ready 切换为 Reading
+         * @param slotIndex 输出被占用的槽索引
+         */
+        bool ClaimReadySlot(uint32_t& slotIndex);
+
+        /**
+         * @brief 读指针越过已占用的槽，后续读取从下一个槽开始
+         */
+        void ConsumeSlot(uint32_t slotIndex);
+
+        /**
+         * @brief 将读取完成的槽归还给生产者
+         */
+        void ReleaseSlot(uint32_t slotIndex);
+
+        /**
+         * @brief 丢弃校验失败的帧：越过并归还该槽，计入 FramesDropped
+         * @note 放回 Ready 会让读指针停在坏帧上，监听线程被反复唤醒而无法前进
+         */
+        void DropCorruptSlot(uint32_t slotIndex);
+
+        /**
+         * @brief 归还视图占用的帧槽或广播帧
+         */
+        void ReleaseView(const FrameView& view);
+
+        /**
+         * @brief 广播模式下第 frameId 帧是否已被所有读者读过，可以覆盖
+         */
+        bool IsFrameReleased(uint64_t frameId);
+
+        /**
+         * @brief 广播读者选择下一帧并固定它，防止生产者在读取期间覆盖
+         * @param slotIndex 输出帧所在的槽索引
+         * @param frameId 输出被固定的帧ID
+         */
+        bool PinBroadcastFrame(uint32_t& slotIndex, uint64_t& frameId);
+
+        /**
+         * @brief 广播读者读完一帧后推进游标并解除固定
+         * @param advance 是否推进游标，校验失败时为 false
+         */
+        void UnpinBroadcastFrame(uint64_t frameId, bool advance);
+
+        /**
+         * @brief 按缓冲区模式读取帧槽中存储的数据，不解压
+         */
+        bool ReadStoredData(std::vector<uint8_t>& buffer, DataInfo& info);
+
+        /**
+         * @brief 把已校验、拷贝和发布的数据写入一个帧槽，WriteData 压缩后由它完成实际写入
+         */
+        bool WriteStoredData(const uint8_t* data, size_t size, const DataInfo& info, uint32_t timeoutMs);
+
+        /**
+         * @brief 按 codec 配置压缩一帧点云或高度图
+         * @param stored 输出 CompressedHeader 加压缩数据
+         * @return 不需要压缩、压缩后没有变小或超出帧槽容量时返回 false，调用方写入原始数据
+         */
+        bool CompressFrame(const uint8_t* data, size_t size, const DataInfo& info, std::vector<uint8_t>& stored);
+
+        /**
+         * @brief 调用数据回调，压缩帧先解压
+         */
+        void InvokeDataCallback(const DataReceivedCallback& callback, const FrameView& view);
+
+        bool ReadBroadcastData(std::vector<uint8_t>& buffer, DataInfo& info);
+        bool AcquireBroadcastFrame(FrameView& view);
+
+        /**
+         * @brief 三缓冲读者与中间槽交换，取得最近完成的一帧
+         * @param slotIndex 输出前台槽索引
+         * @return 没有新帧时返回 false
+         */
+        bool SwapFrontSlot(uint32_t& slotIndex);
+
+        bool ReadLatestData(std::vector<uint8_t>& buffer, DataInfo& info);
+
+        /**
+         * @brief WriteDelta 是否必须发送完整帧，会清除共享内存中的关键帧请求
+         */
+        bool NeedsKeyframe(size_t size, const DataInfo& info);
+        bool AcquireLatestFrame(FrameView& view);
+
+        /**
+         * @brief 生产者获取（必要时打开）指定读者的新帧事件
+         */
+        NamedEvent* GetReaderEvent(uint32_t readerIndex);
+
+        /**
+         * @brief 下一个待读取的槽是否已经Ready，不获取互斥锁
+         */
+        bool HasPendingFrame();
+
+        /**
+         * @brief 发布新帧后唤醒阻塞中的消费者
+         */
+        void NotifyConsumer();
+
+        /**
+         * @brief 等待新帧：先自旋 spinMicroseconds，再阻塞在新帧事件上直到超时
+         * @param running 不为空时，变为 false 后立即返回
+         */
+        void WaitForFrame(uint32_t timeoutMs, const std::atomic<bool>* running);
+
+        /**
+         * @brief 把可读的帧视图提交给工作线程，队列满时按 overflowPolicy 处理
+         * @return 调用方是否应等待新帧事件
+         */
+        bool SubmitToWorkers(FrameView& view);
+
+        /**
+         * @brief 在工作线程上按帧类型调用对应的回调，不持有 m_callbackMutex
+         */
+        void DispatchView(const FrameView& view);
+
+        /**
+         * @brief 登记为新帧事件的等待者，返回需要等待的事件；之后必须调用 EndWait
+         */
+        NamedEvent* BeginWait();
+        void EndWait();
+
+        /**
+         * @brief 获取头部访问权，Mutex模式下等待命名互斥锁，LockFree模式下直接返回
+         */
+        bool LockHeader();
+        void UnlockHeader();
+
+        /**
+         * @brief 更新本实例在头部（广播读者为读者表项）中的进程ID和心跳
+         * @param producer 写入路径为 true，读取和等待路径为 false
+         */
+        void Heartbeat(bool producer);
+
+        /**
+         * @brief 对端是否仍然存活：心跳新鲜，或进程未退出且心跳停止未超过 peerTimeoutMs
+         */
+        bool IsPeerAlive(uint32_t processId, uint64_t heartbeatNs) const;
+
+        /**
+         * @brief 帧槽卡在 stuck 状态且其持有方（Writing 为生产者，Reading 为消费者）已不存活时，将其归还为 Empty
+         * @return 是否回收了帧槽
+         */
+        bool ReclaimStuckSlot(uint32_t slotIndex, MemoryStatus stuck);
+
+        /**
+         * @brief 收回进程已退出或挂起的广播读者表项
+         * @return 是否收回了表项
+         */
+        bool ReclaimDeadReaders();
+
+        /**
+         * @brief 回收已退出或挂起的消费者仍在读取的帧槽及其帧池块（仅Pool模式）
+         * @return 是否回收了任何帧槽
+         */
+        bool ReclaimHeldBlocks();
+
+        /**
+         * @brief 附加到已有共享内存或接管被遗弃的互斥锁后，回收所有卡住的帧槽和读者表项
+         */
+        void RecoverStuckSlots();
+
+        /**
+         * @brief 记录一次成功读取：帧数、字节数、写入到读取的延迟和读到的帧ID
+         */
+        void RecordRead(const SlotDescriptor& slot);
+
+        /**
+         * @brief 检查已存在的共享内存头部与本实例的布局是否兼容
+         * @param peer 对端进程初始化的头部
+         */
+        bool CheckPeerLayout(const SharedMemoryHeader& peer);
+
+        /**
+         * @brief 创建（或打开同名的）共享内存并映射，必要时使用大页
+         * @param alreadyExists 输出共享内存是否已由其他进程创建
+         * @param largePages 输出是否实际使用了大页
+         */
+        bool CreateMapping(bool& alreadyExists, bool& largePages);
+
+        /**
+         * @brief 打开已存在的共享内存并映射整个区域，不存在时失败
+         */
+        bool OpenMapping();
+
+        /**
+         * @brief 检查预取、锁页和NUMA放置是否按配置生效，未生效时记录警告
+         */
+        void CheckMappingOptions();
+
+        /**
+         * @brief 在互斥锁保护下决定附加或初始化，并设置各区域指针
+         * @param alreadyExists 共享内存是否已由其他进程创建
+         */
+        bool AttachOrInitialize(bool alreadyExists);
+
+        /**
+         * @brief 附加到正在运行的共享内存时，从头部恢复生产者的帧ID，使新写入的帧ID继续递增
+         */
+        void ResumeFrameId();
+
+        /**
+         * @brief 作为 ChannelSegment 的一个通道初始化：使用段映射中 base 起始的区域，
+         *        互斥锁和新帧事件由段共享，调用方需持有段的互斥锁
+         * @param alreadyExists 段是否已由其他进程创建
+         */
+        bool InitializeChannel(uint8_t* base, std::shared_ptr<NamedMutex> mutex, std::shared_ptr<NamedEvent> event,
+                               bool alreadyExists);
+
+        ChecksumMode GetChecksumMode() const;
+        CopyOptions GetCopyOptions() const;
+        MappingOptions GetMappingOptions() const;
         void SetError(ErrorCode code, const std::string& message);
-        void Log(const std::string& message);
+        void Log(const std::string& message, LogLevel level = LogLevel::Info);
+
+        /**
+         * @brief 是否记录本帧的读写日志，综合编译期级别、运行时级别和采样间隔
+         */
+        bool ShouldLogFrame();
         
         /**
          * @brief 监听线程函数
@@ -0,0 +1,295 @@
+/**
+ * @file TypedFrames.h
+ * @brief 按帧类型在编译期特化的发布者/订阅者封装，避免直接解释原始字节
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+#pragma once
+
+#include <type_traits>
+#include <atomic>
+#include <cstdint>
+
+#include "ShareMemoryManager.h"
+
+namespace SharedMemory {
+
+    /**
+     * @brief 图像帧，像素按 RGBRGB... 交错存储
+     */
+    struct ImageFrame {
+        const uint8_t* pixels = nullptr;  ///< width * height * channels 个字节
+        uint32_t width = 0;               ///< 图像宽度（像素）
+        uint32_t height = 0;              ///< 图像高度（像素）
+        uint32_t channels = 0;            ///< 通道数（1=灰度图，3=RGB，4=RGBA）
+        uint64_t timestamp = 0;           ///< 时间戳
+    };
+
+    /**
+     * @brief 点云帧，坐标按 XYZXYZ... 交错存储
+     */
+    struct PointCloudFrame {
+        const float* points = nullptr;    ///< pointCount * dimensions 个浮点数
+        uint32_t pointCount = 0;          ///< 点的数量
+        uint32_t dimensions = 3;          ///< 点维度（3=XYZ）
+        uint64_t timestamp = 0;           ///< 时间戳
+    };
+
+    /**
+     * @brief 高度图帧，高度值按行优先存储
+     */
+    struct HeightMapFrame {
+        const float* heights = nullptr;   ///< width * height 个浮点数
+        uint32_t width = 0;               ///< 宽度方向的点数
+        uint32_t height = 0;              ///< 高度方向的点数
+        float xSpacing = 0.0f;            ///< X方向的采样间距（米）
+        float ySpacing = 0.0f;            ///< Y方向的采样间距（米）
+        uint64_t timestamp = 0;           ///< 时间戳
+    };
+
+    /**
+     * @brief 帧类型特性：帧类型与 DataInfo、元素类型和数据大小之间的映射
+     *
+     * 只为支持的帧类型提供特化，对其他类型实例化 Publisher/Subscriber 会在编译期报错。
+     */
+    template <typename T>
+    struct FrameTraits;
+
+    template <>
+    struct FrameTraits<ImageFrame> {
+        using Element = uint8_t;
+        static constexpr FrameType kType = FrameType::IMAGE;
+
+        static const Element* Data(const ImageFrame& frame) { return frame.pixels; }
+
+        static size_t ElementCount(const DataInfo& info)
+        {
+            return static_cast<size_t>(info.width) * info.height * info.channels;
+        }
+
+        static DataInfo MakeInfo(const ImageFrame& frame)
+        {
+            DataInfo info = {};
+            info.width = frame.width;
+            info.height = frame.height;
+            info.channels = frame.channels;
+            info.dataType = static_cast<uint32_t>(kType);
+            info.timestamp = frame.timestamp;
+            return info;
+        }
+
+        static ImageFrame FromInfo(const DataInfo& info, const Element* data)
+        {
+            ImageFrame frame;
+            frame.pixels = data;
+            frame.width = info.width;
+            frame.height = info.height;
+            frame.channels = info.channels;
+            frame.timestamp = info.timestamp;
+            return frame;
+        }
+    };
+
+    template <>
+    struct FrameTraits<PointCloudFrame> {
+        using Element = float;
+        static constexpr FrameType kType = FrameType::POINTCLOUD;
+
+        static const Element* Data(const PointCloudFrame& frame) { return frame.points; }
+
+        static size_t ElementCount(const DataInfo& info)
+        {
+            return static_cast<size_t>(info.width) * info.height;
+        }
+
+        static DataInfo MakeInfo(const PointCloudFrame& frame)
+        {
+            DataInfo info = {};
+            info.width = frame.pointCount;
+            info.height = frame.dimensions;
+            info.dataType = static_cast<uint32_t>(kType);
+            info.timestamp = frame.timestamp;
+            return info;
+        }
+
+        static PointCloudFrame FromInfo(const DataInfo& info, const Element* data)
+        {
+            PointCloudFrame frame;
+            frame.points = data;
+            frame.pointCount = info.width;
+            frame.dimensions = info.height;
+            frame.timestamp = info.timestamp;
+            return frame;
+        }
+    };
+
+    template <>
+    struct FrameTraits<HeightMapFrame> {
+        using Element = float;
+        static constexpr FrameType kType = FrameType::HEIGHTMAP;
+
+        static const Element* Data(const HeightMapFrame& frame) { return frame.heights; }
+
+        static size_t ElementCount(const DataInfo& info)
+        {
+            return static_cast<size_t>(info.width) * info.height;
+        }
+
+        static DataInfo MakeInfo(const HeightMapFrame& frame)
+        {
+            DataInfo info = {};
+            info.width = frame.width;
+            info.height = frame.height;
+            info.xSpacing = frame.xSpacing;
+            info.ySpacing = frame.ySpacing;
+            info.dataType = static_cast<uint32_t>(kType);
+            info.timestamp = frame.timestamp;
+            return info;
+        }
+
+        static HeightMapFrame FromInfo(const DataInfo& info, const Element* data)
+        {
+            HeightMapFrame frame;
+            frame.heights = data;
+            frame.width = info.width;
+            frame.height = info.height;
+            frame.xSpacing = info.xSpacing;
+            frame.ySpacing = info.ySpacing;
+            frame.timestamp = info.timestamp;
+            return frame;
+        }
+    };
+
+    /**
+     * @brief 对帧类型特性做编译期检查，Publisher/Subscriber 实例化时触发
+     */
+    template <typename T>
+    struct CheckedFrameTraits : FrameTraits<T> {
+        using Element = typename FrameTraits<T>::Element;
+
+        static_assert(std::is_trivially_copyable<Element>::value,
+                      "frame elements are copied byte-wise through shared memory");
+        static_assert(kCacheLineSize % alignof(Element) == 0,
+                      "slot payloads are only cache line aligned");
+        static_assert(!std::is_same<Element, float>::value || sizeof(float) == 4,
+                      "point clouds and height maps are transferred as 32-bit floats");
+        static_assert(sizeof(DataInfo) == 32, "DataInfo must match the shared memory layout");
+
+        static size_t ByteSize(const DataInfo& info)
+        {
+            return FrameTraits<T>::ElementCount(info) * sizeof(Element);
+        }
+    };
+
+    /**
+     * @brief 类型化的生产者，按帧类型生成 DataInfo 并计算数据大小
+     */
+    template <typename T>
+    class Publisher {
+    public:
+        using Traits = CheckedFrameTraits<T>;
+        using Element = typename Traits::Element;
+
+        explicit Publisher(ShareMemoryManager& manager) : m_manager(manager) {}
+
+        /**
+         * @brief 拷贝写入一帧，数据大小由帧的尺寸决定
+         */
+        bool Publish(const T& frame)
+        {
+            DataInfo info = Traits::MakeInfo(frame);
+            return m_manager.WriteData(reinterpret_cast<const uint8_t*>(Traits::Data(frame)),
+                                       Traits::ByteSize(info), info);
+        }
+
+        /**
+         * @brief 零拷贝写入：按帧的尺寸占用帧槽，返回可写的元素数组
+         * @param shape 帧尺寸，数据指针字段被忽略
+         * @return 可写缓冲区，帧槽不可用时返回 nullptr
+         */
+        Element* BeginFrame(const T& shape)
+        {
+            return reinterpret_cast<Element*>(m_manager.BeginWrite(Traits::ByteSize(Traits::MakeInfo(shape))));
+        }
+
+        /**
+         * @brief 发布 BeginFrame 返回的缓冲区，shape 必须与 BeginFrame 时一致
+         */
+        bool CommitFrame(const T& shape) { return m_manager.CommitWrite(Traits::MakeInfo(shape)); }
+
+        void AbortFrame() { m_manager.AbortWrite(); }
+
+    private:
+        ShareMemoryManager& m_manager;
+    };
+
+    /**
+     * @brief 类型化的消费者，回调直接收到对应的帧结构
+     *
+     * 回调为模板参数，在调用处内联，不经过 std::function。帧类型不符或大小与尺寸
+     * 不一致的帧被跳过并计入 MismatchedFrames()。帧数据指向共享内存，仅在回调期间有效。
+     */
+    template <typename T>
+    class Subscriber {
+    public:
+        using Traits = CheckedFrameTraits<T>;
+        using Element = typename Traits::Element;
+
+        explicit Subscriber(ShareMemoryManager& manager) : m_manager(manager), m_mismatchedFrames(0) {}
+
+        /**
+         * @brief 处理当前所有可读的帧，不阻塞
+         * @param handler 签名为 void(const T&) 的可调用对象
+         * @return 交给回调的帧数
+         */
+        template <typename Handler>
+        size_t Poll(Handler&& handler)
+        {
+            size_t handled = 0;
+            FrameView view;
+            while (m_manager.AcquireFrame(view)) {
+                if (Dispatch(view, handler)) {
+                    ++handled;
+                }
+                view.Release();
+            }
+            return handled;
+        }
+
+        /**
+         * @brief 在调用线程上循环接收，直到 running 变为 false
+         * @param timeoutMs 每次等待新帧的超时（毫秒），决定停止的响应时间
+         */
+        template <typename Handler>
+        void Run(Handler&& handler, const std::atomic<bool>& running, uint32_t timeoutMs = 50)
+        {
+            while (running) {
+                Poll(handler);
+                if (running) {
+                    m_manager.WaitForData(timeoutMs);
+                }
+            }
+        }
+
+        uint64_t MismatchedFrames() const { return m_mismatchedFrames; }
+
+    private:
+        ShareMemoryManager& m_manager;
+        uint64_t m_mismatchedFrames;
+
+        template <typename Handler>
+        bool Dispatch(const FrameView& view, Handler& handler)
+        {
+            const DataInfo& info = view.Info();
+            if (info.dataType != static_cast<uint32_t>(Traits::kType) ||
+                view.Size() != Traits::ByteSize(info)) {
+                ++m_mismatchedFrames;
+                return false;
+            }
+            handler(Traits::FromInfo(info, reinterpret_cast<const Element*>(view.Data())));
+            return true;
+        }
+    };
+
+} // namespace SharedMemory
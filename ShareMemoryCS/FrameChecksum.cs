@@ -0,0 +1,157 @@
+/**
+ * @file FrameChecksum.cs
+ * @brief 帧数据校验算法，与C++端 Checksum.cpp 的结果逐位一致
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+namespace ShareMemoryCS
+{
+    /// <summary>
+    /// 直接在映射的共享内存上计算校验和，不拷贝数据
+    /// </summary>
+    public static unsafe class FrameChecksum
+    {
+        private const uint Crc32cPoly = 0x82F63B78u;
+
+        private const uint Prime1 = 2654435761u;
+        private const uint Prime2 = 2246822519u;
+        private const uint Prime3 = 3266489917u;
+        private const uint Prime4 = 668265263u;
+        private const uint Prime5 = 374761393u;
+
+        // Slice-by-8 tables, table[0] is the classic byte-wise CRC32C table
+        private static readonly uint[] Crc32cTable = BuildCrc32cTable();
+
+        /// <summary>
+        /// 按对端记录的算法计算校验和
+        /// </summary>
+        public static uint Compute(ChecksumMode mode, byte* data, ulong size)
+        {
+            switch (mode)
+            {
+                case ChecksumMode.Legacy: return Legacy(data, size);
+                case ChecksumMode.Crc32c: return Crc32c(data, size);
+                case ChecksumMode.XxHash32: return XxHash32(data, size);
+                default: return 0;
+            }
+        }
+
+        private static uint Legacy(byte* data, ulong size)
+        {
+            uint checksum = 0;
+            for (ulong i = 0; i < size; i++)
+            {
+                checksum = ((checksum << 5) + checksum) + data[i];
+            }
+            return checksum;
+        }
+
+        private static uint Crc32c(byte* data, ulong size)
+        {
+            uint crc = 0xFFFFFFFFu;
+            fixed (uint* table = Crc32cTable)
+            {
+                // Eight bytes per step, the C++ side uses the SSE4.2 instruction for the same polynomial
+                while (size >= 8)
+                {
+                    uint low = *(uint*)data ^ crc;
+                    uint high = *(uint*)(data + 4);
+                    crc = table[7 * 256 + (low & 0xFF)] ^ table[6 * 256 + ((low >> 8) & 0xFF)] ^
+                          table[5 * 256 + ((low >> 16) & 0xFF)] ^ table[4 * 256 + (low >> 24)] ^
+                          table[3 * 256 + (high & 0xFF)] ^ table[2 * 256 + ((high >> 8) & 0xFF)] ^
+                          table[1 * 256 + ((high >> 16) & 0xFF)] ^ table[high >> 24];
+                    data += 8;
+                    size -= 8;
+                }
+                while (size > 0)
+                {
+                    crc = table[(crc ^ *data) & 0xFF] ^ (crc >> 8);
+                    data++;
+                    size--;
+                }
+            }
+            return crc ^ 0xFFFFFFFFu;
+        }
+
+        private static uint XxHash32(byte* data, ulong size)
+        {
+            byte* p = data;
+            byte* end = data + size;
+            uint hash;
+            if (size >= 16)
+            {
+                uint v1 = unchecked(Prime1 + Prime2), v2 = Prime2, v3 = 0, v4 = unchecked(0u - Prime1);
+                byte* limit = end - 16;
+                while (p <= limit)
+                {
+                    v1 = XxRound(v1, *(uint*)p);
+                    v2 = XxRound(v2, *(uint*)(p + 4));
+                    v3 = XxRound(v3, *(uint*)(p + 8));
+                    v4 = XxRound(v4, *(uint*)(p + 12));
+                    p += 16;
+                }
+                hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+            }
+            else
+            {
+                hash = Prime5;
+            }
+            hash += (uint)size;
+
+            while (p + 4 <= end)
+            {
+                hash += *(uint*)p * Prime3;
+                hash = RotateLeft(hash, 17) * Prime4;
+                p += 4;
+            }
+            while (p < end)
+            {
+                hash += *p * Prime5;
+                hash = RotateLeft(hash, 11) * Prime1;
+                p++;
+            }
+            hash ^= hash >> 15;
+            hash *= Prime2;
+            hash ^= hash >> 13;
+            hash *= Prime3;
+            hash ^= hash >> 16;
+            return hash;
+        }
+
+        private static uint XxRound(uint acc, uint input)
+        {
+            acc += input * Prime2;
+            acc = RotateLeft(acc, 13);
+            return acc * Prime1;
+        }
+
+        private static uint RotateLeft(uint value, int bits)
+        {
+            return (value << bits) | (value >> (32 - bits));
+        }
+
+        private static uint[] BuildCrc32cTable()
+        {
+            var table = new uint[8 * 256];
+            for (uint i = 0; i < 256; i++)
+            {
+                uint crc = i;
+                for (int bit = 0; bit < 8; bit++)
+                {
+                    crc = (crc & 1) != 0 ? (crc >> 1) ^ Crc32cPoly : crc >> 1;
+                }
+                table[i] = crc;
+            }
+            for (int slice = 1; slice < 8; slice++)
+            {
+                for (int i = 0; i < 256; i++)
+                {
+                    uint previous = table[(slice - 1) * 256 + i];
+                    table[slice * 256 + i] = (previous >> 8) ^ table[previous & 0xFF];
+                }
+            }
+            return table;
+        }
+    }
+}
@@ -33,7 +33,8 @@ namespace ShareMemoryCS
     {
         private SharedMemoryManager _sharedMemory;
         private DispatcherTimer _statusTimer;
-        private const int SHARED_MEMORY_SIZE = 1024 * 1024 * 10; // 10MB
+        private WriteableBitmap _bitmap;
+        private long _framesShown;
         private const string SHARED_MEMORY_NAME = "TestSharedMemory";
 
         /// <summary>
@@ -51,11 +52,12 @@ namespace ShareMemoryCS
             try
             {
                 Log("正在初始化共享内存管理器...");
-                _sharedMemory = new SharedMemoryManager(SHARED_MEMORY_NAME, SHARED_MEMORY_SIZE);
-                _sharedMemory.DataReceived += SharedMemory_DataReceived;
-                
+                _sharedMemory = new SharedMemoryManager(SHARED_MEMORY_NAME);
+
                 if (_sharedMemory.Initialize())
                 {
+                    // Frames are pulled once per WPF render pass, straight from the mapping into the bitmap
+                    CompositionTarget.Rendering += CompositionTarget_Rendering;
                     Log("共享内存管理器初始化成功");
                     UpdateStatus("已连接");
                 }
@@ -85,9 +87,9 @@ namespace ShareMemoryCS
             try
             {
                 // 更新UI状态
-                if (_sharedMemory != null)
+                if (_sharedMemory != null && _sharedMemory.IsInitialized)
                 {
-                    txtStatus.Text = "已连接";
+                    txtStatus.Text = $"已连接 - 已显示 {_framesShown} 帧";
                 }
                 else
                 {
@@ -100,39 +102,30 @@ namespace ShareMemoryCS
             }
         }
 
-        private void SharedMemory_DataReceived(object sender, DataReceivedEventArgs e)
+        private void CompositionTarget_Rendering(object sender, EventArgs e)
         {
             try
             {
-                switch (e.DataType)
+                // Drain every ready frame so the producer is never held back by the display rate
+                while (_sharedMemory.TryAcquireFrame(out FrameView frame))
                 {
-                    case DataType.Image:
-                        if (e.Width > 0 && e.Height > 0 && e.Data.Length == e.Width * e.Height * 3)
-                        {
-                            ProcessImageFrame(e.Data, (int)e.Width, (int)e.Height);
-                            Log($"成功处理图像帧: {e.Width}x{e.Height}");
-                        }
-                        else
+                    try
+                    {
+                        switch (frame.DataType)
                         {
-                            Log($"无效的图像数据: 宽度={e.Width}, 高度={e.Height}, 数据大小={e.Data.Length}");
-                        }
-                        break;
+                            case FrameType.Image:
+                                ProcessImageFrame(frame);
+                                break;
 
-                    case DataType.PointCloud:
-                        if (e.Width > 0 && e.Height > 0 && e.Data.Length == e.Width * e.Height)
-                        {
-                            ProcessPointCloudFrame(e.Data, (int)e.Width, (int)e.Height);
-                            Log($"成功处理点云数据: 点数={e.Width}, 点大小={e.Height}字节");
-                        }
-                        else
-                        {
-                            Log($"无效的点云数据: 点数={e.Width}, 点大小={e.Height}, 数据大小={e.Data.Length}");
+                            case FrameType.PointCloud:
+                                ProcessPointCloudFrame(frame);
+                                break;
                         }
-                        break;
-
-                    default:
-                        Log($"未知的数据类型: {e.DataType}");
-                        break;
+                    }
+                    finally
+                    {
+                        frame.Release();
+                    }
                 }
             }
             catch (Exception ex)
@@ -141,50 +134,45 @@ namespace ShareMemoryCS
             }
         }
 
-        private void ProcessImageFrame(byte[] data, int width, int height)
+        private void ProcessImageFrame(FrameView frame)
         {
-            try
+            int width = (int)frame.Info.Width;
+            int height = (int)frame.Info.Height;
+            int channels = (int)frame.Info.Channels;
+            PixelFormat format;
+            switch (channels)
             {
-                // 直接使用原始数据，不需要跳过宽度和高度信息
-                byte[] imageData = new byte[width * height * 3];
-                Array.Copy(data, 0, imageData, 0, imageData.Length);
-
-                // 固定图像数据
-                var handle = GCHandle.Alloc(imageData, GCHandleType.Pinned);
-                try
-                {
-                    var bitmap = BitmapSource.Create(
-                        width,
-                        height,
-                        96,
-                        96,
-                        PixelFormats.Rgb24,
-                        null,
-                        handle.AddrOfPinnedObject(),
-                        imageData.Length,
-                        width * 3);
+                case 1: format = PixelFormats.Gray8; break;
+                case 3: format = PixelFormats.Rgb24; break;
+                case 4: format = PixelFormats.Bgra32; break;
+                default:
+                    Log($"不支持的图像通道数: {channels}");
+                    return;
+            }
 
-                    // 在UI线程上更新图像
-                    Dispatcher.BeginInvoke(new Action(() =>
-                    {
-                        imgDisplay.Source = bitmap;
-                    }));
-                }
-                finally
-                {
-                    handle.Free();
-                }
+            long imageSize = (long)width * height * channels;
+            if (width <= 0 || height <= 0 || frame.Length < imageSize)
+            {
+                Log($"无效的图像数据: 宽度={width}, 高度={height}, 数据大小={frame.Length}");
+                return;
             }
-            catch (Exception ex)
+
+            // The bitmap is reused until the frame format changes, no per-frame allocation
+            if (_bitmap == null || _bitmap.PixelWidth != width || _bitmap.PixelHeight != height || _bitmap.Format != format)
             {
-                Log($"处理图像帧时发生错误: {ex.Message}");
+                _bitmap = new WriteableBitmap(width, height, 96, 96, format, null);
+                imgDisplay.Source = _bitmap;
             }
+
+            // The only copy: from the shared memory slot into the bitmap's back buffer
+            _bitmap.WritePixels(new Int32Rect(0, 0, width, height), frame.Data, (int)imageSize, width * channels);
+            _framesShown++;
         }
 
-        private void ProcessPointCloudFrame(byte[] data, int pointCount, int pointSize)
+        private void ProcessPointCloudFrame(FrameView frame)
         {
             // TODO: 实现点云数据的处理和显示
-            // 这里可以添加点云数据的可视化逻辑
+            // 这里可以添加点云数据的可视化逻辑，frame.Span 直接指向共享内存中的点数据
         }
 
         private void btnTestConnection_Click(object sender, RoutedEventArgs e)
@@ -233,6 +221,7 @@ namespace ShareMemoryCS
         protected override void OnClosed(EventArgs e)
         {
             _statusTimer?.Stop();
+            CompositionTarget.Rendering -= CompositionTarget_Rendering;
             _sharedMemory?.Dispose();
             base.OnClosed(e);
         }
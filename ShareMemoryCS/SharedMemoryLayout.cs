@@ -0,0 +1,358 @@
+/**
+ * @file SharedMemoryLayout.cs
+ * @brief 共享内存布局契约（v4），与C++端 ShareMemoryManager.h 中的结构逐字节对应
+ * @author gyg
+ * @date 2026-10-14
+ */
+
+using System;
+using System.Runtime.InteropServices;
+
+namespace ShareMemoryCS
+{
+    /// <summary>
+    /// 帧槽状态，与C++端MemoryStatus对应
+    /// </summary>
+    public enum MemoryStatus : uint
+    {
+        Empty = 0,
+        Writing = 1,
+        Ready = 2,
+        Error = 3,
+        /// <summary>消费者正在读取</summary>
+        Reading = 4
+    }
+
+    /// <summary>
+    /// 帧数据类型，与C++端FrameType对应
+    /// </summary>
+    public enum FrameType : uint
+    {
+        /// <summary>图像数据</summary>
+        Image = 0,
+        /// <summary>点云数据</summary>
+        PointCloud = 1,
+        /// <summary>高度图数据</summary>
+        HeightMap = 2,
+        /// <summary>多帧捆绑，数据格式见C++端BundleHeader</summary>
+        Bundle = 3,
+        /// <summary>脏区域更新，数据格式见C++端DeltaHeader</summary>
+        Delta = 4,
+        /// <summary>压缩后的点云或高度图，数据格式见C++端CompressedHeader</summary>
+        Compressed = 5,
+        /// <summary>按字段描述布局的点云，数据格式见C++端PointCloudHeader</summary>
+        PointFields = 6
+    }
+
+    /// <summary>
+    /// 缓冲区布局模式，与C++端BufferMode对应
+    /// </summary>
+    public enum BufferMode : uint
+    {
+        SingleSlot = 0,
+        Ring = 1,
+        Broadcast = 2,
+        TripleBuffer = 3,
+        Pool = 4
+    }
+
+    /// <summary>
+    /// 校验算法，与C++端ChecksumMode对应
+    /// </summary>
+    public enum ChecksumMode : uint
+    {
+        None = 0,
+        Legacy = 1,
+        Crc32c = 2,
+        XxHash32 = 3
+    }
+
+    /// <summary>
+    /// 统一的数据信息结构，与C++端DataInfo对应（32字节）
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    public struct DataInfo
+    {
+        /// <summary>宽度（图像/高度图）或点数量（点云）</summary>
+        public uint Width;
+        /// <summary>高度（图像/高度图）或点维度（点云）</summary>
+        public uint Height;
+        /// <summary>通道数（图像）</summary>
+        public uint Channels;
+        /// <summary>X方向间距（高度图）</summary>
+        public float XSpacing;
+        /// <summary>Y方向间距（高度图）</summary>
+        public float YSpacing;
+        /// <summary>数据类型（FrameType枚举）</summary>
+        public uint DataType;
+        /// <summary>时间戳</summary>
+        public ulong Timestamp;
+    }
+
+    /// <summary>
+    /// 帧槽描述符，与C++端SlotDescriptor对应（一个缓存行）
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    public struct SlotDescriptor
+    {
+        /// <summary>槽状态（MemoryStatus），只能通过 Volatile/Interlocked 访问</summary>
+        public uint Status;
+        public uint Checksum;
+        public ulong DataSize;
+        public ulong FrameId;
+        public DataInfo Info;
+        /// <summary>发布时刻（steady_clock纳秒）</summary>
+        public ulong PublishTimeNs;
+    }
+
+    /// <summary>
+    /// 共享内存头部，与C++端SharedMemoryHeader对应（6个缓存行）
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    public unsafe struct SharedMemoryHeader
+    {
+        // 缓存行0：创建后只读的布局描述
+        public uint Magic;
+        public uint Version;
+        public uint ChecksumType;
+        public uint BufferMode;
+        public ulong SlotCapacity;
+        public uint SlotCount;
+        public uint HeaderSize;
+        public ulong DataOffset;
+        public ulong MappingSize;
+        public uint Codec;
+        public fixed byte Reserved0[12];
+
+        // 缓存行1：单槽模式的帧描述符
+        public SlotDescriptor Slot;
+
+        // 缓存行2：生产者的进程ID、等待帧槽的生产者数量和心跳
+        public uint ProducerPid;
+        /// <summary>正在等待帧槽释放的生产者数量，不为0时归还帧槽后触发 &lt;name&gt;_freed 事件</summary>
+        public uint WriteWaiters;
+        public ulong ProducerHeartbeatNs;
+        public fixed byte Reserved2[48];
+
+        // 缓存行3：消费者修改的字段
+        public uint Waiters;
+        public uint ConsumerPid;
+        public ulong ConsumerHeartbeatNs;
+        public uint KeyframeRequest;
+        public fixed byte Reserved3[44];
+
+        // 缓存行4-5：错误信息
+        public fixed byte ErrorMsg[128];
+    }
+
+    /// <summary>
+    /// 运行统计区，与C++端SharedMemoryStats对应，紧跟在头部之后
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    public unsafe struct SharedMemoryStats
+    {
+        // 生产者更新的计数器
+        public uint Magic;
+        public uint BucketCount;
+        public ulong FramesWritten;
+        public ulong BytesWritten;
+        public ulong WriteRejections;
+        public ulong MutexTimeouts;
+        public ulong FramesDropped;
+        public ulong AbandonedLocks;
+        public ulong SlotsReclaimed;
+
+        // 消费者更新的计数器
+        public ulong FramesRead;
+        public ulong BytesRead;
+        public ulong ChecksumFailures;
+        public ulong LatencySumNs;
+        // 生产者等待帧槽释放的计数
+        public ulong ThrottledWrites;
+        public ulong ThrottledNs;
+        public fixed byte Reserved1[16];
+        public fixed ulong LatencyHistogram[SharedMemoryLayout.LatencyBucketCount];
+    }
+
+    /// <summary>
+    /// 环形缓冲区控制块，与C++端RingControlBlock对应
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    public unsafe struct RingControlBlock
+    {
+        // 生产者修改的字段
+        public ulong BufferSize;
+        public uint MaxFrames;
+        public uint WriteIndex;
+        public ulong LastFrameId;
+        public uint FrameCount;
+        public fixed byte Reserved0[36];
+
+        // 消费者推进的字段；生产者按 OverwriteOldest 覆盖未读帧时也会推进，只能通过 Interlocked.CompareExchange 修改
+        public uint ReadIndex;
+        public fixed byte Reserved1[60];
+    }
+
+    /// <summary>
+    /// 三缓冲控制块，与C++端TripleBufferControlBlock对应
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    public unsafe struct TripleBufferControlBlock
+    {
+        // 生产者修改的字段
+        public ulong BufferSize;
+        public ulong LastFrameId;
+        public uint BackIndex;
+        public uint DroppedFrames;
+        public fixed byte Reserved0[40];
+
+        // 双方交换的字段
+        public uint Middle;
+        public fixed byte Reserved1[60];
+
+        // 消费者修改的字段
+        public uint FrontIndex;
+        public fixed byte Reserved2[60];
+    }
+
+    /// <summary>
+    /// 帧池的一个尺寸级别，与C++端PoolSizeClass对应（一个缓存行）
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    public unsafe struct PoolSizeClass
+    {
+        public ulong BlockSize;
+        /// <summary>空闲链表栈顶：高32位为修改计数，低32位为栈顶块的缓存行编号加1，只能通过 Interlocked 访问</summary>
+        public ulong FreeHead;
+        public uint FreeBlocks;
+        public uint TotalBlocks;
+        public fixed byte Reserved[40];
+    }
+
+    /// <summary>
+    /// 帧池控制块的第一个缓存行，与C++端PoolControlBlock对应
+    ///
+    /// Pool模式下紧跟在帧槽描述符之后，其后是 PoolMaxClasses 个 PoolSizeClass，
+    /// 再之后是每个帧槽持有的块句柄（ulong）。
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack = 1)]
+    public unsafe struct PoolControlBlock
+    {
+        public ulong ArenaSize;
+        public uint ClassCount;
+        public uint Reserved0;
+        public ulong ArenaTop;
+        public fixed byte Reserved1[40];
+    }
+
+    /// <summary>
+    /// 布局契约：魔数、版本、各区域大小和关键字段的偏移
+    ///
+    /// C++端在 ShareMemoryManager.h 中用 static_assert 固定同样的数值，任何一端改动布局都必须
+    /// 递增 HeaderVersion 并同步修改另一端；运行时 Verify 检查本端的结构定义，Initialize
+    /// 检查对端写入的魔数、版本和头部大小。
+    /// </summary>
+    public static unsafe class SharedMemoryLayout
+    {
+        public const uint HeaderMagic = 0x324D4853;        // 'SHM2'
+        public const uint LegacyHeaderMagic = 0x12345678;  // v1 布局
+        public const uint HeaderVersion = 4;
+
+        public const int CacheLineSize = 64;
+        public const int LatencyBucketCount = 32;
+        public const int HeaderSize = 384;
+        public const int StatsOffset = HeaderSize;
+        public const int StatsSize = 384;
+        public const int ControlOffset = StatsOffset + StatsSize;
+        public const int SlotDescriptorSize = 64;
+        public const int RingControlBlockSize = 128;
+        public const int TripleBufferControlBlockSize = 192;
+        public const int PoolMaxClasses = 64;
+        public const int PoolClassesOffset = 64;           // PoolControlBlock.Classes
+        public const int PoolControlBlockSize = PoolClassesOffset + CacheLineSize * PoolMaxClasses;
+        public const int PoolFreeHeadOffset = 8;           // PoolSizeClass.FreeHead
+
+        public const int SlotOffset = 64;                  // SharedMemoryHeader.Slot
+        public const int ProducerPidOffset = 128;          // SharedMemoryHeader.ProducerPid
+        public const int WaitersOffset = 192;              // SharedMemoryHeader.Waiters
+        public const int KeyframeRequestOffset = 208;      // SharedMemoryHeader.KeyframeRequest
+        public const int ErrorMsgOffset = 256;             // SharedMemoryHeader.ErrorMsg
+        public const int InfoOffset = 24;                  // SlotDescriptor.Info
+        public const int FramesReadOffset = 64;            // SharedMemoryStats.FramesRead
+        public const int ReadIndexOffset = 64;             // RingControlBlock.ReadIndex
+        public const int MiddleOffset = 64;                // TripleBufferControlBlock.Middle
+        public const int FrontIndexOffset = 128;           // TripleBufferControlBlock.FrontIndex
+
+        public const uint TripleBufferFresh = 0x4;
+        public const uint TripleBufferIndexMask = 0x3;
+
+        // A block handle is the block's pool offset with its size class in the low bits
+        public const ulong PoolClassMask = CacheLineSize - 1;
+        public const ulong PoolNoBlock = ulong.MaxValue;
+
+        /// <summary>
+        /// 检查本端的结构定义是否符合契约
+        /// </summary>
+        /// <param name="error">不符合时的描述</param>
+        public static bool Verify(out string error)
+        {
+            error = null;
+            if (sizeof(DataInfo) != 32)
+                error = "DataInfo must be 32 bytes";
+            else if (sizeof(SlotDescriptor) != SlotDescriptorSize || Offset<SlotDescriptor>("Info") != InfoOffset)
+                error = "SlotDescriptor does not match the v4 layout";
+            else if (sizeof(SharedMemoryHeader) != HeaderSize ||
+                     Offset<SharedMemoryHeader>("Slot") != SlotOffset ||
+                     Offset<SharedMemoryHeader>("ProducerPid") != ProducerPidOffset ||
+                     Offset<SharedMemoryHeader>("Waiters") != WaitersOffset ||
+                     Offset<SharedMemoryHeader>("KeyframeRequest") != KeyframeRequestOffset ||
+                     Offset<SharedMemoryHeader>("ErrorMsg") != ErrorMsgOffset)
+                error = "SharedMemoryHeader does not match the v4 layout";
+            else if (sizeof(SharedMemoryStats) != StatsSize || Offset<SharedMemoryStats>("FramesRead") != FramesReadOffset)
+                error = "SharedMemoryStats does not match the v4 layout";
+            else if (sizeof(RingControlBlock) != RingControlBlockSize || Offset<RingControlBlock>("ReadIndex") != ReadIndexOffset)
+                error = "RingControlBlock does not match the v4 layout";
+            else if (sizeof(TripleBufferControlBlock) != TripleBufferControlBlockSize ||
+                     Offset<TripleBufferControlBlock>("Middle") != MiddleOffset ||
+                     Offset<TripleBufferControlBlock>("FrontIndex") != FrontIndexOffset)
+                error = "TripleBufferControlBlock does not match the v4 layout";
+            else if (sizeof(PoolControlBlock) != PoolClassesOffset || sizeof(PoolSizeClass) != CacheLineSize ||
+                     Offset<PoolSizeClass>("FreeHead") != PoolFreeHeadOffset)
+                error = "PoolControlBlock does not match the v4 layout";
+            return error == null;
+        }
+
+        /// <summary>
+        /// 检查对端写入的头部，返回 null 表示可以附加
+        /// </summary>
+        public static string CheckPeer(SharedMemoryHeader* header)
+        {
+            if (header->Magic == 0)
+                return "Shared memory has not been initialized by a producer";
+            if (header->Magic == LegacyHeaderMagic)
+                return "Shared memory uses the legacy v1 layout, upgrade the producer";
+            if (header->Magic != HeaderMagic)
+                return $"Shared memory has an unknown header (magic 0x{header->Magic:X8})";
+            if (header->Version != HeaderVersion)
+                return $"Shared memory layout version {header->Version} does not match ours ({HeaderVersion})";
+            if (header->HeaderSize != HeaderSize)
+                return $"Shared memory header is {header->HeaderSize} bytes, expected {HeaderSize}";
+            return null;
+        }
+
+        /// <summary>
+        /// 帧槽之间的步长，多槽模式按缓存行对齐
+        /// </summary>
+        public static ulong SlotStride(BufferMode mode, ulong slotCapacity)
+        {
+            if (mode == BufferMode.SingleSlot)
+                return slotCapacity;
+            return (slotCapacity + CacheLineSize - 1) & ~(ulong)(CacheLineSize - 1);
+        }
+
+        private static int Offset<T>(string field)
+        {
+            return Marshal.OffsetOf(typeof(T), field).ToInt32();
+        }
+    }
+}
@@ -6,127 +6,122 @@
  */
 
 using System;
-using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
 using System.Runtime.InteropServices;
 using System.Threading;
-using System.IO;
-using System.Text;
-using System.Diagnostics;
 
 namespace ShareMemoryCS
 {
     /// <summary>
-    /// 帧数据类型枚举
+    /// 读写同步方式，必须与C++端 ShareMemoryConfig::syncMode 相同
     /// </summary>
-    public enum FrameType
+    public enum SyncMode
     {
-        /// <summary>图像数据</summary>
-        Image = 0,
-        /// <summary>点云数据</summary>
-        PointCloud = 1
+        /// <summary>取帧时获取命名互斥锁</summary>
+        Mutex = 0,
+        /// <summary>单生产者单消费者，仅通过原子状态位同步</summary>
+        LockFree = 1
     }
 
     /// <summary>
-    /// 帧头部信息结构，与C++端结构对应
+    /// 共享内存中一帧的零拷贝视图，直接指向映射的帧槽
+    ///
+    /// 持有视图期间生产者不会覆盖该帧槽；用完后必须调用 Release（或 Dispose）把帧槽交还生产者，
+    /// Release 之后 Pointer/Span 不再有效。视图对象由管理器按帧槽复用，取帧的路径上没有托管分配。
     /// </summary>
-    [StructLayout(LayoutKind.Sequential, Pack = 1)]
-    public struct FrameHeader
+    public sealed unsafe class FrameView : IDisposable
     {
+        private SharedMemoryManager _owner;
+
+        internal uint SlotIndex { get; private set; }
+
+        internal FrameView()
+        {
+        }
+
+        /// <summary>是否持有一帧</summary>
+        public bool IsValid => _owner != null;
+        /// <summary>帧数据在映射中的地址</summary>
+        public byte* Pointer { get; private set; }
+        /// <summary>帧数据地址，可直接传给 WriteableBitmap.WritePixels 等接受 IntPtr 的接口</summary>
+        public IntPtr Data => (IntPtr)Pointer;
+        /// <summary>帧数据大小（字节）</summary>
+        public long Length { get; private set; }
         /// <summary>帧ID</summary>
-        public ulong FrameId;
-        /// <summary>时间戳，毫秒</summary>
-        public ulong Timestamp;
-        /// <summary>帧类型</summary>
-        public uint FrameType;
-        /// <summary>数据大小（字节）</summary>
-        public uint DataSize;
-        
-        // 图像特有参数
-        /// <summary>图像宽度</summary>
-        public uint Width;
-        /// <summary>图像高度</summary>
-        public uint Height;
-        /// <summary>图像通道数</summary>
-        public uint Channels;
-        
-        // 点云特有参数
-        /// <summary>点云中点的数量</summary>
-        public uint PointCount;
-        /// <summary>每个点的字节大小</summary>
-        public uint PointSize;
-    }
+        public ulong FrameId { get; private set; }
+        /// <summary>数据信息</summary>
+        public DataInfo Info { get; private set; }
+        /// <summary>数据类型；压缩帧、捆绑帧和增量帧给出的是存储的原始字节</summary>
+        public FrameType DataType => (FrameType)Info.DataType;
 
-    /// <summary>
-    /// 控制块结构，存储环形缓冲区的元数据
-    /// </summary>
-    [StructLayout(LayoutKind.Sequential, Pack = 1)]
-    public struct ControlBlock
-    {
-        /// <summary>总缓冲区大小（字节）</summary>
-        public uint BufferSize;
-        /// <summary>最大可存储帧数</summary>
-        public uint MaxFrames;
-        /// <summary>写入位置索引</summary>
-        public uint WriteIndex;
-        /// <summary>读取位置索引</summary>
-        public uint ReadIndex;
-        /// <summary>当前缓冲区中的帧数量</summary>
-        public uint FrameCount;
-        /// <summary>最后写入的帧ID</summary>
-        public ulong LastFrameId;
-    }
+        /// <summary>
+        /// 帧数据的只读视图，不拷贝；帧超过2GB时抛出 OverflowException
+        /// </summary>
+        public ReadOnlySpan<byte> Span => new ReadOnlySpan<byte>(Pointer, checked((int)Length));
 
-    /// <summary>
-    /// 共享内存头部结构
-    /// </summary>
-    [StructLayout(LayoutKind.Sequential, Pack = 1)]
-    public struct SharedMemoryHeader
-    {
-        public uint Magic;          // Magic number for validation (0x12345678)
-        public uint Status;         // 0=Empty, 1=Writing, 2=Ready, 3=Error
-        public uint DataSize;       // Size of data in bytes
-        public uint Checksum;       // Simple checksum for data validation
-        public uint FrameId;        // Incremental frame ID
-        public uint DataType;       // 0=Image, 1=PointCloud
-        public uint Width;          // Image width or point count
-        public uint Height;         // Image height or point size
-        public uint Reserved;       // Reserved for future use
-        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 128)]
-        public byte[] ErrorMsg;     // Error message
-    }
+        /// <summary>
+        /// 需要在 Release 之后继续使用数据时拷贝到调用方的缓冲区
+        /// </summary>
+        public void CopyTo(byte[] destination, int offset = 0)
+        {
+            if (destination == null)
+                throw new ArgumentNullException(nameof(destination));
+            if (offset < 0 || destination.Length - offset < Length)
+                throw new ArgumentException("Destination is too small for the frame", nameof(destination));
+            fixed (byte* dst = destination)
+            {
+                Buffer.MemoryCopy(Pointer, dst + offset, destination.Length - offset, Length);
+            }
+        }
 
-    /// <summary>
-    /// 数据类型枚举
-    /// </summary>
-    public enum DataType
-    {
-        /// <summary>图像数据</summary>
-        Image = 0,
-        /// <summary>点云数据</summary>
-        PointCloud = 1
+        /// <summary>
+        /// 把帧槽交还生产者，重复调用无效果
+        /// </summary>
+        public void Release()
+        {
+            SharedMemoryManager owner = _owner;
+            if (owner == null)
+                return;
+            _owner = null;
+            Pointer = null;
+            Length = 0;
+            owner.ReleaseView(this);
+        }
+
+        public void Dispose()
+        {
+            Release();
+        }
+
+        internal void Attach(SharedMemoryManager owner, uint slotIndex, byte* data, SlotDescriptor* slot)
+        {
+            _owner = owner;
+            SlotIndex = slotIndex;
+            Pointer = data;
+            Length = (long)slot->DataSize;
+            FrameId = slot->FrameId;
+            Info = slot->Info;
+        }
     }
 
     /// <summary>
-    /// 数据接收事件参数类
+    /// 帧接收事件参数，Frame 只在事件处理期间有效，处理完成后由监听线程释放
     /// </summary>
-    public class DataReceivedEventArgs : EventArgs
+    public class FrameReceivedEventArgs : EventArgs
     {
-        /// <summary>帧ID</summary>
-        public uint FrameId { get; set; }
-        /// <summary>数据类型</summary>
-        public DataType DataType { get; set; }
-        /// <summary>接收到的数据</summary>
-        public byte[] Data { get; set; }
-        /// <summary>宽度（图像）或点数量（点云）</summary>
-        public uint Width { get; set; }
-        /// <summary>高度（图像）或点大小（点云）</summary>
-        public uint Height { get; set; }
+        /// <summary>接收到的帧</summary>
+        public FrameView Frame { get; internal set; }
     }
 
     /// <summary>
     /// 共享内存管理器类
+    ///
+    /// 按 SharedMemoryLayout 中的v4布局直接访问C++生产者创建的映射，支持单槽、Ring和三缓冲模式。
+    /// 取帧有两种方式，同一实例只能使用其中一种：StartMonitoring 后在 FrameReceived 事件中处理，
+    /// 或在自己的线程（例如WPF渲染回调）中调用 TryAcquireFrame。
     /// </summary>
-    public class SharedMemoryManager : IDisposable
+    public unsafe class SharedMemoryManager : IDisposable
     {
         #region Win32 API
 
@@ -134,7 +129,7 @@ namespace ShareMemoryCS
         static extern IntPtr OpenFileMapping(uint dwDesiredAccess, bool bInheritHandle, string lpName);
 
         [DllImport("kernel32.dll", SetLastError = true)]
-        static extern IntPtr MapViewOfFile(IntPtr hFileMappingObject, uint dwDesiredAccess, 
+        static extern IntPtr MapViewOfFile(IntPtr hFileMappingObject, uint dwDesiredAccess,
             uint dwFileOffsetHigh, uint dwFileOffsetLow, UIntPtr dwNumberOfBytesToMap);
 
         [DllImport("kernel32.dll", SetLastError = true)]
@@ -146,6 +141,12 @@ namespace ShareMemoryCS
         [DllImport("kernel32.dll", SetLastError = true)]
         static extern IntPtr OpenMutex(uint dwDesiredAccess, bool bInheritHandle, string lpName);
 
+        [DllImport("kernel32.dll", SetLastError = true)]
+        static extern IntPtr OpenEvent(uint dwDesiredAccess, bool bInheritHandle, string lpName);
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        static extern bool SetEvent(IntPtr hEvent);
+
         [DllImport("kernel32.dll", SetLastError = true)]
         static extern uint WaitForSingleObject(IntPtr hHandle, uint dwMilliseconds);
 
@@ -154,21 +155,55 @@ namespace ShareMemoryCS
 
         private const uint FILE_MAP_ALL_ACCESS = 0xF001F;
         private const uint MUTEX_ALL_ACCESS = 0x1F0001;
+        private const uint SYNCHRONIZE = 0x00100000;
+        private const uint EVENT_MODIFY_STATE = 0x0002;
         private const uint WAIT_OBJECT_0 = 0;
-        private const uint MAGIC_NUMBER = 0x12345678;
+        private const uint WAIT_ABANDONED_0 = 0x80;
 
         #endregion
 
         /// <summary>
-        /// 数据接收事件
+        /// 帧接收事件，在监听线程上触发
         /// </summary>
-        public event EventHandler<DataReceivedEventArgs> DataReceived;
-
-        private string _name;
-        private int _size;
+        public event EventHandler<FrameReceivedEventArgs> FrameReceived;
+
+        /// <summary>监听线程等待新帧事件的超时（毫秒）</summary>
+        public uint WaitTimeoutMs { get; set; } = 50;
+        /// <summary>等待命名互斥锁的超时（毫秒）</summary>
+        public uint LockTimeoutMs { get; set; } = 5000;
+        /// <summary>是否按生产者记录的算法校验帧数据</summary>
+        public bool VerifyChecksum { get; set; } = true;
+
+        /// <summary>生产者创建的缓冲区布局模式，Initialize 之后有效</summary>
+        public BufferMode Mode => _mode;
+        /// <summary>是否已附加到共享内存</summary>
+        public bool IsInitialized => _header != null;
+
+        private readonly string _name;
+        private readonly SyncMode _syncMode;
+        private readonly uint _processId;
         private IntPtr _hMapFile = IntPtr.Zero;
         private IntPtr _pBuffer = IntPtr.Zero;
         private IntPtr _hMutex = IntPtr.Zero;
+        private IntPtr _hEvent = IntPtr.Zero;
+        private IntPtr _hFreedEvent = IntPtr.Zero;
+
+        private SharedMemoryHeader* _header;
+        private SharedMemoryStats* _stats;
+        private RingControlBlock* _ring;
+        private TripleBufferControlBlock* _triple;
+        private PoolSizeClass* _poolClasses;
+        private ulong* _poolBlocks;
+        private SlotDescriptor* _slots;
+        private byte* _data;
+        private ulong _slotStride;
+        private uint _slotCount;
+        private BufferMode _mode;
+        private ChecksumMode _checksumMode;
+        private FrameView[] _views;
+        private bool _frontHeld;
+
+        private readonly FrameReceivedEventArgs _eventArgs = new FrameReceivedEventArgs();
         private Thread _monitorThread;
         private volatile bool _isRunning;
         private readonly StreamWriter _logWriter;
@@ -177,31 +212,45 @@ namespace ShareMemoryCS
         /// 构造函数
         /// </summary>
         /// <param name="name">共享内存名称</param>
-        /// <param name="size">共享内存大小</param>
-        public SharedMemoryManager(string name, int size)
+        /// <param name="syncMode">同步方式，与生产者的配置相同</param>
+        public SharedMemoryManager(string name, SyncMode syncMode = SyncMode.Mutex)
         {
             _name = name;
-            _size = size + Marshal.SizeOf<SharedMemoryHeader>();
+            _syncMode = syncMode;
+            _processId = (uint)Process.GetCurrentProcess().Id;
             _logWriter = new StreamWriter("consumer_log.txt", true) { AutoFlush = true };
             Log("SharedMemoryManager constructed");
         }
 
         /// <summary>
-        /// 初始化共享内存
+        /// 打开生产者创建的共享内存并校验布局
         /// </summary>
         /// <returns>是否成功初始化</returns>
         public bool Initialize()
         {
             Log("Initializing shared memory");
 
+            if (!SharedMemoryLayout.Verify(out string layoutError))
+            {
+                Log($"Layout contract violated: {layoutError}");
+                return false;
+            }
+
             // Open mutex
             _hMutex = OpenMutex(MUTEX_ALL_ACCESS, false, _name + "_mutex");
-            if (_hMutex == IntPtr.Zero)
+            if (_hMutex == IntPtr.Zero && _syncMode == SyncMode.Mutex)
             {
                 Log($"Failed to open mutex: {Marshal.GetLastWin32Error()}");
                 return false;
             }
 
+            // Without the event the monitor thread falls back to polling
+            _hEvent = OpenEvent(SYNCHRONIZE, false, _name + "_event");
+            if (_hEvent == IntPtr.Zero)
+            {
+                Log($"Failed to open frame event, polling instead: {Marshal.GetLastWin32Error()}");
+            }
+
             // Open shared memory
             _hMapFile = OpenFileMapping(FILE_MAP_ALL_ACCESS, false, _name);
             if (_hMapFile == IntPtr.Zero)
@@ -210,15 +259,76 @@ namespace ShareMemoryCS
                 return false;
             }
 
-            // Map memory view
-            _pBuffer = MapViewOfFile(_hMapFile, FILE_MAP_ALL_ACCESS, 0, 0, (UIntPtr)_size);
+            // Map the whole section, its size is recorded in the header
+            _pBuffer = MapViewOfFile(_hMapFile, FILE_MAP_ALL_ACCESS, 0, 0, UIntPtr.Zero);
             if (_pBuffer == IntPtr.Zero)
             {
                 Log($"Failed to map view of file: {Marshal.GetLastWin32Error()}");
                 return false;
             }
 
-            // Start monitor thread
+            byte* basePtr = (byte*)_pBuffer;
+            var header = (SharedMemoryHeader*)basePtr;
+            string peerError = SharedMemoryLayout.CheckPeer(header);
+            if (peerError != null)
+            {
+                Log(peerError);
+                return false;
+            }
+
+            _mode = (BufferMode)header->BufferMode;
+            _checksumMode = (ChecksumMode)header->ChecksumType;
+            _slotStride = SharedMemoryLayout.SlotStride(_mode, header->SlotCapacity);
+            _stats = (SharedMemoryStats*)(basePtr + SharedMemoryLayout.StatsOffset);
+            switch (_mode)
+            {
+                case BufferMode.SingleSlot:
+                    _slots = &header->Slot;
+                    _slotCount = 1;
+                    break;
+                case BufferMode.Ring:
+                case BufferMode.Pool:
+                    _ring = (RingControlBlock*)(basePtr + SharedMemoryLayout.ControlOffset);
+                    _slots = (SlotDescriptor*)(_ring + 1);
+                    _slotCount = _ring->MaxFrames;
+                    if (_mode == BufferMode.Pool)
+                    {
+                        // Frames live in pool blocks, each slot records the handle of its block
+                        byte* pool = (byte*)(_slots + _slotCount);
+                        _poolClasses = (PoolSizeClass*)(pool + SharedMemoryLayout.PoolClassesOffset);
+                        _poolBlocks = (ulong*)(pool + SharedMemoryLayout.PoolControlBlockSize);
+                    }
+                    break;
+                case BufferMode.TripleBuffer:
+                    _triple = (TripleBufferControlBlock*)(basePtr + SharedMemoryLayout.ControlOffset);
+                    _slots = (SlotDescriptor*)(_triple + 1);
+                    _slotCount = 3;
+                    break;
+                default:
+                    Log($"Buffer mode {_mode} is not supported by the C# consumer");
+                    return false;
+            }
+            _data = basePtr + header->DataOffset;
+            _views = new FrameView[_slotCount];
+            for (int i = 0; i < _views.Length; i++)
+            {
+                _views[i] = new FrameView();
+            }
+            _header = header;
+
+            Log($"Shared memory initialized successfully - Mode: {_mode}, Slots: {_slotCount}, " +
+                $"Slot size: {header->SlotCapacity} bytes, Checksum: {_checksumMode}");
+            return true;
+        }
+
+        /// <summary>
+        /// 启动监听线程，每收到一帧触发一次 FrameReceived
+        /// </summary>
+        public void StartMonitoring()
+        {
+            if (_header == null || _isRunning)
+                return;
+
             _isRunning = true;
             _monitorThread = new Thread(MonitorThreadProc)
             {
@@ -226,41 +336,45 @@ namespace ShareMemoryCS
                 Name = "SharedMemoryMonitor"
             };
             _monitorThread.Start();
+        }
 
-            Log("Shared memory initialized successfully");
-            return true;
+        /// <summary>
+        /// 停止监听线程
+        /// </summary>
+        public void StopMonitoring()
+        {
+            _isRunning = false;
+            if (_monitorThread != null && _monitorThread.IsAlive)
+            {
+                _monitorThread.Join(1000);
+            }
+            _monitorThread = null;
         }
 
         private void MonitorThreadProc()
         {
             Log("Monitor thread started");
-            
+
             while (_isRunning)
             {
                 try
                 {
-                    // Log memory status periodically for debugging
-                    if (_pBuffer != IntPtr.Zero)
-                    {
-                        var header = Marshal.PtrToStructure<SharedMemoryHeader>(_pBuffer);
-                        Log($"Memory status check - Magic: {header.Magic:X8}, Status: {header.Status}, FrameId: {header.FrameId}");
-                    }
+                    WaitForFrame(WaitTimeoutMs);
 
-                    if (TryReadData(out byte[] data, out uint frameId))
+                    // Drain every ready frame before blocking again
+                    while (_isRunning && TryAcquireFrame(out FrameView frame))
                     {
-                        var header = Marshal.PtrToStructure<SharedMemoryHeader>(_pBuffer);
-                        OnDataReceived(new DataReceivedEventArgs
+                        try
+                        {
+                            _eventArgs.Frame = frame;
+                            OnFrameReceived(_eventArgs);
+                        }
+                        finally
                         {
-                            FrameId = frameId,
-                            DataType = (DataType)header.DataType,
-                            Data = data,
-                            Width = header.Width,
-                            Height = header.Height
-                        });
+                            _eventArgs.Frame = null;
+                            frame.Release();
+                        }
                     }
-
-                    // Sleep for a short time to prevent CPU overuse
-                    Thread.Sleep(10);
                 }
                 catch (Exception ex)
                 {
@@ -268,98 +382,341 @@ namespace ShareMemoryCS
                     Thread.Sleep(100); // Longer sleep on error
                 }
             }
-            
+
             Log("Monitor thread stopped");
         }
 
-        private bool TryReadData(out byte[] data, out uint frameId)
+        /// <summary>
+        /// 等待生产者发布新帧
+        /// </summary>
+        /// <returns>是否有待读取的帧</returns>
+        public bool WaitForFrame(uint timeoutMs)
         {
-            data = null;
-            frameId = 0;
+            if (_header == null)
+                return false;
 
-            uint waitResult = WaitForSingleObject(_hMutex, 1000);
-            if (waitResult != WAIT_OBJECT_0)
+            Heartbeat();
+            if (HasPendingFrame())
+                return true;
+            if (_hEvent == IntPtr.Zero)
             {
-                Log($"Failed to acquire mutex: {waitResult}");
-                return false;
+                Thread.Sleep((int)Math.Min(timeoutMs, 10u));
+                return HasPendingFrame();
             }
 
+            // The producer only signals while Waiters is non-zero; Interlocked is a full fence,
+            // so either it sees our increment or we see its Ready status
+            Interlocked.Increment(ref *(int*)&_header->Waiters);
             try
             {
-                var header = Marshal.PtrToStructure<SharedMemoryHeader>(_pBuffer);
-
-                // Validate header
-                if (header.Magic != MAGIC_NUMBER)
+                if (!HasPendingFrame())
                 {
-                    Log($"Invalid magic number in header: {header.Magic:X8}, expected: {MAGIC_NUMBER:X8}");
-                    return false;
+                    WaitForSingleObject(_hEvent, timeoutMs);
                 }
+            }
+            finally
+            {
+                Interlocked.Decrement(ref *(int*)&_header->Waiters);
+            }
+            return HasPendingFrame();
+        }
+
+        /// <summary>
+        /// 是否有待读取的帧，不获取锁
+        /// </summary>
+        public bool HasPendingFrame()
+        {
+            if (_header == null)
+                return false;
+            if (_triple != null)
+                return (Volatile.Read(ref _triple->Middle) & SharedMemoryLayout.TripleBufferFresh) != 0;
+
+            uint slotIndex = _ring != null ? Volatile.Read(ref _ring->ReadIndex) : 0;
+            return Volatile.Read(ref _slots[slotIndex].Status) == (uint)MemoryStatus.Ready;
+        }
+
+        /// <summary>
+        /// 取得下一帧的零拷贝视图，不等待
+        ///
+        /// 成功时帧槽保持 Reading 状态直到调用 frame.Release()；三缓冲模式下释放之前不能取下一帧，
+        /// Ring和Pool模式下可以同时持有多个帧槽。
+        /// </summary>
+        /// <param name="frame">成功时指向帧槽中的数据</param>
+        /// <returns>没有新帧、锁超时或校验失败时返回 false</returns>
+        public bool TryAcquireFrame(out FrameView frame)
+        {
+            frame = null;
+            if (_header == null)
+                return false;
 
-                // Log current status for debugging
-                Log($"Current memory status: {header.Status}, DataSize: {header.DataSize}, FrameId: {header.FrameId}");
+            Heartbeat();
+            if (_triple != null)
+                return AcquireLatestFrame(out frame);
 
-                // Check if data is ready
-                if (header.Status != 2) // Ready
+            if (!LockHeader())
+                return false;
+            try
+            {
+                uint slotIndex = _ring != null ? Volatile.Read(ref _ring->ReadIndex) : 0;
+                SlotDescriptor* slot = &_slots[slotIndex];
+
+                // Claim the frame: Ready -> Reading
+                if (Interlocked.CompareExchange(ref *(int*)&slot->Status, (int)MemoryStatus.Reading,
+                        (int)MemoryStatus.Ready) != (int)MemoryStatus.Ready)
                 {
-                    // Only log when status changes to avoid spam
-                    if (header.Status != 0) // Don't log Empty status
-                    {
-                        Log($"Data not ready, current status: {header.Status}");
-                    }
+                    return false;
+                }
+                if (_ring != null && Volatile.Read(ref _ring->ReadIndex) != slotIndex)
+                {
+                    // The index we loaded was stale: an overwriting producer moved it on and refilled this slot
+                    // with its newest frame, taking it now would deliver frames out of order
+                    Volatile.Write(ref slot->Status, (uint)MemoryStatus.Ready);
                     return false;
                 }
 
-                // Read data
-                data = new byte[header.DataSize];
-                Marshal.Copy(IntPtr.Add(_pBuffer, Marshal.SizeOf<SharedMemoryHeader>()), 
-                    data, 0, (int)header.DataSize);
-
-                // Validate checksum
-                uint checksum = CalculateChecksum(data);
-                if (checksum != header.Checksum)
+                byte* data = GetSlotData(slotIndex);
+                if (!VerifySlot(slot, data))
                 {
-                    Log($"Checksum mismatch. Expected: {header.Checksum}, Got: {checksum}");
+                    // Putting it back to Ready would keep the read index on the bad frame forever
+                    Interlocked.Increment(ref *(long*)&_stats->FramesDropped);
+                    ConsumeSlot(slotIndex);
+                    ReleaseSlot(slotIndex);
                     return false;
                 }
 
-                frameId = header.FrameId;
+                ConsumeSlot(slotIndex);
+                frame = _views[slotIndex];
+                frame.Attach(this, slotIndex, data, slot);
+                RecordRead(slot);
+                return true;
+            }
+            finally
+            {
+                UnlockHeader();
+            }
+        }
+
+        /// <summary>
+        /// 请求生产者的 WriteDelta 下一帧发送完整帧，本端不应用增量帧时使用
+        /// </summary>
+        public void RequestKeyframe()
+        {
+            if (_header != null)
+            {
+                Volatile.Write(ref _header->KeyframeRequest, 1u);
+            }
+        }
+
+        private bool AcquireLatestFrame(out FrameView frame)
+        {
+            frame = null;
+
+            // Swapping would hand the viewed buffer back to the writer
+            if (_frontHeld)
+                return false;
+            if ((Volatile.Read(ref _triple->Middle) & SharedMemoryLayout.TripleBufferFresh) == 0)
+                return false;
+
+            // Hand our front buffer back as the middle one and take the newest frame
+            uint previous = (uint)Interlocked.Exchange(ref *(int*)&_triple->Middle, (int)_triple->FrontIndex);
+            uint slotIndex = previous & SharedMemoryLayout.TripleBufferIndexMask;
+            _triple->FrontIndex = slotIndex;
+
+            SlotDescriptor* slot = &_slots[slotIndex];
+            byte* data = GetSlotData(slotIndex);
+            if (!VerifySlot(slot, data))
+                return false;
+
+            // The front buffer is ours until the next swap
+            _frontHeld = true;
+            frame = _views[slotIndex];
+            frame.Attach(this, slotIndex, data, slot);
+            RecordRead(slot);
+            return true;
+        }
+
+        internal void ReleaseView(FrameView frame)
+        {
+            if (_triple != null)
+            {
+                _frontHeld = false;
+                return;
+            }
+            ReleaseSlot(frame.SlotIndex);
+        }
+
+        private void ConsumeSlot(uint slotIndex)
+        {
+            if (_ring != null)
+            {
+                // A producer overwriting under OverwriteOldest may have moved the index past us already
+                Interlocked.CompareExchange(ref *(int*)&_ring->ReadIndex, (int)((slotIndex + 1) % _slotCount),
+                    (int)slotIndex);
+            }
+        }
+
+        private void ReleaseSlot(uint slotIndex)
+        {
+            if (_poolBlocks != null)
+            {
+                // The block goes back before the slot, a producer claiming it allocates a fresh one
+                FreeSlotBlock(slotIndex);
+            }
+            Volatile.Write(ref _slots[slotIndex].Status, (uint)MemoryStatus.Empty);
+            if (_ring != null)
+            {
+                Interlocked.Decrement(ref *(int*)&_ring->FrameCount);
+            }
+            NotifyProducer();
+        }
+
+        /// <summary>
+        /// 生产者按 Wait 策略等待帧槽时，触发 &lt;name&gt;_freed 事件唤醒它
+        /// </summary>
+        private void NotifyProducer()
+        {
+            // Pairs with the WriteWaiters increment on the producer side, same handshake as Waiters
+            Interlocked.MemoryBarrier();
+            if (Volatile.Read(ref _header->WriteWaiters) == 0)
+                return;
+            if (_hFreedEvent == IntPtr.Zero)
+            {
+                // The waiting producer has created the event, open it on first use
+                _hFreedEvent = OpenEvent(EVENT_MODIFY_STATE | SYNCHRONIZE, false, _name + "_freed");
+                if (_hFreedEvent == IntPtr.Zero)
+                    return;
+            }
+            SetEvent(_hFreedEvent);
+        }
+
+        /// <summary>
+        /// 把帧槽持有的块压回所属尺寸级别的空闲链表，与C++端 FreeSlotBlock 相同
+        /// </summary>
+        private void FreeSlotBlock(uint slotIndex)
+        {
+            // Whoever takes the handle out returns the block, so it is never freed twice
+            ulong handle = (ulong)Interlocked.Exchange(ref *(long*)&_poolBlocks[slotIndex], -1L);
+            if (handle == SharedMemoryLayout.PoolNoBlock)
+                return;
+
+            ulong offset = handle & ~SharedMemoryLayout.PoolClassMask;
+            PoolSizeClass* sizeClass = &_poolClasses[handle & SharedMemoryLayout.PoolClassMask];
+            uint* link = (uint*)(_data + offset);
+            ulong self = offset / SharedMemoryLayout.CacheLineSize + 1;
+
+            // The change counter in the upper half keeps a stale head from being swapped back in
+            long head = Volatile.Read(ref *(long*)&sizeClass->FreeHead);
+            for (;;)
+            {
+                Volatile.Write(ref *link, (uint)head);
+                long desired = (long)(((((ulong)head >> 32) + 1) << 32) | self);
+                long observed = Interlocked.CompareExchange(ref *(long*)&sizeClass->FreeHead, desired, head);
+                if (observed == head)
+                    break;
+                head = observed;
+            }
+            Interlocked.Increment(ref *(int*)&sizeClass->FreeBlocks);
+        }
+
+        private byte* GetSlotData(uint slotIndex)
+        {
+            if (_poolBlocks != null)
+                return _data + (Volatile.Read(ref _poolBlocks[slotIndex]) & ~SharedMemoryLayout.PoolClassMask);
+            return _data + slotIndex * _slotStride;
+        }
+
+        private bool VerifySlot(SlotDescriptor* slot, byte* data)
+        {
+            if (!VerifyChecksum || _checksumMode == ChecksumMode.None)
+                return true;
+            if (FrameChecksum.Compute(_checksumMode, data, slot->DataSize) == slot->Checksum)
+                return true;
 
-                string dataTypeStr = header.DataType == 0 ? "Image" : "PointCloud";
-                Log($"Successfully read {dataTypeStr} data - Size: {data.Length} bytes, Frame ID: {frameId}, " +
-                    $"Width: {header.Width}, Height: {header.Height}");
+            Interlocked.Increment(ref *(long*)&_stats->ChecksumFailures);
+            Log($"Checksum mismatch, Frame ID: {slot->FrameId}");
+            return false;
+        }
 
-                // Mark memory as empty
-                header.Status = 0; // Empty
-                Marshal.StructureToPtr(header, _pBuffer, false);
+        private bool LockHeader()
+        {
+            if (_syncMode == SyncMode.LockFree)
+                return true;
 
+            uint waitResult = WaitForSingleObject(_hMutex, LockTimeoutMs);
+            if (waitResult == WAIT_ABANDONED_0)
+            {
+                // We own the mutex now; stuck slots are reclaimed by the C++ peers
+                Interlocked.Increment(ref *(long*)&_stats->AbandonedLocks);
+                Log("Previous mutex owner terminated");
                 return true;
             }
-            catch (Exception ex)
+            if (waitResult != WAIT_OBJECT_0)
             {
-                Log($"Error reading data: {ex.Message}");
+                Interlocked.Increment(ref *(long*)&_stats->MutexTimeouts);
+                Log($"Failed to acquire mutex: {waitResult}");
                 return false;
             }
-            finally
+            return true;
+        }
+
+        private void UnlockHeader()
+        {
+            if (_syncMode == SyncMode.Mutex)
             {
                 ReleaseMutex(_hMutex);
             }
         }
 
-        private uint CalculateChecksum(byte[] data)
+        private void Heartbeat()
+        {
+            // A live heartbeat keeps the producer from reclaiming slots we still read
+            if (Volatile.Read(ref _header->ConsumerPid) != _processId)
+            {
+                Volatile.Write(ref _header->ConsumerPid, _processId);
+            }
+            Volatile.Write(ref _header->ConsumerHeartbeatNs, NowNs());
+        }
+
+        private void RecordRead(SlotDescriptor* slot)
         {
-            uint checksum = 0;
-            for (int i = 0; i < data.Length; i++)
+            Interlocked.Increment(ref *(long*)&_stats->FramesRead);
+            Interlocked.Add(ref *(long*)&_stats->BytesRead, (long)slot->DataSize);
+
+            ulong published = slot->PublishTimeNs;
+            ulong now = NowNs();
+            if (published != 0 && now >= published)
             {
-                checksum = ((checksum << 5) + checksum) + data[i];
+                ulong latency = now - published;
+                Interlocked.Add(ref *(long*)&_stats->LatencySumNs, (long)latency);
+                Interlocked.Increment(ref *(long*)&_stats->LatencyHistogram[LatencyBucket(latency)]);
             }
-            return checksum;
         }
 
-        protected virtual void OnDataReceived(DataReceivedEventArgs args)
+        private static int LatencyBucket(ulong latencyNs)
+        {
+            ulong micros = latencyNs / 1000;
+            int bucket = 0;
+            while (micros != 0 && bucket < SharedMemoryLayout.LatencyBucketCount - 1)
+            {
+                micros >>= 1;
+                bucket++;
+            }
+            return bucket;
+        }
+
+        private static ulong NowNs()
+        {
+            // Same clock as std::chrono::steady_clock on Windows (QueryPerformanceCounter)
+            long ticks = Stopwatch.GetTimestamp();
+            long frequency = Stopwatch.Frequency;
+            return (ulong)(ticks / frequency * 1000000000L + ticks % frequency * 1000000000L / frequency);
+        }
+
+        protected virtual void OnFrameReceived(FrameReceivedEventArgs args)
         {
             try
             {
-                DataReceived?.Invoke(this, args);
+                FrameReceived?.Invoke(this, args);
             }
             catch (Exception ex)
             {
@@ -370,13 +727,9 @@ namespace ShareMemoryCS
         public void Dispose()
         {
             Log("SharedMemoryManager disposing...");
-            
-            _isRunning = false;
-            
-            if (_monitorThread != null && _monitorThread.IsAlive)
-            {
-                _monitorThread.Join(1000);
-            }
+
+            StopMonitoring();
+            _header = null;
 
             if (_pBuffer != IntPtr.Zero)
             {
@@ -390,6 +743,18 @@ namespace ShareMemoryCS
                 _hMapFile = IntPtr.Zero;
             }
 
+            if (_hEvent != IntPtr.Zero)
+            {
+                CloseHandle(_hEvent);
+                _hEvent = IntPtr.Zero;
+            }
+
+            if (_hFreedEvent != IntPtr.Zero)
+            {
+                CloseHandle(_hFreedEvent);
+                _hFreedEvent = IntPtr.Zero;
+            }
+
             if (_hMutex != IntPtr.Zero)
             {
                 CloseHandle(_hMutex);
@@ -419,4 +784,4 @@ namespace ShareMemoryCS
             _logWriter.WriteLine(logEntry);
         }
     }
-} 
\ No newline at end of file
+}